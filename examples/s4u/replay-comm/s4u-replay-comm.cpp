@@ -99,16 +99,13 @@ int main(int argc, char* argv[])
   xbt_replay_action_register("send", Replayer::send);
   xbt_replay_action_register("recv", Replayer::recv);
 
-  if (argv[3]) {
-    simgrid::xbt::action_fs = new std::ifstream(argv[3], std::ifstream::in);
-  }
+  if (argv[3])
+    xbt_replay_set_tracefile(argv[3]);
 
   e.run();
 
-  if (argv[3]) {
-    delete simgrid::xbt::action_fs;
-    simgrid::xbt::action_fs = nullptr;
-  }
+  if (argv[3])
+    xbt_replay_set_tracefile("");
 
   XBT_INFO("Simulation time %g", e.get_clock());
 
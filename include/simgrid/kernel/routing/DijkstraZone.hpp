@@ -21,6 +21,11 @@ namespace routing {
  *
  *  This result in rather small platform file, very fast initialization, and very low memory requirements, but somehow
  * long path resolution times.
+ *
+ *  When sealing the zone, the routes are compiled into a compressed sparse row graph: the routes leaving each node
+ *  are stored contiguously (along with their target and cost), so that the Dijkstra loop only walks dense arrays. In
+ *  cache mode, the paths from all sources can also be computed at once at seal time, in parallel (see the
+ *  network/dijkstra-precompute option).
  */
 class XBT_PRIVATE DijkstraZone : public RoutedZone {
 public:
@@ -31,9 +36,12 @@ public:
   ~DijkstraZone() override;
 
 private:
-  xbt_node_t route_graph_new_node(int id);
-  xbt_node_t node_map_search(int id);
+  int node_map_search(int id);
+  int route_graph_new_node(int id);
   void new_edge(int src_id, int dst_id, RouteCreationArgs* e_route);
+  int get_edge(int src_node, int dst_node);
+  void build_graph();
+  void compute_predecessors(int src_node, std::vector<int>& pred_arr);
 
 public:
   /* For each vertex (node) already in the graph,
@@ -52,10 +60,24 @@ public:
   void add_route(NetPoint* src, NetPoint* dst, NetPoint* gw_src, NetPoint* gw_dst,
                  std::vector<resource::LinkImpl*>& link_list, bool symmetrical) override;
 
-  xbt_graph_t route_graph_ = nullptr;          /* xbt_graph */
-  std::map<int, xbt_node_t> graph_node_map_;   /* map */
-  bool cached_;                                /* cache mode */
-  std::map<int, std::vector<int>> route_cache_; /* use in cache mode */
+  std::vector<int> graph_node_map_; /* vertex id -> graph node (or -1), graph nodes being numbered in creation order */
+  int nodes_num_ = 0;
+
+  /* Edges in creation order */
+  std::vector<int> edge_src_;
+  std::vector<int> edge_dst_;
+  std::vector<RouteCreationArgs*> edge_route_;
+  std::map<std::pair<int, int>, int> edge_map_; /* (src node, dst node) -> edge */
+
+  /* Compressed sparse row graph: the edges leaving node n are out_*_[out_begin_[n] .. out_begin_[n+1]) */
+  std::vector<int> out_begin_;
+  std::vector<int> out_edge_;
+  std::vector<int> out_target_;
+  std::vector<double> out_cost_;
+  size_t compiled_edges_num_ = 0; /* amount of edges in the compressed graph, to rebuild it if new routes appear */
+
+  bool cached_;                               /* cache mode */
+  std::vector<std::vector<int>> route_cache_; /* per source node: edge leading to each node on its shortest path */
 };
 } // namespace routing
 } // namespace kernel
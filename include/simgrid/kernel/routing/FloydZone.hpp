@@ -20,13 +20,15 @@ namespace routing {
  *
  *  This result in rather small platform file, slow initialization time,  and intermediate memory requirements
  *  (somewhere between the one of @{DijkstraZone} and the one of @{FullZone}).
+ *
+ *  Only the predecessor table is kept after the initialization: the cost table is released once the paths are
+ *  computed, and the one-hop routes are stored sparsely.
  */
 class XBT_PRIVATE FloydZone : public RoutedZone {
 public:
   explicit FloydZone(NetZoneImpl* father, const std::string& name, resource::NetworkModel* netmodel);
   FloydZone(const FloydZone&) = delete;
   FloydZone& operator=(const FloydZone&) = delete;
-  ~FloydZone() override;
 
   void get_local_route(NetPoint* src, NetPoint* dst, RouteCreationArgs* into, double* latency) override;
   void add_route(NetPoint* src, NetPoint* dst, NetPoint* gw_src, NetPoint* gw_dst,
@@ -34,10 +36,13 @@ public:
   void seal() override;
 
 private:
-  /* vars to compute the Floyd algorithm. */
-  int* predecessor_table_;
-  double* cost_table_;
-  RouteCreationArgs** link_table_;
+  RouteCreationArgs* get_link(unsigned int src, unsigned int dst) const;
+  void set_link(unsigned int src, unsigned int dst, RouteCreationArgs* route);
+
+  /* vars to compute the Floyd algorithm (row-major tables, indexed by src * table_size + dst) */
+  std::vector<int> predecessor_table_;
+  /* The one-hop routes, indexed by (src_id << 32 | dst_id). The routes themselves are shared and owned by RoutedZone */
+  std::unordered_map<unsigned long long, RouteCreationArgs*> link_table_;
 };
 } // namespace routing
 } // namespace kernel
@@ -17,13 +17,16 @@ namespace routing {
  *
  *  The full communication matrix is provided at creation, so this model has the highest expressive power and the lowest
  *  computational requirements, but also the highest memory requirements (both in platform file and in memory).
+ *
+ *  Only the declared routes are stored (indexed by their source and destination), and identical link lists are shared
+ *  between the pairs of points using them. When sealing a zone where most pairs of points have a route, the routes are
+ *  moved to a dense matrix, which then takes less memory than the index.
  */
 class XBT_PRIVATE FullZone : public RoutedZone {
 public:
   explicit FullZone(NetZoneImpl* father, const std::string& name, resource::NetworkModel* netmodel);
   FullZone(const FullZone&) = delete;
   FullZone& operator=(const FullZone) = delete;
-  ~FullZone() override;
 
   void seal() override;
   void get_local_route(NetPoint* src, NetPoint* dst, RouteCreationArgs* into, double* latency) override;
@@ -31,7 +34,12 @@ public:
                  std::vector<resource::LinkImpl*>& link_list, bool symmetrical) override;
 
 private:
-  RouteCreationArgs** routing_table_ = nullptr;
+  RouteCreationArgs* get_route(unsigned int src, unsigned int dst) const;
+  /* The declared routes, indexed by (src_id << 32 | dst_id). The routes themselves are shared and owned by RoutedZone */
+  std::unordered_map<unsigned long long, RouteCreationArgs*> routing_table_;
+  /* The routes of a dense zone once sealed (indexed by src_id * dense_size_ + dst_id), or empty */
+  std::vector<RouteCreationArgs*> dense_table_;
+  unsigned int dense_size_ = 0;
 };
 } // namespace routing
 } // namespace kernel
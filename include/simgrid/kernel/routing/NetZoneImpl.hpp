@@ -132,6 +132,13 @@ public:
   static void get_global_route(routing::NetPoint* src, routing::NetPoint* dst,
                                /* OUT */ std::vector<resource::LinkImpl*>& links, double* latency);
 
+  /** @brief Forget about all the routes computed so far (to be called when the platform or a latency changes) */
+  static void clear_route_cache();
+  /** @brief Amount of get_global_route() calls answered from the route cache */
+  static unsigned long get_route_cache_hits();
+  /** @brief Amount of get_global_route() calls that had to compute the route */
+  static unsigned long get_route_cache_misses();
+
   virtual void get_graph(xbt_graph_t graph, std::map<std::string, xbt_node_t>* nodes,
                          std::map<std::string, xbt_edge_t>* edges) = 0;
   enum class RoutingMode {
@@ -145,6 +152,9 @@ public:
 private:
   std::map<std::pair<NetPoint*, NetPoint*>, BypassRoute*> bypass_routes_; // src x dst -> route
   routing::NetPoint* netpoint_ = nullptr;                                // Our representative in the father NetZone
+
+  static void resolve_global_route(routing::NetPoint* src, routing::NetPoint* dst,
+                                   /* OUT */ std::vector<resource::LinkImpl*>& links, double* latency);
 };
 } // namespace routing
 } // namespace kernel
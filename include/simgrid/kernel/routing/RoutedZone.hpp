@@ -8,6 +8,8 @@
 
 #include <simgrid/kernel/routing/NetZoneImpl.hpp>
 
+#include <unordered_map>
+
 namespace simgrid {
 namespace kernel {
 namespace routing {
@@ -51,6 +53,9 @@ namespace routing {
 class XBT_PRIVATE RoutedZone : public NetZoneImpl {
 public:
   explicit RoutedZone(NetZoneImpl* father, const std::string& name, resource::NetworkModel* netmodel);
+  RoutedZone(const RoutedZone&) = delete;
+  RoutedZone& operator=(const RoutedZone&) = delete;
+  ~RoutedZone() override;
 
   void get_graph(xbt_graph_t graph, std::map<std::string, xbt_node_t>* nodes,
                  std::map<std::string, xbt_edge_t>* edges) override;
@@ -59,9 +64,14 @@ protected:
   virtual RouteCreationArgs* new_extended_route(RoutingMode hierarchy, NetPoint* src, NetPoint* dst, NetPoint* gw_src,
                                                 NetPoint* gw_dst, std::vector<resource::LinkImpl*>& link_list,
                                                 bool symmetrical, bool change_order);
+  RouteCreationArgs* share_route(RouteCreationArgs* route);
   void get_route_check_params(NetPoint* src, NetPoint* dst);
   void add_route_check_params(NetPoint* src, NetPoint* dst, NetPoint* gw_src, NetPoint* gw_dst,
                               std::vector<resource::LinkImpl*>& link_list, bool symmetrical);
+
+private:
+  /* Routes handed out by share_route(), indexed by a hash of their content. They are owned by this netzone. */
+  std::unordered_multimap<size_t, RouteCreationArgs*> shared_routes_;
 };
 } // namespace routing
 } // namespace kernel
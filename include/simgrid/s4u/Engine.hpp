@@ -128,6 +128,11 @@ public:
   std::vector<kernel::routing::NetPoint*> get_all_netpoints();
   kernel::routing::NetPoint* netpoint_by_name_or_null(const std::string& name);
 
+  /** @brief Amount of routes that were found in the route cache (see the network/route-cache-size option) */
+  unsigned long get_route_cache_hits();
+  /** @brief Amount of routes that had to be computed because they were not in the route cache */
+  unsigned long get_route_cache_misses();
+
   NetZone* get_netzone_root();
   void set_netzone_root(NetZone* netzone);
 
@@ -12,7 +12,6 @@
 #include <xbt/future.hpp>
 #include <xbt/signal.hpp>
 
-#include <boost/heap/fibonacci_heap.hpp>
 #include <string>
 #include <unordered_map>
 
@@ -106,15 +105,12 @@ typedef std::function<ActorCode(std::vector<std::string> args)> ActorCodeFactory
 
 XBT_PUBLIC void register_function(const std::string& name, const ActorCodeFactory& factory);
 
-typedef std::pair<double, Timer*> TimerQelt;
-static boost::heap::fibonacci_heap<TimerQelt, boost::heap::compare<xbt::HeapComparator<TimerQelt>>> simix_timers;
-
 /** @brief Timer datatype */
 class Timer {
   double date = 0.0;
 
 public:
-  decltype(simix_timers)::handle_type handle_;
+  unsigned handle_ = 0; // in the queue of pending timers
 
   Timer(double date, simgrid::xbt::Task<void()>&& callback) : date(date), callback(std::move(callback)) {}
 
@@ -140,7 +136,7 @@ public:
     return set(date, std::bind(callback, arg));
   }
   static Timer* set(double date, simgrid::xbt::Task<void()>&& callback);
-  static double next() { return simix_timers.empty() ? -1.0 : simix_timers.top().first; }
+  static double next();
 };
 
 } // namespace simix
@@ -27,7 +27,8 @@ typedef enum {
   XBT_PARMAP_POSIX,          /**< use POSIX synchronization primitives */
   XBT_PARMAP_FUTEX,          /**< use Linux futex system call */
   XBT_PARMAP_BUSY_WAIT,      /**< busy waits (no system calls, maximum CPU usage) */
-  XBT_PARMAP_DEFAULT         /**< futex if available, posix otherwise */
+  XBT_PARMAP_DEFAULT,        /**< futex if available, posix otherwise */
+  XBT_PARMAP_WORK_STEALING   /**< default synchronization, but each worker has its own share of the work */
 } e_xbt_parmap_mode_t;
 
 /** @} */
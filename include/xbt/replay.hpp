@@ -13,7 +13,9 @@
 #include <fstream>
 #include <functional>
 #include <queue>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace simgrid {
 namespace xbt {
@@ -28,5 +30,6 @@ XBT_PUBLIC int replay_runner(const char* actor_name, const char* trace_filename)
 typedef std::function<void(simgrid::xbt::ReplayAction&)> action_fun;
 XBT_PUBLIC void xbt_replay_action_register(const char* action_name, const action_fun& function);
 XBT_PUBLIC action_fun xbt_replay_action_get(const char* action_name);
+XBT_PUBLIC void xbt_replay_set_tracefile(const std::string& filename);
 
 #endif
@@ -0,0 +1,144 @@
+/* Copyright (c) 2019. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#ifndef XBT_EVENT_QUEUE_HPP
+#define XBT_EVENT_QUEUE_HPP
+
+#include <xbt/asserts.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace simgrid {
+namespace xbt {
+
+/** @brief Queue of dated events, that gives the earliest one first
+ *
+ * Events of the same date are given in their insertion order.
+ *
+ * The queue is a binary heap of small nodes, while the events themselves are stored in a pool of recycled slots. Once
+ * the queue reached its working size, pushing and popping events does not allocate anymore.
+ *
+ * An event can be cancelled in constant time, through the handle returned by push(). It is only marked as such, and
+ * dropped when it reaches the top of the heap, or when the cancelled events make more than half of the heap.
+ */
+template <class T> class EventQueue {
+public:
+  typedef unsigned handle_type;
+
+private:
+  struct Node {
+    double date;
+    uint64_t seq;
+    handle_type slot;
+  };
+  struct Later {
+    bool operator()(const Node& a, const Node& b) const
+    {
+      return a.date > b.date || (a.date == b.date && a.seq > b.seq);
+    }
+  };
+  struct Slot {
+    T value;
+    bool cancelled;
+  };
+
+  std::vector<Node> heap_;
+  std::vector<Slot> slots_;
+  std::vector<handle_type> free_slots_;
+  uint64_t next_seq_ = 0;
+  size_t cancelled_  = 0;
+
+  void release(handle_type slot)
+  {
+    slots_[slot].value = T();
+    free_slots_.push_back(slot);
+  }
+
+  void pop_node()
+  {
+    std::pop_heap(heap_.begin(), heap_.end(), Later());
+    heap_.pop_back();
+  }
+
+  /* Ensures that the top of the heap is not a cancelled event */
+  void drop_cancelled_top()
+  {
+    while (not heap_.empty() && slots_[heap_.front().slot].cancelled) {
+      release(heap_.front().slot);
+      pop_node();
+      cancelled_--;
+    }
+  }
+
+  /* Removes all cancelled events at once */
+  void purge()
+  {
+    auto last = std::remove_if(heap_.begin(), heap_.end(), [this](const Node& node) {
+      if (not slots_[node.slot].cancelled)
+        return false;
+      release(node.slot);
+      return true;
+    });
+    heap_.erase(last, heap_.end());
+    std::make_heap(heap_.begin(), heap_.end(), Later());
+    cancelled_ = 0;
+  }
+
+public:
+  bool empty() const { return heap_.empty(); }
+  /** Number of pending events */
+  size_t size() const { return heap_.size() - cancelled_; }
+  /** Date of the earliest event (the queue must not be empty) */
+  double top_date() const { return heap_.front().date; }
+  /** Earliest event (the queue must not be empty) */
+  const T& top() const { return slots_[heap_.front().slot].value; }
+
+  /** Adds an event, and returns the handle to cancel it. That handle is only valid until the event is popped */
+  handle_type push(double date, T value)
+  {
+    handle_type slot;
+    if (free_slots_.empty()) {
+      slot = static_cast<handle_type>(slots_.size());
+      slots_.push_back({std::move(value), false});
+    } else {
+      slot = free_slots_.back();
+      free_slots_.pop_back();
+      slots_[slot] = {std::move(value), false};
+    }
+    heap_.push_back({date, next_seq_++, slot});
+    std::push_heap(heap_.begin(), heap_.end(), Later());
+    return slot;
+  }
+
+  /** Removes the earliest event, and returns it (the queue must not be empty) */
+  T pop()
+  {
+    handle_type slot = heap_.front().slot;
+    T value          = std::move(slots_[slot].value);
+    release(slot);
+    pop_node();
+    drop_cancelled_top();
+    return value;
+  }
+
+  /** Cancels a pending event */
+  void cancel(handle_type handle)
+  {
+    xbt_assert(handle < slots_.size() && not slots_[handle].cancelled, "Cannot cancel event %u twice", handle);
+    slots_[handle].cancelled = true;
+    cancelled_++;
+    if (cancelled_ > heap_.size() / 2)
+      purge();
+    else
+      drop_cancelled_top();
+  }
+};
+} // namespace xbt
+} // namespace simgrid
+
+#endif
@@ -14,9 +14,11 @@
 
 #include <boost/optional.hpp>
 #include <condition_variable>
+#include <cstdint>
 #include <functional>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 #if HAVE_FUTEX_H
 #include <linux/futex.h>
@@ -44,6 +46,7 @@ public:
   Parmap& operator=(const Parmap&) = delete;
   ~Parmap();
   void apply(std::function<void(T)>&& fun, const std::vector<T>& data);
+  void apply_inline(std::function<void(T)>&& fun, const std::vector<T>& data);
   boost::optional<T> next();
 
 private:
@@ -134,8 +137,31 @@ private:
     void worker_wait(unsigned) override;
   };
 
+  /**
+   * @brief Share of the work of a worker, in work-stealing mode.
+   *
+   * The worker takes the elements at the front of its range, and the other workers steal them at the back once their
+   * own range is empty. Both bounds are packed in a single atomic word: the owner simply increments the beginning (which
+   * may go past the end once the range is empty), while the thieves decrement the end with a compare-and-swap.
+   */
+  class WorkRange {
+  public:
+    void set(unsigned begin, unsigned end)
+    {
+      bounds.store(static_cast<uint64_t>(begin) << 32 | end, std::memory_order_relaxed);
+    }
+    bool take_front(unsigned* index);
+    bool take_back(unsigned* index);
+
+  private:
+    std::atomic<uint64_t> bounds{0};                     /**< begin in the high bits, end in the low ones */
+    char padding[64 - sizeof(std::atomic<uint64_t>)];    /**< one range per cache line */
+  };
+
   static void worker_main(ThreadData* data);
   Synchro* new_synchro(e_xbt_parmap_mode_t mode);
+  void split_work(unsigned parts);
+  bool pick(unsigned worker, unsigned* index);
   void work();
 
   bool destroying;                   /**< is the parmap being destroyed? */
@@ -148,8 +174,14 @@ private:
   std::function<void(T)> fun;           /**< function to run in parallel on each element of data */
   const std::vector<T>* data = nullptr; /**< parameters to pass to fun in parallel */
   std::atomic_uint index;               /**< index of the next element of data to pick */
+
+  bool stealing;                 /**< whether each worker has its own range of elements to pick */
+  std::vector<WorkRange> ranges; /**< range of each worker, in work-stealing mode */
+  static thread_local unsigned self_id; /**< id of the worker running on this thread (the controller is 0) */
 };
 
+template <typename T> thread_local unsigned Parmap<T>::self_id = 0;
+
 /**
  * @brief Creates a parallel map object
  * @param num_workers number of worker threads to create
@@ -164,7 +196,10 @@ template <typename T> Parmap<T>::Parmap(unsigned num_workers, e_xbt_parmap_mode_
   this->work_round  = 0;
   this->workers.resize(num_workers);
   this->num_workers = num_workers;
+  this->stealing    = (mode == XBT_PARMAP_WORK_STEALING);
   this->synchro     = new_synchro(mode);
+  if (this->stealing)
+    this->ranges = std::vector<WorkRange>(num_workers);
 
   /* Create the pool of worker threads (the caller of apply() will be worker[0]) */
   this->workers[0] = nullptr;
@@ -220,12 +255,71 @@ template <typename T> void Parmap<T>::apply(std::function<void(T)>&& fun, const
   this->fun   = std::move(fun);
   this->data  = &data;
   this->index = 0;
+  if (this->stealing)
+    this->split_work(num_workers);
   this->synchro->master_signal(); // maestro runs futex_wake to wake all the minions (the working threads)
   this->work();                   // maestro works with its minions
   this->synchro->master_wait();   // When there is no more work to do, then maestro waits for the last minion to stop
   XBT_CDEBUG(xbt_parmap, "Job done"); //   ... and proceeds
 }
 
+/**
+ * @brief Applies a list of tasks in the calling thread only, without waking the workers.
+ *
+ * This is cheaper than apply() when there is too few work to share. It must be called by the controller thread.
+ *
+ * @param fun the function to call
+ * @param data each element of this vector will be passed as an argument to fun
+ */
+template <typename T> void Parmap<T>::apply_inline(std::function<void(T)>&& fun, const std::vector<T>& data)
+{
+  this->fun   = std::move(fun);
+  this->data  = &data;
+  this->index = 0;
+  if (this->stealing)
+    this->split_work(1);
+  this->work();
+  XBT_CDEBUG(xbt_parmap, "Job done inline");
+}
+
+/**
+ * @brief Splits the work in a range for each of the given amount of first workers (the other ones get no work).
+ */
+template <typename T> void Parmap<T>::split_work(unsigned parts)
+{
+  size_t length = this->data->size();
+  for (unsigned i = 0; i < num_workers; i++) {
+    if (i < parts)
+      ranges[i].set(length * i / parts, length * (i + 1) / parts);
+    else
+      ranges[i].set(0, 0);
+  }
+}
+
+template <typename T> bool Parmap<T>::WorkRange::take_front(unsigned* index)
+{
+  uint64_t old_bounds = bounds.fetch_add(static_cast<uint64_t>(1) << 32, std::memory_order_relaxed);
+  unsigned begin      = old_bounds >> 32;
+  if (begin >= static_cast<uint32_t>(old_bounds))
+    return false;
+  *index = begin;
+  return true;
+}
+
+template <typename T> bool Parmap<T>::WorkRange::take_back(unsigned* index)
+{
+  uint64_t old_bounds = bounds.load(std::memory_order_relaxed);
+  uint64_t new_bounds;
+  do {
+    unsigned end = static_cast<uint32_t>(old_bounds);
+    if ((old_bounds >> 32) >= end)
+      return false;
+    *index     = end - 1;
+    new_bounds = old_bounds - 1;
+  } while (not bounds.compare_exchange_weak(old_bounds, new_bounds, std::memory_order_relaxed));
+  return true;
+}
+
 /**
  * @brief Returns a next task to process.
  *
@@ -235,6 +329,13 @@ template <typename T> void Parmap<T>::apply(std::function<void(T)>&& fun, const
  */
 template <typename T> boost::optional<T> Parmap<T>::next()
 {
+  if (this->stealing) {
+    unsigned index;
+    if (pick(self_id, &index))
+      return (*this->data)[index];
+    return boost::none;
+  }
+
   unsigned index = this->index.fetch_add(1, std::memory_order_relaxed);
   if (index < this->data->size())
     return (*this->data)[index];
@@ -242,11 +343,32 @@ template <typename T> boost::optional<T> Parmap<T>::next()
     return boost::none;
 }
 
+/**
+ * @brief Picks the next element for the given worker in work-stealing mode: in its own range first, then in the others.
+ */
+template <typename T> bool Parmap<T>::pick(unsigned worker, unsigned* index)
+{
+  if (ranges[worker].take_front(index))
+    return true;
+  for (unsigned i = 1; i < num_workers; i++)
+    if (ranges[(worker + i) % num_workers].take_back(index))
+      return true;
+  return false;
+}
+
 /**
  * @brief Main work loop: applies fun to elements in turn.
  */
 template <typename T> void Parmap<T>::work()
 {
+  if (this->stealing) {
+    unsigned worker = self_id;
+    unsigned index;
+    while (pick(worker, &index))
+      this->fun((*this->data)[index]);
+    return;
+  }
+
   unsigned length = this->data->size();
   unsigned index  = this->index.fetch_add(1, std::memory_order_relaxed);
   while (index < length) {
@@ -261,7 +383,7 @@ template <typename T> void Parmap<T>::work()
  */
 template <typename T> typename Parmap<T>::Synchro* Parmap<T>::new_synchro(e_xbt_parmap_mode_t mode)
 {
-  if (mode == XBT_PARMAP_DEFAULT) {
+  if (mode == XBT_PARMAP_DEFAULT || mode == XBT_PARMAP_WORK_STEALING) {
 #if HAVE_FUTEX_H
     mode = XBT_PARMAP_FUTEX;
 #else
@@ -296,6 +418,7 @@ template <typename T> void Parmap<T>::worker_main(ThreadData* data)
   unsigned round        = 0;
   kernel::context::Context* context = simix_global->context_factory->create_context(std::function<void()>(), nullptr);
   kernel::context::Context::set_current(context);
+  self_id = data->worker_id;
 
   XBT_CDEBUG(xbt_parmap, "New worker thread created");
 
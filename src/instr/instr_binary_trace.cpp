@@ -0,0 +1,152 @@
+/* Copyright (c) 2019. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#include "src/instr/instr_binary_trace.hpp"
+#include "src/instr/instr_private.hpp"
+
+#include <cstdio>
+#include <unordered_map>
+
+XBT_LOG_NEW_DEFAULT_SUBCATEGORY(instr_binary_trace, instr, "Binary trace format");
+
+extern simgrid::instr::TraceFile tracing_file;
+
+namespace {
+int precision = 6;
+int64_t last_time_ticks = 0;
+std::unordered_map<std::string, uint64_t> strings;
+std::string pending_strings; // definitions of the strings used by the line being built
+std::string line_fields;     // reused by all the lines
+std::string record;
+
+/* Converts the value into a number of ticks, such that the Paje text of the value (printed with the current precision)
+ * can be rebuilt from the ticks. Returns false if this is not possible (-0.000, infinity, too many digits) */
+bool to_ticks(double value, int64_t* ticks)
+{
+  char text[64];
+  int len = snprintf(text, sizeof text, "%.*f", precision, value);
+  if (len <= 0 || len >= static_cast<int>(sizeof text))
+    return false;
+
+  const char* p = text;
+  bool negative = (*p == '-');
+  if (negative)
+    p++;
+  int64_t result = 0;
+  int digits     = 0;
+  for (; *p != '\0'; p++) {
+    if (*p == '.')
+      continue;
+    if (*p < '0' || *p > '9' || ++digits > 18)
+      return false;
+    result = result * 10 + (*p - '0');
+  }
+  if (negative && result == 0)
+    return false;
+  *ticks = negative ? -result : result;
+  return true;
+}
+
+std::string to_text(double value)
+{
+  char text[64];
+  snprintf(text, sizeof text, "%.*f", precision, value);
+  return text;
+}
+} // namespace
+
+void TRACE_binary_start(int precision_digits)
+{
+  precision       = precision_digits;
+  last_time_ticks = 0;
+  strings.clear();
+
+  std::string header(simgrid::instr::binary::MAGIC, sizeof(simgrid::instr::binary::MAGIC));
+  simgrid::instr::binary::put_varint(header, simgrid::instr::binary::VERSION);
+  simgrid::instr::binary::put_varint(header, precision);
+  tracing_file.write_record(header);
+}
+
+std::string TRACE_binary_raw(const std::string& text)
+{
+  std::string raw;
+  simgrid::instr::binary::put_varint(raw, simgrid::instr::binary::RECORD_RAW);
+  simgrid::instr::binary::put_varint(raw, text.size());
+  raw.append(text);
+  return raw;
+}
+
+namespace simgrid {
+namespace instr {
+
+BinaryLine::BinaryLine(unsigned event_type) : fields_(line_fields), event_type_(event_type)
+{
+  fields_.clear();
+  pending_strings.clear();
+}
+
+void BinaryLine::put_field(unsigned kind, uint64_t value)
+{
+  binary::put_varint(fields_, (value << binary::FIELD_KIND_BITS) | kind);
+  count_++;
+}
+
+BinaryLine& BinaryLine::time(double timestamp)
+{
+  int64_t ticks;
+  if (not to_ticks(timestamp, &ticks))
+    return literal(to_text(timestamp));
+  put_field(binary::FIELD_TIME, binary::zigzag(ticks - last_time_ticks));
+  last_time_ticks = ticks;
+  return *this;
+}
+
+BinaryLine& BinaryLine::number(double value)
+{
+  int64_t ticks;
+  if (not to_ticks(value, &ticks))
+    return literal(to_text(value));
+  put_field(binary::FIELD_NUMBER, binary::zigzag(ticks));
+  return *this;
+}
+
+BinaryLine& BinaryLine::integer(long long value)
+{
+  put_field(binary::FIELD_INTEGER, binary::zigzag(value));
+  return *this;
+}
+
+BinaryLine& BinaryLine::string(const std::string& str)
+{
+  auto elm = strings.find(str);
+  if (elm == strings.end()) {
+    elm = strings.emplace(str, strings.size()).first;
+    binary::put_varint(pending_strings, binary::RECORD_STRING);
+    binary::put_varint(pending_strings, str.size());
+    pending_strings.append(str);
+  }
+  put_field(binary::FIELD_STRING, elm->second);
+  return *this;
+}
+
+BinaryLine& BinaryLine::literal(const std::string& str)
+{
+  put_field(binary::FIELD_LITERAL, str.size());
+  fields_.append(str);
+  return *this;
+}
+
+void BinaryLine::write()
+{
+  record.assign(pending_strings);
+  binary::put_varint(record, binary::RECORD_LINE);
+  binary::put_varint(record, event_type_);
+  binary::put_varint(record, count_);
+  record.append(fields_);
+  XBT_DEBUG("Dump a line of event type %u with %u fields (%zu bytes)", event_type_, count_, record.size());
+  tracing_file.write_record(record);
+}
+} // namespace instr
+} // namespace simgrid
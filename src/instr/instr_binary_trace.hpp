@@ -0,0 +1,91 @@
+/* Copyright (c) 2019. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#ifndef INSTR_BINARY_TRACE_HPP
+#define INSTR_BINARY_TRACE_HPP
+
+#include <xbt/base.h>
+
+#include <cstdint>
+#include <string>
+
+/* The binary trace format encodes the lines of the Paje trace, so that it can be expanded back to the very same Paje
+ * file. The file starts with the magic string and a header, followed by records. Every number is written as a
+ * LEB128 varint (signed numbers are zigzag-encoded first).
+ *
+ *   header: "SGPAJEB\0", version, precision (number of digits after the decimal point)
+ *   RECORD_RAW:    length, bytes            (text copied as is, such as the Paje header and the comments)
+ *   RECORD_STRING: length, bytes            (defines the next string, numbered from 0)
+ *   RECORD_LINE:   event type, field count, fields
+ *
+ * The fields of a line are separated by a space in the Paje file. Each of them starts with a varint whose lowest
+ * FIELD_KIND_BITS give its kind, and whose other bits give its value:
+ *   FIELD_STRING:  rank of an already defined string
+ *   FIELD_TIME:    timestamp, as the (zigzag) difference in ticks with the previous timestamp
+ *   FIELD_NUMBER:  other real number, as a (zigzag) number of ticks (a tick is 10^-precision)
+ *   FIELD_INTEGER: (zigzag) integer
+ *   FIELD_LITERAL: length of the string, that follows the varint
+ */
+namespace simgrid {
+namespace instr {
+namespace binary {
+constexpr char MAGIC[8]   = {'S', 'G', 'P', 'A', 'J', 'E', 'B', '\0'};
+constexpr unsigned VERSION = 1;
+
+enum RecordKind : unsigned { RECORD_RAW = 0, RECORD_STRING = 1, RECORD_LINE = 2 };
+enum FieldKind : unsigned { FIELD_STRING = 0, FIELD_TIME = 1, FIELD_NUMBER = 2, FIELD_INTEGER = 3, FIELD_LITERAL = 4 };
+constexpr unsigned FIELD_KIND_BITS = 3;
+
+inline void put_varint(std::string& out, uint64_t value)
+{
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+inline uint64_t zigzag(int64_t value)
+{
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t unzigzag(uint64_t value)
+{
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+} // namespace binary
+
+/** @brief Encodes a line of the Paje trace in the binary format, and writes it to the trace file */
+class XBT_PRIVATE BinaryLine {
+  std::string& fields_;
+  unsigned count_ = 0;
+  unsigned event_type_;
+
+  void put_field(unsigned kind, uint64_t value);
+
+public:
+  explicit BinaryLine(unsigned event_type);
+  BinaryLine(const BinaryLine&) = delete;
+  BinaryLine& operator=(const BinaryLine&) = delete;
+
+  BinaryLine& time(double timestamp);
+  BinaryLine& number(double value);
+  BinaryLine& integer(long long value);
+  /** Adds a string that is likely to be repeated (name, value), and is thus defined only once in the file */
+  BinaryLine& string(const std::string& str);
+  /** Adds a string that is written in the line itself */
+  BinaryLine& literal(const std::string& str);
+  void write();
+};
+} // namespace instr
+} // namespace simgrid
+
+/** Writes the header of the binary trace file, and resets the encoding state */
+XBT_PRIVATE void TRACE_binary_start(int precision);
+/** Returns the record holding the given text in the binary format */
+XBT_PRIVATE std::string TRACE_binary_raw(const std::string& text);
+
+#endif
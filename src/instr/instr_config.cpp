@@ -17,7 +17,7 @@
 XBT_LOG_NEW_CATEGORY(instr, "Logging the behavior of the tracing system (used for Visualization/Analysis of simulations)");
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY (instr_config, instr, "Configuration");
 
-std::ofstream tracing_file;
+simgrid::instr::TraceFile tracing_file;
 
 constexpr char OPT_TRACING_BASIC[]             = "tracing/basic";
 constexpr char OPT_TRACING_COMMENT_FILE[]      = "tracing/comment-file";
@@ -80,6 +80,9 @@ static simgrid::config::Flag<bool> trace_disable_link{"tracing/disable_link",
                                                       "Do not trace link bandwidth and latency.", false};
 static simgrid::config::Flag<bool> trace_disable_power{"tracing/disable_power", "Do not trace host power.", false};
 
+static simgrid::config::Flag<bool> trace_io_thread{
+    "tracing/io-thread", "Write the trace file from a dedicated thread, while the simulation goes on.", false};
+
 static bool trace_active     = false;
 
 simgrid::instr::TraceFormat simgrid::instr::trace_format = simgrid::instr::TraceFormat::Paje;
@@ -102,7 +105,7 @@ static void TRACE_start()
 
     /* open the trace file(s) */
     std::string filename = TRACE_get_filename();
-    tracing_file.open(filename.c_str(), std::ofstream::out);
+    tracing_file.open(filename, trace_io_thread, format == "Binary");
     if (tracing_file.fail()) {
       throw simgrid::TracingError(
           XBT_THROW_POINT,
@@ -111,17 +114,20 @@ static void TRACE_start()
 
     XBT_DEBUG("Filename %s is open for writing", filename.c_str());
 
-    if (format == "Paje") {
+    if (format == "Binary")
+      TRACE_binary_start(TRACE_precision());
+
+    if (format == "Paje" || format == "Binary") {
       /* output generator version */
       tracing_file << "#This file was generated using SimGrid-" << SIMGRID_VERSION_MAJOR << "." << SIMGRID_VERSION_MINOR
-                   << "." << SIMGRID_VERSION_PATCH << std::endl;
+                   << "." << SIMGRID_VERSION_PATCH << '\n';
       tracing_file << "#[";
       unsigned int cpt;
       char* str;
       xbt_dynar_foreach (xbt_cmdline, cpt, str) {
         tracing_file << str << " ";
       }
-      tracing_file << "]" << std::endl;
+      tracing_file << "]" << '\n';
     }
 
     /* output one line comment */
@@ -130,7 +136,9 @@ static void TRACE_start()
     /* output comment file */
     dump_comment_file(simgrid::config::get_value<std::string>(OPT_TRACING_COMMENT_FILE));
 
-    if (format == "Paje") {
+    if (format == "Paje" || format == "Binary") {
+      if (format == "Binary")
+        simgrid::instr::trace_format = simgrid::instr::TraceFormat::Binary;
       /* output Pajé header */
       TRACE_header(TRACE_basic(), TRACE_display_sizes());
     } else
@@ -279,7 +287,8 @@ void TRACE_global_init()
                                              "simgrid.trace");
   simgrid::config::declare_flag<std::string>(
       "tracing/smpi/format", "Select trace output format used by SMPI. The default is the 'Paje' format. "
-                             "The 'TI' (Time-Independent) format allows for trace replay.",
+                             "The 'TI' (Time-Independent) format allows for trace replay. The 'Binary' format is a "
+                             "compact encoding of the 'Paje' format, that sg_trace2paje expands back.",
       "Paje");
 
   simgrid::config::declare_flag<bool>(OPT_TRACING_FORMAT_TI_ONEFILE,
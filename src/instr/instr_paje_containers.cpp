@@ -14,7 +14,7 @@
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY (instr_paje_containers, instr, "Paje tracing event system (containers)");
 
-extern std::ofstream tracing_file;
+extern simgrid::instr::TraceFile tracing_file;
 std::map<container_t, std::ofstream*> tracing_files; // TI specific
 double prefix = 0.0;                               // TI specific
 
@@ -169,7 +169,16 @@ void Container::log_creation()
       stream << "rank-" << stoi(name_.substr(5)) - 1 << "\"";
 
     XBT_DEBUG("Dump %s", stream.str().c_str());
-    tracing_file << stream.str() << std::endl;
+    tracing_file << stream.str() << '\n';
+  } else if (trace_format == simgrid::instr::TraceFormat::Binary) {
+    BinaryLine line(PAJE_CreateContainer);
+    line.time(timestamp).integer(id_).integer(type_->get_id()).integer(father_->id_);
+    if (name_.find("rank-") != 0)
+      line.string("\"" + name_ + "\"");
+    else
+      /* Subtract -1 because this is the process id and we transform it to the rank id */
+      line.string("\"rank-" + std::to_string(stoi(name_.substr(5)) - 1) + "\"");
+    line.write();
   } else if (trace_format == simgrid::instr::TraceFormat::Ti) {
     // if we are in the mode with only one file
     static std::ofstream* ti_unique_file = nullptr;
@@ -189,7 +198,7 @@ void Container::log_creation()
 #endif
       ti_unique_file = new std::ofstream(filename.c_str(), std::ofstream::out);
       xbt_assert(not ti_unique_file->fail(), "Tracefile %s could not be opened for writing", filename.c_str());
-      tracing_file << filename << std::endl;
+      tracing_file << filename << '\n';
     }
     tracing_files.insert({this, ti_unique_file});
   } else {
@@ -208,7 +217,10 @@ void Container::log_destruction()
     stream << std::fixed << std::setprecision(TRACE_precision()) << PAJE_DestroyContainer << " ";
     stream << timestamp << " " << type_->get_id() << " " << id_;
     XBT_DEBUG("Dump %s", stream.str().c_str());
-    tracing_file << stream.str() << std::endl;
+    tracing_file << stream.str() << '\n';
+  } else if (trace_format == simgrid::instr::TraceFormat::Binary) {
+    BinaryLine line(PAJE_DestroyContainer);
+    line.time(timestamp).integer(type_->get_id()).integer(id_).write();
   } else if (trace_format == simgrid::instr::TraceFormat::Ti) {
     if (not simgrid::config::get_value<bool>("tracing/smpi/format/ti-one-file") || tracing_files.size() == 1) {
       tracing_files.at(this)->close();
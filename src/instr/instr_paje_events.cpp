@@ -9,7 +9,7 @@
 #include "src/surf/surf_interface.hpp"
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(instr_paje_events, instr, "Paje tracing event system (events)");
-extern std::ofstream tracing_file;
+extern simgrid::instr::TraceFile tracing_file;
 extern std::map<container_t, std::ofstream*> tracing_files; // TI specific
 
 namespace simgrid {
@@ -26,13 +26,23 @@ PajeEvent::PajeEvent(Container* container, Type* type, double timestamp, e_event
   insert_into_buffer();
 };
 
+BinaryLine& PajeEvent::binary_line(BinaryLine& line)
+{
+  return line.time(timestamp_).integer(type_->get_id()).integer(container_->get_id());
+}
+
 void PajeEvent::print()
 {
+  if (trace_format == simgrid::instr::TraceFormat::Binary) {
+    BinaryLine line(eventType_);
+    binary_line(line).write();
+    return;
+  }
   if (trace_format != simgrid::instr::TraceFormat::Paje)
     return;
 
   XBT_DEBUG("Dump %s", stream_.str().c_str());
-  tracing_file << stream_.str() << std::endl;
+  tracing_file << stream_.str() << '\n';
 }
 
 StateEvent::StateEvent(Container* container, Type* type, e_event_type event_type, EntityValue* value, TIData* extra)
@@ -49,17 +59,30 @@ StateEvent::StateEvent(Container* container, Type* type, e_event_type event_type
 
 void NewEvent::print()
 {
+  if (trace_format == simgrid::instr::TraceFormat::Binary) {
+    BinaryLine line(eventType_);
+    binary_line(line).integer(value->get_id()).write();
+    return;
+  }
   if (trace_format != simgrid::instr::TraceFormat::Paje)
     return;
 
   stream_ << " " << value->get_id();
 
   XBT_DEBUG("Dump %s", stream_.str().c_str());
-  tracing_file << stream_.str() << std::endl;
+  tracing_file << stream_.str() << '\n';
 }
 
 void LinkEvent::print()
 {
+  if (trace_format == simgrid::instr::TraceFormat::Binary) {
+    BinaryLine line(eventType_);
+    binary_line(line).string(value_).integer(endpoint_->get_id()).literal(key_);
+    if (TRACE_display_sizes() && size_ != -1)
+      line.integer(size_);
+    line.write();
+    return;
+  }
   if (trace_format != simgrid::instr::TraceFormat::Paje)
     return;
 
@@ -69,18 +92,23 @@ void LinkEvent::print()
     stream_ << " " << size_;
 
   XBT_DEBUG("Dump %s", stream_.str().c_str());
-  tracing_file << stream_.str() << std::endl;
+  tracing_file << stream_.str() << '\n';
 }
 
 void VariableEvent::print()
 {
+  if (trace_format == simgrid::instr::TraceFormat::Binary) {
+    BinaryLine line(eventType_);
+    binary_line(line).number(value_).write();
+    return;
+  }
   if (trace_format != simgrid::instr::TraceFormat::Paje)
     return;
 
   stream_ << " " << value_;
 
   XBT_DEBUG("Dump %s", stream_.str().c_str());
-  tracing_file << stream_.str() << std::endl;
+  tracing_file << stream_.str() << '\n';
 }
 
 void StateEvent::print()
@@ -99,7 +127,22 @@ void StateEvent::print()
     }
 #endif
     XBT_DEBUG("Dump %s", stream_.str().c_str());
-    tracing_file << stream_.str() << std::endl;
+    tracing_file << stream_.str() << '\n';
+  } else if (trace_format == simgrid::instr::TraceFormat::Binary) {
+    BinaryLine line(eventType_);
+    binary_line(line);
+    if (value != nullptr) // PAJE_PopState Event does not need to have a value
+      line.integer(value->get_id());
+
+    if (TRACE_display_sizes())
+      line.literal((extra_ != nullptr) ? extra_->display_size() : "");
+
+#if HAVE_SMPI
+    if (simgrid::config::get_value<bool>("smpi/trace-call-location")) {
+      line.string("\"" + filename + "\"").integer(linenumber);
+    }
+#endif
+    line.write();
   } else if (trace_format == simgrid::instr::TraceFormat::Ti) {
     if (extra_ == nullptr)
       return;
@@ -113,11 +156,11 @@ void StateEvent::print()
     }
     #if HAVE_SMPI
     if (simgrid::config::get_value<bool>("smpi/trace-call-location")) {
-      stream_ << container_name << " location " << filename << " " << linenumber << std::endl ;
+      stream_ << container_name << " location " << filename << " " << linenumber << '\n';
     }
     #endif
     stream_ << container_name << " " << extra_->print();
-    *tracing_files.at(get_container()) << stream_.str() << std::endl;
+    *tracing_files.at(get_container()) << stream_.str() << '\n';
   } else {
     THROW_IMPOSSIBLE;
   }
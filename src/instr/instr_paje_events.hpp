@@ -13,6 +13,7 @@
 
 namespace simgrid {
 namespace instr {
+class BinaryLine;
 class EntityValue;
 class TIData;
 
@@ -42,6 +43,9 @@ class PajeEvent {
   Type* type_;
 protected:
   Container* get_container() { return container_; }
+  /** Adds the fields common to all events to the binary line */
+  BinaryLine& binary_line(BinaryLine& line);
+
 public:
   double timestamp_;
   e_event_type eventType_;
@@ -14,14 +14,14 @@
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(instr_paje_trace, instr, "tracing event system");
 
-extern std::ofstream tracing_file;
+extern simgrid::instr::TraceFile tracing_file;
 
 static std::vector<simgrid::instr::PajeEvent*> buffer;
 
 void dump_comment(const std::string& comment)
 {
   if (not comment.empty())
-    tracing_file << "# " << comment << std::endl;
+    tracing_file << "# " << comment << '\n';
 }
 
 void dump_comment_file(const std::string& filename)
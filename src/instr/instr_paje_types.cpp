@@ -9,7 +9,7 @@
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY (instr_paje_types, instr, "Paje tracing event system (types)");
 
-extern std::ofstream tracing_file;
+extern simgrid::instr::TraceFile tracing_file;
 // to check if variables were previously set to 0, otherwise paje won't simulate them
 static std::set<std::string> platform_variables;
 
@@ -136,6 +136,14 @@ void LinkType::end_event(Container* endContainer, const std::string& value, cons
 
 void Type::log_definition(e_event_type event_type)
 {
+  if (trace_format == simgrid::instr::TraceFormat::Binary) {
+    BinaryLine line(event_type);
+    line.integer(get_id()).integer(father_->get_id()).string(get_name());
+    if (is_colored())
+      line.string("\"" + color_ + "\"");
+    line.write();
+    return;
+  }
   if (trace_format != simgrid::instr::TraceFormat::Paje)
     return;
   XBT_DEBUG("%s: event_type=%u, timestamp=%.*f", __func__, event_type, TRACE_precision(), 0.);
@@ -143,18 +151,24 @@ void Type::log_definition(e_event_type event_type)
   if (is_colored())
     stream_ << " \"" << color_ << "\"";
   XBT_DEBUG("Dump %s", stream_.str().c_str());
-  tracing_file << stream_.str() << std::endl;
+  tracing_file << stream_.str() << '\n';
 }
 
 void Type::log_definition(simgrid::instr::Type* source, simgrid::instr::Type* dest)
 {
+  if (trace_format == simgrid::instr::TraceFormat::Binary) {
+    BinaryLine line(PAJE_DefineLinkType);
+    line.integer(get_id()).integer(father_->get_id()).integer(source->get_id()).integer(dest->get_id());
+    line.string(get_name()).write();
+    return;
+  }
   if (trace_format != simgrid::instr::TraceFormat::Paje)
     return;
   XBT_DEBUG("%s: event_type=%u, timestamp=%.*f", __func__, PAJE_DefineLinkType, TRACE_precision(), 0.);
   stream_ << PAJE_DefineLinkType << " " << get_id() << " " << father_->get_id() << " " << source->get_id();
   stream_ << " " << dest->get_id() << " " << get_name();
   XBT_DEBUG("Dump %s", stream_.str().c_str());
-  tracing_file << stream_.str() << std::endl;
+  tracing_file << stream_.str() << '\n';
 }
 
 Type* Type::by_name(const std::string& name)
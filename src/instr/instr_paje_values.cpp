@@ -7,7 +7,7 @@
 #include "src/instr/instr_private.hpp"
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY (instr_paje_values, instr, "Paje tracing event system (values)");
-extern std::ofstream tracing_file;
+extern simgrid::instr::TraceFile tracing_file;
 
 namespace simgrid {
 namespace instr {
@@ -17,6 +17,14 @@ EntityValue::EntityValue(const std::string& name, const std::string& color, Type
 
 void EntityValue::print()
 {
+  if (trace_format == simgrid::instr::TraceFormat::Binary) {
+    BinaryLine line(PAJE_DefineEntityValue);
+    line.integer(id_).integer(father_->get_id()).string(name_);
+    if (not color_.empty())
+      line.string("\"" + color_ + "\"");
+    line.write();
+    return;
+  }
   if (trace_format != simgrid::instr::TraceFormat::Paje)
     return;
   std::stringstream stream;
@@ -26,7 +34,7 @@ void EntityValue::print()
   if (not color_.empty())
     stream << " \"" << color_ << "\"";
   XBT_DEBUG("Dump %s", stream.str().c_str());
-  tracing_file << stream.str() << std::endl;
+  tracing_file << stream.str() << '\n';
 }
 
 }
@@ -10,10 +10,12 @@
 
 #include "simgrid/instr.h"
 #include "simgrid/s4u/Actor.hpp"
+#include "src/instr/instr_binary_trace.hpp"
 #include "src/instr/instr_paje_containers.hpp"
 #include "src/instr/instr_paje_events.hpp"
 #include "src/instr/instr_paje_types.hpp"
 #include "src/instr/instr_paje_values.hpp"
+#include "src/instr/instr_trace_file.hpp"
 #include "xbt/graph.h"
 
 #include <fstream>
@@ -35,8 +37,9 @@ namespace instr {
  *   - TI is a trick to reuse the tracing functions to generate a time independent trace during the execution. Such
  *     trace can easily be replayed with smpi_replay afterward. This trick should be removed and replaced by some code
  *     using the signal that we will create to cleanup the TRACING
+ *   - binary is a compact encoding of the paje format, that can be expanded back to paje (see instr_binary_trace.hpp)
  */
-enum class TraceFormat { Paje, /*TimeIndependent*/ Ti };
+enum class TraceFormat { Paje, /*TimeIndependent*/ Ti, Binary };
 extern TraceFormat trace_format;
 
 class TIData {
@@ -0,0 +1,170 @@
+/* Copyright (c) 2019. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#include "src/instr/instr_trace_file.hpp"
+#include "src/instr/instr_binary_trace.hpp"
+#include "xbt/asserts.h"
+#include "xbt/log.h"
+
+#include <cerrno>
+#include <cstring>
+
+XBT_LOG_NEW_DEFAULT_SUBCATEGORY(instr_trace_file, instr, "Output of the trace file");
+
+namespace simgrid {
+namespace instr {
+
+bool TraceFileBuffer::open(const std::string& filename, bool io_thread)
+{
+  close();
+  file_ = fopen(filename.c_str(), "w");
+  if (file_ == nullptr)
+    return false;
+  setvbuf(file_, nullptr, _IONBF, 0); // We already write by large blocks
+
+  block_.resize(BLOCK_SIZE);
+  setp(block_.data(), block_.data() + block_.size());
+  stopping_ = false;
+  if (io_thread)
+    io_thread_ = std::thread(&TraceFileBuffer::io_thread_main, this);
+  return true;
+}
+
+void TraceFileBuffer::close()
+{
+  if (file_ == nullptr)
+    return;
+  sync();
+  if (io_thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    cond_.notify_all();
+    io_thread_.join();
+  }
+  fclose(file_);
+  file_ = nullptr;
+  setp(nullptr, nullptr);
+  block_ = std::vector<char>();
+  free_blocks_.clear();
+}
+
+void TraceFileBuffer::write_block(const char* data, size_t size)
+{
+  size_t written = fwrite(data, 1, size, file_);
+  xbt_assert(written == size, "Cannot write the trace file: %s", strerror(errno));
+}
+
+/** Writes the content of the current block, or hands it to the I/O thread (once it caught up) and takes an empty one */
+void TraceFileBuffer::submit_block()
+{
+  size_t size = pptr() - pbase();
+  if (size == 0)
+    return;
+
+  if (not io_thread_.joinable()) {
+    write_block(pbase(), size);
+  } else {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this]() { return full_blocks_.size() < MAX_FULL_BLOCKS; });
+    block_.resize(size);
+    full_blocks_.push_back(std::move(block_));
+    if (free_blocks_.empty()) {
+      block_ = std::vector<char>();
+    } else {
+      block_ = std::move(free_blocks_.back());
+      free_blocks_.pop_back();
+    }
+    lock.unlock();
+    cond_.notify_all();
+    block_.resize(BLOCK_SIZE);
+  }
+  setp(block_.data(), block_.data() + block_.size());
+}
+
+void TraceFileBuffer::io_thread_main()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cond_.wait(lock, [this]() { return stopping_ || not full_blocks_.empty(); });
+    if (full_blocks_.empty()) // stopping
+      return;
+    std::vector<char> block = std::move(full_blocks_.front());
+    full_blocks_.pop_front();
+    writing_ = true;
+    lock.unlock();
+
+    write_block(block.data(), block.size());
+
+    lock.lock();
+    writing_ = false;
+    free_blocks_.push_back(std::move(block));
+    cond_.notify_all();
+  }
+}
+
+TraceFileBuffer::int_type TraceFileBuffer::overflow(int_type ch)
+{
+  if (file_ == nullptr)
+    return traits_type::eof();
+  submit_block();
+  if (not traits_type::eq_int_type(ch, traits_type::eof())) {
+    *pptr() = traits_type::to_char_type(ch);
+    pbump(1);
+  }
+  return traits_type::not_eof(ch);
+}
+
+/** Writes everything to the file, waiting for the I/O thread if needed */
+int TraceFileBuffer::sync()
+{
+  if (file_ == nullptr)
+    return 0;
+  submit_block();
+  if (io_thread_.joinable()) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this]() { return full_blocks_.empty() && not writing_; });
+  }
+  return fflush(file_) == 0 ? 0 : -1;
+}
+
+void TraceFile::open(const std::string& filename, bool io_thread, bool binary)
+{
+  close();
+  if (not buffer_.open(filename, io_thread)) {
+    setstate(std::ios_base::failbit);
+    return;
+  }
+  binary_ = binary;
+  rdbuf(binary ? static_cast<std::streambuf*>(&text_) : &buffer_); // also clears the state
+}
+
+void TraceFile::flush_text()
+{
+  if (text_.pubseekoff(0, std::ios_base::cur, std::ios_base::out) <= 0) // nothing written since the last call
+    return;
+  std::string raw = TRACE_binary_raw(text_.str());
+  buffer_.sputn(raw.data(), raw.size());
+  text_.str("");
+}
+
+void TraceFile::write_record(const std::string& record)
+{
+  flush_text();
+  buffer_.sputn(record.data(), record.size());
+}
+
+void TraceFile::close()
+{
+  if (binary_) {
+    flush_text();
+    binary_ = false;
+    rdbuf(&buffer_);
+  }
+  buffer_.close();
+}
+} // namespace instr
+} // namespace simgrid
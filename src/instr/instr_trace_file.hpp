@@ -0,0 +1,93 @@
+/* Copyright (c) 2019. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#ifndef INSTR_TRACE_FILE_HPP
+#define INSTR_TRACE_FILE_HPP
+
+#include <xbt/base.h>
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace simgrid {
+namespace instr {
+
+/** @brief Stream buffer writing the trace file by large blocks
+ *
+ * The events are formatted directly into the current block, which is written to the file once full (or when the
+ * stream is flushed). If the I/O thread is enabled, the full blocks are written by that thread while the simulation
+ * fills the next ones, and the written blocks are recycled. The simulation waits for the I/O thread when too many
+ * blocks are queued, so that the memory stays bounded when the disk is slower than the simulation.
+ */
+class XBT_PRIVATE TraceFileBuffer : public std::streambuf {
+  static constexpr size_t BLOCK_SIZE      = 1 << 20;
+  static constexpr size_t MAX_FULL_BLOCKS = 4;
+
+  FILE* file_ = nullptr;
+  std::vector<char> block_;
+
+  std::thread io_thread_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::deque<std::vector<char>> full_blocks_;
+  std::vector<std::vector<char>> free_blocks_;
+  bool writing_  = false;
+  bool stopping_ = false;
+
+  void write_block(const char* data, size_t size);
+  void submit_block();
+  void io_thread_main();
+
+protected:
+  int_type overflow(int_type ch) override;
+  int sync() override;
+
+public:
+  TraceFileBuffer() = default;
+  TraceFileBuffer(const TraceFileBuffer&) = delete;
+  TraceFileBuffer& operator=(const TraceFileBuffer&) = delete;
+  ~TraceFileBuffer() override { close(); }
+
+  bool open(const std::string& filename, bool io_thread);
+  bool is_open() const { return file_ != nullptr; }
+  void close();
+};
+
+/** @brief Output stream of the trace file (see TraceFileBuffer)
+ *
+ * In binary mode (see instr_binary_trace.hpp), the text written to the stream is kept aside, and wrapped into a raw
+ * record before the next record written with write_record().
+ */
+class XBT_PRIVATE TraceFile : public std::ostream {
+  TraceFileBuffer buffer_;
+  std::stringbuf text_;
+  bool binary_ = false;
+
+  void flush_text();
+
+public:
+  TraceFile() : std::ostream(&buffer_) {}
+  TraceFile(const TraceFile&) = delete;
+  TraceFile& operator=(const TraceFile&) = delete;
+  ~TraceFile() override { close(); }
+
+  void open(const std::string& filename, bool io_thread, bool binary = false);
+  bool is_open() const { return buffer_.is_open(); }
+  bool is_binary() const { return binary_; }
+  void write_record(const std::string& record);
+  void close();
+};
+} // namespace instr
+} // namespace simgrid
+
+#endif
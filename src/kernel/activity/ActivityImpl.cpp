@@ -24,6 +24,35 @@ void ActivityImpl::register_simcall(smx_simcall_t simcall)
   simcall->issuer_->waiting_synchro = this;
 }
 
+void WaitanyRegistration::attach(smx_simcall_t simcall, ActivityImpl* activity, int rank)
+{
+  entries_.push_back({activity, activity->simcalls_.insert(activity->simcalls_.end(), simcall), rank});
+}
+
+void WaitanyRegistration::detach()
+{
+  for (auto const& entry : entries_)
+    entry.activity->simcalls_.erase(entry.position);
+  entries_.clear();
+}
+
+int WaitanyRegistration::complete(const ActivityImpl* activity)
+{
+  // If the activity appears several times in the array, it answers through its first entry (that is also the first
+  // one in its list). That entry is already gone from the list.
+  bool answered = false;
+  for (auto const& entry : entries_) {
+    if (not answered && entry.activity == activity) {
+      answered = true;
+      rank_    = entry.rank;
+    } else {
+      entry.activity->simcalls_.erase(entry.position);
+    }
+  }
+  entries_.clear();
+  return rank_;
+}
+
 void ActivityImpl::clean_action()
 {
   if (surf_action_) {
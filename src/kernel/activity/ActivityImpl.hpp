@@ -8,6 +8,7 @@
 
 #include <string>
 #include <list>
+#include <vector>
 
 #include <xbt/base.h>
 #include "simgrid/forward.h"
@@ -49,6 +50,40 @@ public:
   static xbt::signal<void(ActivityImpl const&)> on_resumed;
 };
 
+/** @brief Bookkeeping of a waitany (or testany) simcall on the activities that it involves
+ *
+ * The simcall is added to the simcalls_ list of each activity, and the registration remembers where, along with the
+ * rank of the activity in the array given to the simcall. When one of these activities completes, the simcall is thus
+ * removed from the other ones without searching their lists, and the rank of the completed activity is known without
+ * searching the array.
+ */
+class XBT_PUBLIC WaitanyRegistration {
+  struct Entry {
+    ActivityImpl* activity;
+    std::list<smx_simcall_t>::iterator position;
+    int rank;
+  };
+  std::vector<Entry> entries_;
+  int rank_ = -1;
+
+public:
+  /** Forgets the previous simcall (the entries are expected to be already detached) */
+  void reset()
+  {
+    entries_.clear();
+    rank_ = -1;
+  }
+  /** Adds the simcall to the waiting list of the activity, that is at the given rank in the array of the simcall */
+  void attach(smx_simcall_t simcall, ActivityImpl* activity, int rank);
+  /** Removes the simcall from all the activities (when the simcall times out) */
+  void detach();
+  /** Called by an activity answering the simcall, once it removed that simcall from its own list: removes the simcall
+   * from all the other activities, and returns the rank of the answering activity */
+  int complete(const ActivityImpl* activity);
+  /** Rank of the activity that answered the simcall, or -1 */
+  int get_rank() const { return rank_; }
+};
+
 template <class AnyActivityImpl> class ActivityImpl_T : public ActivityImpl {
 private:
   std::string name_             = "";
@@ -15,7 +15,6 @@
 #include "src/surf/network_interface.hpp"
 #include "src/surf/surf_interface.hpp"
 
-#include <boost/range/algorithm.hpp>
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(simix_network, simix, "SIMIX network-related synchronization");
 
 XBT_PRIVATE void simcall_HANDLER_comm_send(smx_simcall_t simcall, smx_actor_t src, smx_mailbox_t mbox, double task_size,
@@ -259,7 +258,8 @@ void simcall_HANDLER_comm_testany(smx_simcall_t simcall, simgrid::kernel::activi
     } else {
       simgrid::kernel::activity::CommImpl* comm = comms[idx];
       simcall_comm_testany__set__result(simcall, idx);
-      comm->simcalls_.push_back(simcall);
+      simcall->issuer_->waitany_registration.reset();
+      simcall->issuer_->waitany_registration.attach(simcall, comm, idx);
       comm->state_ = SIMIX_DONE;
       comm->finish();
     }
@@ -270,7 +270,8 @@ void simcall_HANDLER_comm_testany(smx_simcall_t simcall, simgrid::kernel::activi
     simgrid::kernel::activity::CommImpl* comm = comms[i];
     if (comm->state_ != SIMIX_WAITING && comm->state_ != SIMIX_RUNNING) {
       simcall_comm_testany__set__result(simcall, i);
-      comm->simcalls_.push_back(simcall);
+      simcall->issuer_->waitany_registration.reset();
+      simcall->issuer_->waitany_registration.attach(simcall, comm, i);
       comm->finish();
       return;
     }
@@ -278,19 +279,6 @@ void simcall_HANDLER_comm_testany(smx_simcall_t simcall, simgrid::kernel::activi
   simcall->issuer_->simcall_answer();
 }
 
-static void SIMIX_waitany_remove_simcall_from_actions(smx_simcall_t simcall)
-{
-  simgrid::kernel::activity::CommImpl** comms = simcall_comm_waitany__get__comms(simcall);
-  size_t count                                = simcall_comm_waitany__get__count(simcall);
-
-  for (size_t i = 0; i < count; i++) {
-    // Remove the first occurence of simcall:
-    auto* comm = comms[i];
-    auto j     = boost::range::find(comm->simcalls_, simcall);
-    if (j != comm->simcalls_.end())
-      comm->simcalls_.erase(j);
-  }
-}
 void simcall_HANDLER_comm_waitany(smx_simcall_t simcall, simgrid::kernel::activity::CommImpl* comms[], size_t count,
                                   double timeout)
 {
@@ -299,18 +287,21 @@ void simcall_HANDLER_comm_waitany(smx_simcall_t simcall, simgrid::kernel::activi
       xbt_die("Timeout not implemented for waitany in the model-checker");
     int idx                 = SIMCALL_GET_MC_VALUE(*simcall);
     auto* comm              = comms[idx];
-    comm->simcalls_.push_back(simcall);
+    simcall->issuer_->waitany_registration.reset();
+    simcall->issuer_->waitany_registration.attach(simcall, comm, idx);
     simcall_comm_waitany__set__result(simcall, idx);
     comm->state_ = SIMIX_DONE;
     comm->finish();
     return;
   }
 
+  simgrid::kernel::activity::WaitanyRegistration& registration = simcall->issuer_->waitany_registration;
+  registration.reset();
   if (timeout < 0.0) {
     simcall->timeout_cb_ = NULL;
   } else {
-    simcall->timeout_cb_ = simgrid::simix::Timer::set(SIMIX_get_clock() + timeout, [simcall]() {
-      SIMIX_waitany_remove_simcall_from_actions(simcall);
+    simcall->timeout_cb_ = simgrid::simix::Timer::set(SIMIX_get_clock() + timeout, [simcall, &registration]() {
+      registration.detach();
       simcall_comm_waitany__set__result(simcall, -1);
       simcall->issuer_->simcall_answer();
     });
@@ -319,7 +310,7 @@ void simcall_HANDLER_comm_waitany(smx_simcall_t simcall, simgrid::kernel::activi
   for (size_t i = 0; i < count; i++) {
     /* associate this simcall to the the synchro */
     auto* comm = comms[i];
-    comm->simcalls_.push_back(simcall);
+    registration.attach(simcall, comm, i);
 
     /* see if the synchro is already finished */
     if (comm->state_ != SIMIX_WAITING && comm->state_ != SIMIX_RUNNING) {
@@ -581,18 +572,15 @@ void CommImpl::finish()
     if (simcall->call_ == SIMCALL_NONE) // FIXME: maybe a better way to handle this case
       continue;                         // if actor handling comm is killed
     if (simcall->call_ == SIMCALL_COMM_WAITANY) {
-      SIMIX_waitany_remove_simcall_from_actions(simcall);
+      int rank = simcall->issuer_->waitany_registration.complete(this);
       if (simcall->timeout_cb_) {
         simcall->timeout_cb_->remove();
         simcall->timeout_cb_ = nullptr;
       }
-      if (not MC_is_active() && not MC_record_replay_is_active()) {
-        CommImpl** comms   = simcall_comm_waitany__get__comms(simcall);
-        size_t count       = simcall_comm_waitany__get__count(simcall);
-        CommImpl** element = std::find(comms, comms + count, this);
-        int rank           = (element != comms + count) ? element - comms : -1;
+      if (not MC_is_active() && not MC_record_replay_is_active())
         simcall_comm_waitany__set__result(simcall, rank);
-      }
+    } else if (simcall->call_ == SIMCALL_COMM_TESTANY) {
+      simcall->issuer_->waitany_registration.complete(this);
     }
 
     /* If the synchro is still in a rendez-vous point then remove from it */
@@ -674,18 +662,7 @@ void CommImpl::finish()
     if (simcall->issuer_->exception_ &&
         (simcall->call_ == SIMCALL_COMM_WAITANY || simcall->call_ == SIMCALL_COMM_TESTANY)) {
       // First retrieve the rank of our failing synchro
-      CommImpl** comms;
-      size_t count;
-      if (simcall->call_ == SIMCALL_COMM_WAITANY) {
-        comms = simcall_comm_waitany__get__comms(simcall);
-        count = simcall_comm_waitany__get__count(simcall);
-      } else {
-        /* simcall->call_ == SIMCALL_COMM_TESTANY */
-        comms = simcall_comm_testany__get__comms(simcall);
-        count = simcall_comm_testany__get__count(simcall);
-      }
-      CommImpl** element = std::find(comms, comms + count, this);
-      int rank           = (element != comms + count) ? element - comms : -1;
+      int rank = simcall->issuer_->waitany_registration.get_rank();
 
       // In order to modify the exception we have to rethrow it:
       try {
@@ -13,7 +13,6 @@
 
 #include "simgrid/s4u/Host.hpp"
 
-#include <boost/range/algorithm.hpp>
 
 XBT_LOG_EXTERNAL_DEFAULT_CATEGORY(simix_process);
 
@@ -51,17 +50,13 @@ void simcall_HANDLER_execution_test(smx_simcall_t simcall, simgrid::kernel::acti
 void simcall_HANDLER_execution_waitany_for(smx_simcall_t simcall, simgrid::kernel::activity::ExecImpl* execs[],
                                            size_t count, double timeout)
 {
+  simgrid::kernel::activity::WaitanyRegistration& registration = simcall->issuer_->waitany_registration;
+  registration.reset();
   if (timeout < 0.0) {
     simcall->timeout_cb_ = nullptr;
   } else {
-    simcall->timeout_cb_ = simgrid::simix::Timer::set(SIMIX_get_clock() + timeout, [simcall, execs, count]() {
-      for (size_t i = 0; i < count; i++) {
-        // Remove the first occurence of simcall:
-        auto* exec = execs[i];
-        auto j     = boost::range::find(exec->simcalls_, simcall);
-        if (j != exec->simcalls_.end())
-          exec->simcalls_.erase(j);
-      }
+    simcall->timeout_cb_ = simgrid::simix::Timer::set(SIMIX_get_clock() + timeout, [simcall, &registration]() {
+      registration.detach();
       simcall_execution_waitany_for__set__result(simcall, -1);
       simcall->issuer_->simcall_answer();
     });
@@ -70,7 +65,7 @@ void simcall_HANDLER_execution_waitany_for(smx_simcall_t simcall, simgrid::kerne
   for (size_t i = 0; i < count; i++) {
     /* associate this simcall to the the synchro */
     auto* exec = execs[i];
-    exec->simcalls_.push_back(simcall);
+    registration.attach(simcall, exec, i);
 
     /* see if the synchro is already finished */
     if (exec->state_ != SIMIX_WAITING && exec->state_ != SIMIX_RUNNING) {
@@ -221,27 +216,13 @@ void ExecImpl::finish()
     if (simcall->call_ == SIMCALL_NONE) // FIXME: maybe a better way to handle this case
       continue;                        // if process handling comm is killed
     if (simcall->call_ == SIMCALL_EXECUTION_WAITANY_FOR) {
-      simgrid::kernel::activity::ExecImpl** execs = simcall_execution_waitany_for__get__execs(simcall);
-      size_t count                                = simcall_execution_waitany_for__get__count(simcall);
-
-      for (size_t i = 0; i < count; i++) {
-        // Remove the first occurence of simcall:
-        auto* exec = execs[i];
-        auto j     = boost::range::find(exec->simcalls_, simcall);
-        if (j != exec->simcalls_.end())
-          exec->simcalls_.erase(j);
-
-        if (simcall->timeout_cb_) {
-          simcall->timeout_cb_->remove();
-          simcall->timeout_cb_ = nullptr;
-        }
+      int rank = simcall->issuer_->waitany_registration.complete(this);
+      if (simcall->timeout_cb_) {
+        simcall->timeout_cb_->remove();
+        simcall->timeout_cb_ = nullptr;
       }
-
-      if (not MC_is_active() && not MC_record_replay_is_active()) {
-        ExecImpl** element = std::find(execs, execs + count, this);
-        int rank           = (element != execs + count) ? element - execs : -1;
+      if (not MC_is_active() && not MC_record_replay_is_active())
         simcall_execution_waitany_for__set__result(simcall, rank);
-      }
     }
 
     switch (state_) {
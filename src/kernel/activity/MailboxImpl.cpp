@@ -6,11 +6,25 @@
 #include "src/kernel/activity/MailboxImpl.hpp"
 #include "src/kernel/activity/CommImpl.hpp"
 
+#include <iterator>
+#include <map>
 #include <unordered_map>
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(simix_mailbox, simix, "Mailbox implementation");
 
+using match_fun_t     = int (*)(void*, void*, simgrid::kernel::activity::CommImpl*);
+using match_key_fun_t = bool (*)(void*, size_t*);
+
 static std::unordered_map<std::string, smx_mailbox_t> mailboxes;
+static std::map<match_fun_t, match_key_fun_t> match_key_funs;
+
+static match_key_fun_t get_match_key_fun(match_fun_t match_fun)
+{
+  if (match_fun == nullptr)
+    return nullptr;
+  auto key_fun = match_key_funs.find(match_fun);
+  return key_fun == match_key_funs.end() ? nullptr : key_fun->second;
+}
 
 void SIMIX_mailbox_exit()
 {
@@ -26,6 +40,28 @@ void SIMIX_mailbox_exit()
 namespace simgrid {
 namespace kernel {
 namespace activity {
+/** @brief Removes a comm from its queue, or only detaches it from its mailbox if remove is false */
+template <class Queue> static CommImplPtr take_comm(Queue& queue, typename Queue::iterator it, bool remove)
+{
+  CommImplPtr comm = *it;
+  XBT_DEBUG("Found a matching communication synchro %p", comm.get());
+#if SIMGRID_HAVE_MC
+  comm->mbox_cpy = comm->get_mailbox();
+#endif
+  comm->set_mailbox(nullptr);
+  if (remove)
+    queue.erase(it);
+  return comm;
+}
+
+void MailboxImpl::set_match_key_fun(match_fun_t match_fun, match_key_fun_t key_fun)
+{
+  if (key_fun != nullptr)
+    match_key_funs[match_fun] = key_fun;
+  else
+    match_key_funs.erase(match_fun);
+}
+
 /** @brief Returns the mailbox of that name, or nullptr */
 MailboxImpl* MailboxImpl::by_name_or_null(const std::string& name)
 {
@@ -66,6 +102,11 @@ void MailboxImpl::push(CommImplPtr comm)
 {
   comm->set_mailbox(this);
   this->comm_queue_.push_back(std::move(comm));
+  if (indexed_) {
+    auto it = std::prev(comm_queue_.end());
+    index_positions_.emplace(it->get(), IndexPosition{it, index_next_rank_++, nullptr, 0});
+    index_pending_.push_back(it->get());
+  }
 }
 
 /** @brief Removes a communication activity from a mailbox
@@ -77,6 +118,14 @@ void MailboxImpl::remove(const CommImplPtr& comm)
              (comm->get_mailbox() ? comm->get_mailbox()->get_cname() : "(null)"), this->get_cname());
 
   comm->set_mailbox(nullptr);
+  if (indexed_) {
+    auto pos = index_positions_.find(comm.get());
+    xbt_assert(pos != index_positions_.end(), "Comm %p not found in mailbox %s", comm.get(), this->get_cname());
+    auto it = pos->second.it;
+    index_erase(comm.get());
+    this->comm_queue_.erase(it);
+    return;
+  }
   for (auto it = this->comm_queue_.begin(); it != this->comm_queue_.end(); it++)
     if (*it == comm) {
       this->comm_queue_.erase(it);
@@ -126,36 +175,117 @@ CommImplPtr MailboxImpl::find_matching_comm(CommImpl::Type type, int (*match_fun
                                             void* this_user_data, const CommImplPtr& my_synchro, bool done,
                                             bool remove_matching)
 {
-  void* other_user_data = nullptr;
-  auto& comm_queue      = done ? done_comm_queue_ : comm_queue_;
-
-  for (auto it = comm_queue.begin(); it != comm_queue.end(); it++) {
-    CommImplPtr& comm = *it;
-
+  auto matches = [type, match_fun, this_user_data, &my_synchro](CommImpl* comm) {
+    void* other_user_data = nullptr;
     if (comm->type_ == CommImpl::Type::SEND) {
       other_user_data = comm->src_data_;
     } else if (comm->type_ == CommImpl::Type::RECEIVE) {
       other_user_data = comm->dst_data_;
     }
-    if (comm->type_ == type && (match_fun == nullptr || match_fun(this_user_data, other_user_data, comm.get())) &&
-        (not comm->match_fun || comm->match_fun(other_user_data, this_user_data, my_synchro.get()))) {
-      XBT_DEBUG("Found a matching communication synchro %p", comm.get());
-#if SIMGRID_HAVE_MC
-      comm->mbox_cpy = comm->get_mailbox();
-#endif
-      comm->set_mailbox(nullptr);
-      CommImplPtr comm_cpy = comm;
-      if (remove_matching)
-        comm_queue.erase(it);
-      return comm_cpy;
-    }
+    if (comm->type_ == type && (match_fun == nullptr || match_fun(this_user_data, other_user_data, comm)) &&
+        (not comm->match_fun || comm->match_fun(other_user_data, this_user_data, my_synchro.get())))
+      return true;
     XBT_DEBUG("Sorry, communication synchro %p does not match our needs:"
               " its type is %d but we are looking for a comm of type %d (or maybe the filtering didn't match)",
-              comm.get(), (int)comm->type_, (int)type);
+              comm, (int)comm->type_, (int)type);
+    return false;
+  };
+
+  if (done) {
+    for (auto it = done_comm_queue_.begin(); it != done_comm_queue_.end(); it++)
+      if (matches(it->get()))
+        return take_comm(done_comm_queue_, it, remove_matching);
+    XBT_DEBUG("No matching communication synchro found");
+    return nullptr;
+  }
+
+  match_key_fun_t key_fun = get_match_key_fun(match_fun);
+  if (key_fun != nullptr && not indexed_)
+    index_build();
+  if (indexed_)
+    index_flush();
+
+  size_t key;
+  if (indexed_ && key_fun != nullptr && (index_key_fun_ == nullptr || index_key_fun_ == key_fun) &&
+      key_fun(this_user_data, &key)) {
+    /* Only the comms of our bucket and the wildcards may match: test them in the queue order */
+    static const std::map<unsigned long, CommImpl*> no_bucket;
+    auto bucket       = index_buckets_.find(key);
+    const auto& keyed = bucket == index_buckets_.end() ? no_bucket : bucket->second;
+    auto k            = keyed.begin();
+    auto w            = index_wildcards_.begin();
+    while (k != keyed.end() || w != index_wildcards_.end()) {
+      CommImpl* comm;
+      if (w == index_wildcards_.end() || (k != keyed.end() && k->first < w->first))
+        comm = (k++)->second;
+      else
+        comm = (w++)->second;
+      if (matches(comm)) {
+        auto it = index_positions_.at(comm).it;
+        if (remove_matching)
+          index_erase(comm);
+        return take_comm(comm_queue_, it, remove_matching);
+      }
+    }
+  } else {
+    for (auto it = comm_queue_.begin(); it != comm_queue_.end(); it++)
+      if (matches(it->get())) {
+        if (remove_matching && indexed_)
+          index_erase(it->get());
+        return take_comm(comm_queue_, it, remove_matching);
+      }
   }
   XBT_DEBUG("No matching communication synchro found");
   return nullptr;
 }
+
+/** @brief Starts indexing the comm queue */
+void MailboxImpl::index_build()
+{
+  XBT_DEBUG("Indexing the %zu comms of mailbox %s", comm_queue_.size(), get_cname());
+  indexed_ = true;
+  for (auto it = comm_queue_.begin(); it != comm_queue_.end(); it++) {
+    index_positions_.emplace(it->get(), IndexPosition{it, index_next_rank_++, nullptr, 0});
+    index_pending_.push_back(it->get());
+  }
+}
+
+/** @brief Adds the pending comms to their bucket, now that their match data is known */
+void MailboxImpl::index_flush()
+{
+  for (CommImpl* comm : index_pending_) {
+    auto pos = index_positions_.find(comm);
+    if (pos == index_positions_.end() || pos->second.bucket != nullptr) // Removed before being indexed
+      continue;
+    IndexPosition& position = pos->second;
+    void* data              = comm->type_ == CommImpl::Type::SEND ? comm->src_data_ : comm->dst_data_;
+    match_key_fun_t key_fun = get_match_key_fun(comm->match_fun);
+    if (key_fun != nullptr && (index_key_fun_ == nullptr || index_key_fun_ == key_fun) &&
+        key_fun(data, &position.key)) {
+      index_key_fun_  = key_fun;
+      position.bucket = &index_buckets_[position.key];
+    } else {
+      position.bucket = &index_wildcards_;
+    }
+    position.bucket->emplace(position.rank, comm);
+  }
+  index_pending_.clear();
+}
+
+/** @brief Removes a comm from the index (but not from the queue) */
+void MailboxImpl::index_erase(const CommImpl* comm)
+{
+  auto pos = index_positions_.find(comm);
+  if (pos == index_positions_.end())
+    return;
+  const IndexPosition& position = pos->second;
+  if (position.bucket != nullptr) {
+    position.bucket->erase(position.rank);
+    if (position.bucket != &index_wildcards_ && position.bucket->empty())
+      index_buckets_.erase(position.key);
+  }
+  index_positions_.erase(pos);
+}
 } // namespace activity
 } // namespace kernel
 } // namespace simgrid
@@ -9,6 +9,11 @@
 #include <boost/circular_buffer.hpp>
 #include <xbt/string.hpp>
 
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
 #include "simgrid/s4u/Mailbox.hpp"
 #include "src/kernel/activity/CommImpl.hpp"
 #include "src/kernel/actor/ActorImpl.hpp"
@@ -29,12 +34,37 @@ class MailboxImpl {
   friend s4u::Mailbox* s4u::Mailbox::by_name(const std::string& name);
   friend mc::CommunicationDeterminismChecker;
 
-  explicit MailboxImpl(const std::string& name)
-      : piface_(this), name_(name), comm_queue_(MAX_MAILBOX_SIZE), done_comm_queue_(MAX_MAILBOX_SIZE)
-  {
-  }
+  explicit MailboxImpl(const std::string& name) : piface_(this), name_(name), done_comm_queue_(MAX_MAILBOX_SIZE) {}
+
+  /* Index of comm_queue_, to only test the queued comms that may match a given search instead of all of them.
+   * It is built on the first search done with a match function that provides keys (see set_match_key_fun), and the
+   * comms are only added to the index on the next search, since their match data is set after the push. */
+  struct IndexPosition {
+    std::list<CommImplPtr>::iterator it;
+    unsigned long rank; // Position of the comm in the queue, to merge the buckets in the queue order
+    std::map<unsigned long, CommImpl*>* bucket; // nullptr while the comm is pending
+    size_t key;
+  };
+  bool indexed_                          = false;
+  bool (*index_key_fun_)(void*, size_t*) = nullptr;
+  unsigned long index_next_rank_         = 0;
+  std::unordered_map<size_t, std::map<unsigned long, CommImpl*>> index_buckets_;
+  std::map<unsigned long, CommImpl*> index_wildcards_; // comms that may match several keys
+  std::unordered_map<const CommImpl*, IndexPosition> index_positions_;
+  std::vector<CommImpl*> index_pending_;
+
+  void index_build();
+  void index_flush();
+  void index_erase(const CommImpl* comm);
 
 public:
+  /** @brief Declares how to compute the matching keys of the comms filtered by the given match function
+   *
+   * The key function computes the key of the data that is passed to the match function. Two comms can only match if
+   * their keys are equal, unless the key function returns false for one of them (wildcard). This lets the mailboxes
+   * skip the comms that cannot match a given search, instead of testing all of them in the queue order. */
+  static void set_match_key_fun(int (*match_fun)(void*, void*, CommImpl*), bool (*key_fun)(void* data, size_t* key));
+
   const xbt::string& get_name() const { return name_; }
   const char* get_cname() const { return name_.c_str(); }
   static MailboxImpl* by_name_or_null(const std::string& name);
@@ -47,7 +77,7 @@ public:
                                  const CommImplPtr& my_synchro, bool done, bool remove_matching);
 
   actor::ActorImplPtr permanent_receiver_; // actor to which the mailbox is attached
-  boost::circular_buffer_space_optimized<CommImplPtr> comm_queue_;
+  std::list<CommImplPtr> comm_queue_;
   boost::circular_buffer_space_optimized<CommImplPtr> done_comm_queue_; // messages already received in the permanent
                                                                         // receive mode
 };
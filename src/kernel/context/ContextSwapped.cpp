@@ -167,12 +167,17 @@ void SwappedContextFactory::run_all()
     //     the control to the parmap. Instead, it uses parmap_->next() to steal another work, and does it directly.
     //     It only yields back to worker_context when the work array is exhausted.
     //   - So, resume() is only launched from the parmap for the first job of each minion.
-    parmap_->apply(
-        [](smx_actor_t process) {
-          SwappedContext* context = static_cast<SwappedContext*>(process->context_.get());
-          context->resume();
-        },
-        simix_global->actors_to_run);
+    //
+    // When the round is not worth it (see simix::RoundPolicy), maestro runs the actors alone instead of waking its
+    // minions.
+    auto resume_actor = [](smx_actor_t process) {
+      SwappedContext* context = static_cast<SwappedContext*>(process->context_.get());
+      context->resume();
+    };
+    if (simix_global->round_policy.is_parallel())
+      parmap_->apply(resume_actor, simix_global->actors_to_run);
+    else
+      parmap_->apply_inline(resume_actor, simix_global->actors_to_run);
   } else { // sequential execution
     if (simix_global->actors_to_run.empty())
       return;
@@ -4,6 +4,7 @@
  * under the terms of the license (GNU LGPL) which comes with this package. */
 
 #include "src/kernel/lmm/maxmin.hpp"
+#include "simgrid/sg_config.hpp"
 #include "src/surf/surf_interface.hpp"
 #include "xbt/backtrace.hpp"
 
@@ -13,6 +14,17 @@ double sg_maxmin_precision = 0.00001; /* Change this with --cfg=maxmin/precision
 double sg_surf_precision   = 0.00001; /* Change this with --cfg=surf/precision:VALUE */
 int sg_concurrency_limit   = -1;      /* Change this with --cfg=maxmin/concurrency-limit:VALUE */
 
+static simgrid::config::Flag<std::string> cfg_maxmin_solver(
+    "maxmin/solver", "Implementation of the max-min solver used by the CPU and network models", "Default",
+    std::map<std::string, std::string>({
+        {"Default", "Solver working directly on the intrusive lists of constraints, variables and elements."},
+        {"SoA", "Solver flattening the system into contiguous arrays before solving it. Same results, but faster on "
+                "large systems."},
+    }),
+    [](std::string const&) {
+      xbt_assert(_sg_cfg_init_status < 2, "Cannot change the max-min solver after the initialization");
+    });
+
 namespace simgrid {
 namespace kernel {
 namespace lmm {
@@ -24,6 +36,8 @@ int Constraint::next_rank_ = 1;
 
 System* make_new_maxmin_system(bool selective_update)
 {
+  if (cfg_maxmin_solver == "SoA")
+    return make_new_soa_maxmin_system(selective_update);
   return new System(selective_update);
 }
 
@@ -107,6 +121,7 @@ void System::var_free(Variable* var)
 {
   XBT_IN("(sys=%p, var=%p)", this, var);
   modified_ = true;
+  mark_dirty(var);
 
   // TODOLATER Can do better than that by leaving only the variable in only one enabled_element_set, call
   // update_modified_set, and then remove it..
@@ -183,6 +198,9 @@ Constraint::Constraint(resource::Resource* id_value, double bound_value) : bound
   lambda_     = 0.0;
   new_lambda_ = 0.0;
   cnst_light_ = nullptr;
+  soa_index_  = 0;
+  trace_id_   = 0;
+  dirty_      = true;
 }
 
 Constraint* System::constraint_new(resource::Resource* id, double bound_value)
@@ -233,7 +251,8 @@ void System::variable_free_all()
 
 void System::expand(Constraint* cnst, Variable* var, double consumption_weight)
 {
-  modified_ = true;
+  modified_    = true;
+  cnst->dirty_ = true;
 
   // Check if this variable already has an active element in this constraint
   // If it does, substract it from the required slack
@@ -286,7 +305,8 @@ void System::expand(Constraint* cnst, Variable* var, double consumption_weight)
 
 void System::expand_add(Constraint* cnst, Variable* var, double value)
 {
-  modified_ = true;
+  modified_    = true;
+  cnst->dirty_ = true;
 
   check_concurrency();
 
@@ -704,6 +724,7 @@ void System::update_variable_bound(Variable* var, double bound)
 {
   modified_  = true;
   var->bound_ = bound;
+  mark_dirty(var);
 
   if (not var->cnsts_.empty())
     update_modified_set(var->cnsts_[0].constraint);
@@ -722,6 +743,7 @@ void Variable::initialize(resource::Action* id_value, double sharing_penalty, do
   value_             = 0.0;
   visited_           = visited_value;
   mu_                = 0.0;
+  soa_index_         = 0;
 
   xbt_assert(not variable_set_hook_.is_linked());
   xbt_assert(not saturated_variable_set_hook_.is_linked());
@@ -752,6 +774,7 @@ void System::enable_var(Variable* var)
 
   var->sharing_penalty_ = var->staged_penalty_;
   var->staged_penalty_  = 0;
+  mark_dirty(var);
 
   // Enabling the variable, move var to list head. Subtlety is: here, we need to call update_modified_set AFTER
   // moving at least one element of var.
@@ -774,6 +797,7 @@ void System::enable_var(Variable* var)
 void System::disable_var(Variable* var)
 {
   xbt_assert(not var->staged_penalty_, "Staged penalty should have been cleared");
+  mark_dirty(var);
   // Disabling the variable, move to var to list tail. Subtlety is: here, we need to call update_modified_set
   // BEFORE moving the last element of var.
   simgrid::xbt::intrusive_erase(variable_set, *var);
@@ -856,6 +880,7 @@ void System::update_variable_penalty(Variable* var, double penalty)
   XBT_IN("(sys=%p, var=%p, penalty=%f)", this, var, penalty);
 
   modified_ = true;
+  mark_dirty(var);
 
   // Are we enabling this variable?
   if (enabling_var) {
@@ -882,7 +907,8 @@ void System::update_variable_penalty(Variable* var, double penalty)
 
 void System::update_constraint_bound(Constraint* cnst, double bound)
 {
-  modified_ = true;
+  modified_    = true;
+  cnst->dirty_ = true;
   update_modified_set(cnst);
   cnst->bound_ = bound;
 }
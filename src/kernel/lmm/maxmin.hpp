@@ -14,8 +14,16 @@
 #include <boost/intrusive/list.hpp>
 #include <cmath>
 #include <limits>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
+namespace simgrid {
+namespace xbt {
+template <typename T> class Parmap;
+}
+}
+
 namespace simgrid {
 namespace kernel {
 namespace lmm {
@@ -182,7 +190,11 @@ public:
   Constraint(resource::Resource* id_value, double bound_value);
 
   /** @brief Unshare a constraint. */
-  void unshare() { sharing_policy_ = s4u::Link::SharingPolicy::FATPIPE; }
+  void unshare()
+  {
+    sharing_policy_ = s4u::Link::SharingPolicy::FATPIPE;
+    dirty_          = true;
+  }
 
   /** @brief Check how a constraint is shared  */
   s4u::Link::SharingPolicy get_sharing_policy() const { return sharing_policy_; }
@@ -273,6 +285,9 @@ public:
   double lambda_;
   double new_lambda_;
   ConstraintLight* cnst_light_;
+  unsigned soa_index_; /* used by SoAMaxMin to locate the constraint in its arrays */
+  unsigned trace_id_;  /* used by SoAMaxMin to retrieve how the constraint got saturated in the previous rounds */
+  bool dirty_;         /* whether the constraint or one of its variables changed since the last resolution */
 
 private:
   static int next_rank_;  // To give a separate rank_ to each contraint
@@ -359,6 +374,7 @@ public:
   int rank_;         // Only used in debug messages to identify the variable
   unsigned visited_; /* used by System::update_modified_set() */
   double mu_;
+  unsigned soa_index_; /* used by SoAMaxMin to locate the variable in its arrays */
 
 private:
   static int next_rank_; // To give a separate rank_ to each variable
@@ -494,6 +510,11 @@ private:
 
   void enable_var(Variable * var);
   void disable_var(Variable * var);
+  void mark_dirty(Variable * var)
+  {
+    for (Element& elem : var->cnsts_)
+      elem.constraint->dirty_ = true;
+  }
   void on_disabled_var(Constraint * cnstr);
 
   /**
@@ -507,10 +528,12 @@ private:
   void update_modified_set(Constraint * cnst);
   void update_modified_set_rec(Constraint * cnst);
 
+protected:
   /** @brief Remove all constraints of the modified_constraint_set. */
   void remove_all_modified_set();
   void check_concurrency() const;
 
+private:
   template <class CnstList> void lmm_solve(CnstList& cnst_list);
 
 public:
@@ -530,16 +553,18 @@ public:
 
   resource::Action::ModifiedSet* modified_set_ = nullptr;
 
-private:
+protected:
   bool selective_update_active; /* flag to update partially the system only selecting changed portions */
+  boost::intrusive::list<Constraint, boost::intrusive::member_hook<Constraint, boost::intrusive::list_member_hook<>,
+                                                                   &Constraint::modified_constraint_set_hook_>>
+      modified_constraint_set;
+
+private:
   unsigned visited_counter_ = 1; /* used by System::update_modified_set() and System::remove_all_modified_set() to
                                   * cleverly (un-)flag the constraints (more details in these functions) */
   boost::intrusive::list<Constraint, boost::intrusive::member_hook<Constraint, boost::intrusive::list_member_hook<>,
                                                                    &Constraint::constraint_set_hook_>>
       constraint_set;
-  boost::intrusive::list<Constraint, boost::intrusive::member_hook<Constraint, boost::intrusive::list_member_hook<>,
-                                                                   &Constraint::modified_constraint_set_hook_>>
-      modified_constraint_set;
   xbt_mallocator_t variable_mallocator_ =
       xbt_mallocator_new(65536, System::variable_mallocator_new_f, System::variable_mallocator_free_f, nullptr);
 };
@@ -553,8 +578,111 @@ private:
   void bottleneck_solve();
 };
 
+/**
+ * @brief Max-min solver working on a structure-of-arrays copy of the system
+ *
+ * Before each resolution, the constraints and variables to solve are flattened into contiguous arrays (remaining,
+ * usage, bound, penalty, ...) and elements are stored in compressed rows, both per constraint and per variable. The
+ * resolution itself then only walks these arrays instead of chasing the intrusive lists of the regular System, and
+ * the min-ratio search over saturating constraints is a simple loop over a dense array. Computed values are identical
+ * to the ones of System::lmm_solve(). The arrays are rebuilt on each resolution though, which usually costs more than
+ * what the resolution saves: this solver is mostly the basis of the maxmin/threads and maxmin/warm-start options.
+ *
+ * When maxmin/threads is larger than 1, the system is further split into its connected components (sets of
+ * constraints sharing no variable), which are solved concurrently. The values are then only equal up to the max-min
+ * precision, since the variables of each component get saturated in a slightly different order.
+ *
+ * When maxmin/warm-start is enabled, the system is also split in components, and the successive saturation rounds of
+ * each component (saturation level and saturated constraints) are recorded. On the next resolution, the rounds that
+ * only involve unchanged constraints are replayed without searching for the minimal ratio among all the saturable
+ * constraints, as long as no changed constraint could saturate first. The values are the same as without replay.
+ */
+class XBT_PUBLIC SoAMaxMin : public System {
+public:
+  explicit SoAMaxMin(bool selective_update);
+  ~SoAMaxMin();
+  void solve() final;
+
+  /** @brief Number of saturation rounds replayed from the previous resolutions so far (see maxmin/warm-start) */
+  unsigned long get_replayed_rounds() const { return replayed_rounds_; }
+
+private:
+  /** @brief Saturation rounds of a component: round r saturates cnsts[ends[r-1]..ends[r]) at level levels[r] */
+  struct Trace {
+    std::vector<double> levels;
+    std::vector<size_t> ends;
+    std::vector<Constraint*> cnsts;
+  };
+
+  /** @brief Independent part of the system, with the state of its saturation loop */
+  struct Component {
+    int num;
+    std::vector<unsigned> cnsts; // constraints to solve, in the order of the constraint list
+    std::vector<unsigned> light_cnst; // constraints that can still be saturated ...
+    std::vector<double> light_ratio;  // ... and their remaining/usage ratio
+    std::vector<unsigned> saturated_constraints;
+    std::vector<unsigned> saturated_variables;
+    std::vector<unsigned> dirty_cnst; // changed constraints that may saturate before the replayed ones
+    const Trace* replay    = nullptr; // rounds of the previous resolution, if they can be replayed
+    size_t replay_round    = 0;
+    size_t replayed_rounds = 0;
+    Trace trace; // rounds of this resolution
+  };
+
+  template <class CnstList> void soa_solve(CnstList& cnst_list);
+  unsigned add_constraint(Constraint* cnst);
+  unsigned add_variable(Variable* var);
+  unsigned find_root(unsigned cnst);
+  void split_components(size_t cnst_list_num);
+  Component& get_component(unsigned num);
+  void saturate(Component& comp);
+  void saturated_variables_update(Component& comp);
+  double select_saturated(Component& comp);
+  bool replay_round(Component& comp, double& min_usage);
+  void save_trace(Component& comp);
+
+  /* Per constraint */
+  std::vector<Constraint*> cnst_ptr_;
+  std::vector<double> cnst_remaining_;
+  std::vector<double> cnst_usage_;
+  std::vector<double> cnst_bound_;
+  std::vector<char> cnst_fatpipe_;
+  std::vector<int> cnst_light_pos_; // position in the light table of its component, or -1 if not saturable anymore
+  std::vector<int> cnst_active_;    // amount of active elements
+  std::vector<unsigned> cnst_elem_begin_;
+  std::vector<unsigned> cnst_parent_; // union-find forest used to split the system in components
+  std::vector<int> cnst_comp_;        // component of the constraint, or -1 if it is not to be solved
+
+  /* Per element, grouped by constraint (in the order of the enabled_element_set_) */
+  std::vector<unsigned> elem_var_;
+  std::vector<double> elem_weight_;
+  std::vector<char> elem_active_;
+
+  /* Per variable */
+  std::vector<Variable*> var_ptr_;
+  std::vector<double> var_penalty_;
+  std::vector<double> var_bound_;
+  std::vector<double> var_value_;
+  std::vector<char> var_saturated_;
+  std::vector<unsigned> var_elem_begin_;
+
+  /* Per element, grouped by variable (in the order of Variable::cnsts_) */
+  std::vector<unsigned> var_elem_cnst_;
+  std::vector<double> var_elem_weight_;
+  std::vector<int> var_elem_pos_; // position of the same element in the per-constraint arrays
+
+  std::vector<Component> components_; // only the components_num_ first ones are used in the current round
+  unsigned components_num_ = 0;
+  std::unique_ptr<xbt::Parmap<Component*>> parmap_;
+
+  std::unordered_map<unsigned, Trace> traces_; // indexed by Constraint::trace_id_
+  unsigned next_trace_id_        = 1;
+  unsigned long replayed_rounds_ = 0;
+};
+
 XBT_PUBLIC System* make_new_maxmin_system(bool selective_update);
 XBT_PUBLIC System* make_new_fair_bottleneck_system(bool selective_update);
+XBT_PUBLIC System* make_new_soa_maxmin_system(bool selective_update);
 
 /** @} */
 }
@@ -3,11 +3,15 @@
 /* This program is free software; you can redistribute it and/or modify it
  * under the terms of the license (GNU LGPL) which comes with this package. */
 
+#include "simgrid/s4u/Engine.hpp"
 #include "src/include/catch.hpp"
 #include "src/kernel/lmm/maxmin.hpp"
 #include "src/surf/surf_interface.hpp"
+#include "xbt/config.hpp"
 #include "xbt/log.h"
 
+#include <random>
+
 namespace lmm = simgrid::kernel::lmm;
 
 TEST_CASE("kernel::lmm Single constraint shared systems", "[kernel-lmm-shared-single-sys]")
@@ -288,3 +292,199 @@ TEST_CASE("kernel::lmm Single constraint unshared systems", "[kernel-lmm-unshare
   Sys->variable_free_all();
   delete Sys;
 }
+
+TEST_CASE("kernel::lmm SoA solver gives the same results", "[kernel-lmm-soa-sys]")
+{
+  /*
+   * Builds the same random systems (mixing shared and FATPIPE constraints, bounded and unbounded variables) in the
+   * regular solver and in the SoA one, and checks that the computed values are strictly identical.
+   */
+  lmm::System* Sys    = lmm::make_new_maxmin_system(false);
+  lmm::System* SoASys = lmm::make_new_soa_maxmin_system(false);
+
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> dist(1, 100);
+
+  const int nb_cnst = 50;
+  const int nb_var  = 200;
+  std::vector<lmm::Constraint*> cnsts;
+  std::vector<lmm::Constraint*> soa_cnsts;
+  for (int i = 0; i < nb_cnst; i++) {
+    double bound = dist(gen) * 10.0;
+    cnsts.push_back(Sys->constraint_new(nullptr, bound));
+    soa_cnsts.push_back(SoASys->constraint_new(nullptr, bound));
+    if (dist(gen) <= 20) {
+      cnsts.back()->unshare();
+      soa_cnsts.back()->unshare();
+    }
+  }
+
+  std::vector<lmm::Variable*> vars;
+  std::vector<lmm::Variable*> soa_vars;
+  for (int i = 0; i < nb_var; i++) {
+    double penalty = dist(gen) / 10.0;
+    double bound   = dist(gen) <= 30 ? dist(gen) : -1.0;
+    int nb_links   = 1 + dist(gen) % 4;
+    vars.push_back(Sys->variable_new(nullptr, penalty, bound, nb_links));
+    soa_vars.push_back(SoASys->variable_new(nullptr, penalty, bound, nb_links));
+    for (int j = 0; j < nb_links; j++) {
+      int cnst      = dist(gen) % nb_cnst;
+      double weight = dist(gen) <= 10 ? 0.05 : 1.0;
+      Sys->expand_add(cnsts[cnst], vars.back(), weight);
+      SoASys->expand_add(soa_cnsts[cnst], soa_vars.back(), weight);
+    }
+  }
+
+  Sys->solve();
+  SoASys->solve();
+  for (int i = 0; i < nb_var; i++)
+    REQUIRE(vars[i]->get_value() == soa_vars[i]->get_value());
+
+  SECTION("After updates")
+  {
+    for (int i = 0; i < nb_var; i += 7) {
+      Sys->update_variable_penalty(vars[i], 0.0);
+      SoASys->update_variable_penalty(soa_vars[i], 0.0);
+    }
+    for (int i = 0; i < nb_cnst; i += 5) {
+      Sys->update_constraint_bound(cnsts[i], cnsts[i]->bound_ / 2);
+      SoASys->update_constraint_bound(soa_cnsts[i], soa_cnsts[i]->bound_ / 2);
+    }
+    Sys->solve();
+    SoASys->solve();
+    for (int i = 0; i < nb_var; i++)
+      REQUIRE(vars[i]->get_value() == soa_vars[i]->get_value());
+  }
+
+  Sys->variable_free_all();
+  SoASys->variable_free_all();
+  delete Sys;
+  delete SoASys;
+}
+
+TEST_CASE("kernel::lmm SoA solver with warm start", "[kernel-lmm-soa-warm-start]")
+{
+  /*
+   * Solves a random system many times, changing only a few variables between consecutive resolutions, and checks that
+   * replaying the previous resolution gives the same values as the regular solver.
+   */
+  simgrid::config::set_value("maxmin/warm-start", true);
+  lmm::System* Sys    = lmm::make_new_maxmin_system(false);
+  lmm::System* SoASys = lmm::make_new_soa_maxmin_system(false);
+
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> dist(1, 100);
+
+  const int nb_cnst = 50;
+  std::vector<lmm::Constraint*> cnsts;
+  std::vector<lmm::Constraint*> soa_cnsts;
+  for (int i = 0; i < nb_cnst; i++) {
+    double bound = dist(gen) * 10.0;
+    cnsts.push_back(Sys->constraint_new(nullptr, bound));
+    soa_cnsts.push_back(SoASys->constraint_new(nullptr, bound));
+  }
+
+  std::vector<lmm::Variable*> vars;
+  std::vector<lmm::Variable*> soa_vars;
+  auto add_variable = [&]() {
+    double penalty = dist(gen) / 10.0;
+    double bound   = dist(gen) <= 30 ? dist(gen) : -1.0;
+    int nb_links   = 1 + dist(gen) % 2;
+    vars.push_back(Sys->variable_new(nullptr, penalty, bound, nb_links));
+    soa_vars.push_back(SoASys->variable_new(nullptr, penalty, bound, nb_links));
+    for (int j = 0; j < nb_links; j++) {
+      int cnst = dist(gen) % nb_cnst;
+      Sys->expand(cnsts[cnst], vars.back(), 1.0);
+      SoASys->expand(soa_cnsts[cnst], soa_vars.back(), 1.0);
+    }
+  };
+  for (int i = 0; i < 100; i++)
+    add_variable();
+
+  for (int round = 0; round < 20; round++) {
+    Sys->solve();
+    SoASys->solve();
+    for (unsigned i = 0; i < vars.size(); i++)
+      REQUIRE(double_equals(vars[i]->get_value(), soa_vars[i]->get_value(), sg_maxmin_precision));
+
+    // A flow ends, another one starts and a third one gets slowed down
+    int victim = dist(gen) % vars.size();
+    Sys->variable_free(vars[victim]);
+    SoASys->variable_free(soa_vars[victim]);
+    vars.erase(vars.begin() + victim);
+    soa_vars.erase(soa_vars.begin() + victim);
+    add_variable();
+    int slowed = dist(gen) % vars.size();
+    Sys->update_variable_bound(vars[slowed], 1.0);
+    SoASys->update_variable_bound(soa_vars[slowed], 1.0);
+  }
+
+  // Most of the system is unchanged between two resolutions: the previous rounds must have been replayed
+  REQUIRE(static_cast<lmm::SoAMaxMin*>(SoASys)->get_replayed_rounds() > 0);
+
+  Sys->variable_free_all();
+  SoASys->variable_free_all();
+  delete Sys;
+  delete SoASys;
+  simgrid::config::set_value("maxmin/warm-start", false);
+}
+
+TEST_CASE("kernel::lmm SoA solver with several threads", "[kernel-lmm-soa-threads]")
+{
+  /*
+   * Builds many small independent systems, so that they get solved concurrently, and checks that the values are the
+   * same as with the regular solver (up to the max-min precision, since the saturation order differs).
+   * The worker threads get their own execution context, so this needs an engine.
+   */
+  int argc     = 1;
+  char arg0[]  = "unit-tests";
+  char* argv[] = {arg0, nullptr};
+  simgrid::s4u::Engine e(&argc, argv);
+  simgrid::config::set_value("maxmin/threads", 4);
+  lmm::System* Sys    = lmm::make_new_maxmin_system(false);
+  lmm::System* SoASys = lmm::make_new_soa_maxmin_system(false);
+
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> dist(1, 100);
+
+  const int nb_parts = 20;
+  std::vector<lmm::Variable*> vars;
+  std::vector<lmm::Variable*> soa_vars;
+  for (int part = 0; part < nb_parts; part++) {
+    std::vector<lmm::Constraint*> cnsts;
+    std::vector<lmm::Constraint*> soa_cnsts;
+    for (int i = 0; i < 5; i++) {
+      double bound = dist(gen) * 10.0;
+      cnsts.push_back(Sys->constraint_new(nullptr, bound));
+      soa_cnsts.push_back(SoASys->constraint_new(nullptr, bound));
+    }
+    for (int i = 0; i < 10; i++) {
+      double penalty = dist(gen) / 10.0;
+      double bound   = dist(gen) <= 30 ? dist(gen) : -1.0;
+      vars.push_back(Sys->variable_new(nullptr, penalty, bound, 2));
+      soa_vars.push_back(SoASys->variable_new(nullptr, penalty, bound, 2));
+      for (int j = 0; j < 2; j++) {
+        int cnst = dist(gen) % cnsts.size();
+        Sys->expand_add(cnsts[cnst], vars.back(), 1.0);
+        SoASys->expand_add(soa_cnsts[cnst], soa_vars.back(), 1.0);
+      }
+    }
+  }
+
+  for (int round = 0; round < 3; round++) {
+    Sys->solve();
+    SoASys->solve();
+    for (unsigned i = 0; i < vars.size(); i++)
+      REQUIRE(double_equals(vars[i]->get_value(), soa_vars[i]->get_value(), sg_maxmin_precision));
+    for (unsigned i = round; i < vars.size(); i += 5) {
+      Sys->update_variable_penalty(vars[i], 2.0);
+      SoASys->update_variable_penalty(soa_vars[i], 2.0);
+    }
+  }
+
+  Sys->variable_free_all();
+  SoASys->variable_free_all();
+  delete Sys;
+  delete SoASys;
+  simgrid::config::set_value("maxmin/threads", 1);
+}
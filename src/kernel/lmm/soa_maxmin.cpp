@@ -0,0 +1,521 @@
+/* Copyright (c) 2004-2019. The SimGrid Team. All rights reserved.          */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#include "src/kernel/lmm/maxmin.hpp"
+#include "src/include/xbt/parmap.hpp"
+#include "src/surf/surf_interface.hpp"
+#include "xbt/config.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+XBT_LOG_EXTERNAL_DEFAULT_CATEGORY(surf_maxmin);
+
+static simgrid::config::Flag<int> cfg_maxmin_threads{
+    "maxmin/threads", "Number of threads used by the SoA max-min solver to solve independent parts of the system", 1,
+    [](int value) { xbt_assert(value >= 1, "The number of max-min threads must be positive"); }};
+static simgrid::config::Flag<bool> cfg_maxmin_warm_start{
+    "maxmin/warm-start", "Whether the SoA max-min solver should replay the unchanged parts of the previous resolution",
+    false};
+
+namespace simgrid {
+namespace kernel {
+namespace lmm {
+
+System* make_new_soa_maxmin_system(bool selective_update)
+{
+  return new SoAMaxMin(selective_update);
+}
+
+SoAMaxMin::SoAMaxMin(bool selective_update) : System(selective_update) {}
+SoAMaxMin::~SoAMaxMin() = default;
+
+/* The following kernels only deal with dense arrays. */
+
+/** @brief Smallest remaining/usage ratio among the constraints that can still be saturated (n > 0) */
+static inline double min_ratio(const double* ratio, size_t n)
+{
+  double res = ratio[0];
+  for (size_t i = 1; i < n; i++)
+    res = ratio[i] < res ? ratio[i] : res;
+  return res;
+}
+
+/** @brief Positions of the constraints which ratio is exactly the minimal one, in increasing order */
+static inline void select_min_ratio(const double* ratio, size_t n, double min_usage, std::vector<unsigned>& selected)
+{
+  selected.clear();
+  for (size_t i = 0; i < n; i++)
+    if (ratio[i] == min_usage)
+      selected.push_back(i);
+}
+
+unsigned SoAMaxMin::add_constraint(Constraint* cnst)
+{
+  if (cnst->soa_index_ < cnst_ptr_.size() && cnst_ptr_[cnst->soa_index_] == cnst)
+    return cnst->soa_index_;
+
+  cnst->soa_index_ = cnst_ptr_.size();
+  cnst_ptr_.push_back(cnst);
+  cnst_remaining_.push_back(cnst->remaining_);
+  cnst_usage_.push_back(cnst->usage_);
+  cnst_bound_.push_back(cnst->bound_);
+  cnst_fatpipe_.push_back(cnst->sharing_policy_ == s4u::Link::SharingPolicy::FATPIPE);
+  cnst_light_pos_.push_back(-1);
+  cnst_active_.push_back(0);
+  cnst_comp_.push_back(-1);
+  return cnst->soa_index_;
+}
+
+unsigned SoAMaxMin::add_variable(Variable* var)
+{
+  if (var->soa_index_ < var_ptr_.size() && var_ptr_[var->soa_index_] == var)
+    return var->soa_index_;
+
+  var->soa_index_ = var_ptr_.size();
+  var_ptr_.push_back(var);
+  var_penalty_.push_back(var->sharing_penalty_);
+  var_bound_.push_back(var->bound_);
+  var_value_.push_back(var->value_);
+  var_saturated_.push_back(0);
+  var_elem_begin_.push_back(var_elem_cnst_.size());
+  for (Element const& elem : var->cnsts_) {
+    var_elem_cnst_.push_back(add_constraint(elem.constraint));
+    var_elem_weight_.push_back(elem.consumption_weight);
+    var_elem_pos_.push_back(-1); // filled when the elements of the constraint get flattened
+  }
+  return var->soa_index_;
+}
+
+void SoAMaxMin::solve()
+{
+  if (modified_) {
+    XBT_IN("(sys=%p)", this);
+    if (selective_update_active)
+      soa_solve(modified_constraint_set);
+    else
+      soa_solve(active_constraint_set);
+    XBT_OUT();
+  }
+}
+
+void SoAMaxMin::saturated_variables_update(Component& comp)
+{
+  /* Same order as the active_element_set_ of System::lmm_solve(), where elements are pushed to the front */
+  for (unsigned const& pos : comp.saturated_constraints) {
+    unsigned cnst = comp.light_cnst[pos];
+    for (unsigned elem = cnst_elem_begin_[cnst + 1]; elem-- > cnst_elem_begin_[cnst];) {
+      unsigned var = elem_var_[elem];
+      if (elem_active_[elem] && elem_weight_[elem] > 0 && not var_saturated_[var]) {
+        var_saturated_[var] = 1;
+        comp.saturated_variables.push_back(var);
+      }
+    }
+  }
+}
+
+unsigned SoAMaxMin::find_root(unsigned cnst)
+{
+  while (cnst_parent_[cnst] != cnst) {
+    cnst_parent_[cnst] = cnst_parent_[cnst_parent_[cnst]];
+    cnst                = cnst_parent_[cnst];
+  }
+  return cnst;
+}
+
+void SoAMaxMin::split_components(size_t cnst_list_num)
+{
+  cnst_parent_.resize(cnst_ptr_.size());
+  std::iota(begin(cnst_parent_), end(cnst_parent_), 0);
+  for (unsigned var = 0; var < var_ptr_.size(); var++) {
+    unsigned first = find_root(var_elem_cnst_[var_elem_begin_[var]]);
+    for (unsigned e = var_elem_begin_[var] + 1; e < var_elem_begin_[var] + var_ptr_[var]->cnsts_.size(); e++) {
+      unsigned root = find_root(var_elem_cnst_[e]);
+      if (root != first)
+        cnst_parent_[root] = first;
+    }
+  }
+
+  for (unsigned cnst = 0; cnst < cnst_list_num; cnst++) {
+    unsigned root = find_root(cnst);
+    if (cnst_comp_[root] < 0) {
+      cnst_comp_[root] = components_num_;
+      get_component(components_num_++);
+    }
+    cnst_comp_[cnst] = cnst_comp_[root];
+    components_[cnst_comp_[cnst]].cnsts.push_back(cnst);
+  }
+  // The root of a component may be one of the constraints that are not to be solved
+  for (unsigned cnst = cnst_list_num; cnst < cnst_ptr_.size(); cnst++)
+    cnst_comp_[cnst] = -1;
+}
+
+SoAMaxMin::Component& SoAMaxMin::get_component(unsigned num)
+{
+  if (components_.size() <= num)
+    components_.resize(num + 1);
+  Component& comp = components_[num];
+  comp.num        = num;
+  comp.cnsts.clear();
+  comp.light_cnst.clear();
+  comp.light_ratio.clear();
+  comp.saturated_constraints.clear();
+  comp.saturated_variables.clear();
+  comp.dirty_cnst.clear();
+  comp.replay          = nullptr;
+  comp.replay_round    = 0;
+  comp.replayed_rounds = 0;
+  comp.trace.levels.clear();
+  comp.trace.ends.clear();
+  comp.trace.cnsts.clear();
+  return comp;
+}
+
+bool SoAMaxMin::replay_round(Component& comp, double& min_usage)
+{
+  const Trace& trace = *comp.replay;
+  while (comp.replay_round < trace.levels.size()) {
+    size_t round = comp.replay_round++;
+    size_t first = round > 0 ? trace.ends[round - 1] : 0;
+    double level = trace.levels[round];
+    comp.saturated_constraints.clear();
+    for (size_t i = first; i < trace.ends[round]; i++) {
+      const Constraint* c = trace.cnsts[i];
+      unsigned cnst       = c->soa_index_;
+      if (cnst >= cnst_ptr_.size() || cnst_ptr_[cnst] != c)
+        continue; // not involved in this resolution
+      if (cnst_comp_[cnst] != comp.num) {
+        if (cnst_comp_[cnst] < 0) // involved, but not solved this time: its previous saturation cannot be replayed
+          return false;
+        continue;
+      }
+      // Unchanged constraints get exactly the same ratio as in the previous resolution, unless something went wrong
+      int pos = cnst_light_pos_[cnst];
+      if (c->dirty_ || pos < 0 || comp.light_ratio[pos] != level)
+        return false;
+      comp.saturated_constraints.push_back(pos);
+    }
+    if (comp.saturated_constraints.empty()) // this round saturated constraints of another component
+      continue;
+    if (comp.saturated_constraints.size() != trace.ends[round] - first)
+      return false;
+    // The changed constraints may now saturate before (or with) the replayed ones
+    for (unsigned const& cnst : comp.dirty_cnst)
+      if (cnst_light_pos_[cnst] >= 0 && comp.light_ratio[cnst_light_pos_[cnst]] <= level)
+        return false;
+    // Same order as select_min_ratio(), so that the variables get saturated as without replay
+    std::sort(begin(comp.saturated_constraints), end(comp.saturated_constraints));
+    min_usage = level;
+    return true;
+  }
+  return false;
+}
+
+double SoAMaxMin::select_saturated(Component& comp)
+{
+  double min_usage = -1;
+  comp.saturated_constraints.clear();
+  if (comp.light_cnst.empty())
+    return min_usage;
+
+  if (comp.replay != nullptr && replay_round(comp, min_usage)) {
+    comp.replayed_rounds++;
+  } else {
+    comp.replay = nullptr;
+    min_usage   = min_ratio(comp.light_ratio.data(), comp.light_ratio.size());
+    select_min_ratio(comp.light_ratio.data(), comp.light_ratio.size(), min_usage, comp.saturated_constraints);
+  }
+
+  if (cfg_maxmin_warm_start) {
+    comp.trace.levels.push_back(min_usage);
+    for (unsigned const& pos : comp.saturated_constraints)
+      comp.trace.cnsts.push_back(cnst_ptr_[comp.light_cnst[pos]]);
+    comp.trace.ends.push_back(comp.trace.cnsts.size());
+  }
+  return min_usage;
+}
+
+void SoAMaxMin::save_trace(Component& comp)
+{
+  unsigned id         = next_trace_id_++;
+  unsigned erased_id = 0;
+  for (unsigned const& cnst : comp.cnsts) {
+    Constraint* c = cnst_ptr_[cnst];
+    // The other constraints of the previous component (if any) cannot replay it anymore
+    if (c->trace_id_ != 0 && c->trace_id_ != erased_id) {
+      erased_id = c->trace_id_;
+      traces_.erase(erased_id);
+    }
+    c->trace_id_ = id;
+    c->dirty_    = false;
+  }
+  traces_[id] = std::move(comp.trace);
+}
+
+void SoAMaxMin::saturate(Component& comp)
+{
+  double min_usage = -1;
+  double min_bound = -1;
+
+  /* Constraints without active element were skipped by the initialization (their usage is not significant) */
+  unsigned replay_id = 0;
+  bool replayable    = cfg_maxmin_warm_start;
+  for (unsigned const& cnst : comp.cnsts) {
+    bool light = cnst_active_[cnst] > 0 && cnst_usage_[cnst] > 0;
+    if (light) {
+      cnst_light_pos_[cnst] = comp.light_cnst.size();
+      comp.light_cnst.push_back(cnst);
+      comp.light_ratio.push_back(cnst_remaining_[cnst] / cnst_usage_[cnst]);
+    }
+    if (not replayable)
+      continue;
+    // The previous rounds can only be replayed if all unchanged constraints were solved together last time
+    const Constraint* c = cnst_ptr_[cnst];
+    if (c->dirty_) {
+      if (light)
+        comp.dirty_cnst.push_back(cnst);
+    } else if (replay_id == 0 || replay_id == c->trace_id_) {
+      replay_id = c->trace_id_;
+    } else {
+      replayable = false;
+    }
+  }
+  if (replayable && replay_id != 0) {
+    auto trace = traces_.find(replay_id);
+    if (trace != traces_.end())
+      comp.replay = &trace->second;
+  }
+
+  min_usage = select_saturated(comp);
+  saturated_variables_update(comp);
+
+  auto remove_light = [this, &comp](unsigned cnst) {
+    int index = cnst_light_pos_[cnst];
+    if (index < 0)
+      return;
+    comp.light_cnst[index]                  = comp.light_cnst.back();
+    comp.light_ratio[index]                 = comp.light_ratio.back();
+    cnst_light_pos_[comp.light_cnst[index]] = index;
+    comp.light_cnst.pop_back();
+    comp.light_ratio.pop_back();
+    cnst_light_pos_[cnst] = -1;
+  };
+  auto is_saturated = [this](unsigned cnst) {
+    return not double_positive(cnst_usage_[cnst], sg_maxmin_precision) ||
+           not double_positive(cnst_remaining_[cnst], cnst_bound_[cnst] * sg_maxmin_precision);
+  };
+  auto deactivate = [this](int elem, unsigned cnst) {
+    if (elem >= 0 && elem_active_[elem]) {
+      elem_active_[elem] = 0;
+      cnst_active_[cnst]--;
+    }
+  };
+
+  /* Saturated variables update */
+  while (not comp.light_cnst.empty()) {
+    /* Fix the variables that have to be */
+    for (unsigned const& var : comp.saturated_variables) {
+      if (var_penalty_[var] <= 0.0)
+        DIE_IMPOSSIBLE;
+      /* First check if some of these variables could reach their upper bound and update min_bound accordingly. */
+      double bound = var_bound_[var] * var_penalty_[var];
+      if ((var_bound_[var] > 0) && (bound < min_usage)) {
+        if (min_bound < 0)
+          min_bound = bound;
+        else
+          min_bound = std::min(min_bound, bound);
+      }
+    }
+
+    for (unsigned const& var : comp.saturated_variables) {
+      var_saturated_[var] = 0;
+      double penalty      = var_penalty_[var];
+      if (min_bound < 0) {
+        // If no variable could reach its bound, deal iteratively the constraints usage ( at worst one constraint is
+        // saturated at each cycle)
+        var_value_[var] = min_usage / penalty;
+      } else if (double_equals(min_bound, var_bound_[var] * penalty, sg_maxmin_precision)) {
+        // If there exist a variable that can reach its bound, only update it (and other with the same bound) for now.
+        var_value_[var] = var_bound_[var];
+      } else {
+        // Variables which bound is different are not considered for this cycle, but they will be afterwards.
+        continue;
+      }
+      XBT_DEBUG("Setting var (%d) value to %f", var_ptr_[var]->rank_, var_value_[var]);
+
+      /* Update the usage of contraints where this variable is involved */
+      for (unsigned e = var_elem_begin_[var]; e < var_elem_begin_[var] + var_ptr_[var]->cnsts_.size(); e++) {
+        unsigned cnst = var_elem_cnst_[e];
+        if (not cnst_fatpipe_[cnst]) {
+          // Remember: shared constraints require that sum(elem.value * var.value) < cnst->bound
+          double_update(&cnst_remaining_[cnst], var_elem_weight_[e] * var_value_[var],
+                        cnst_bound_[cnst] * sg_maxmin_precision);
+          double_update(&cnst_usage_[cnst], var_elem_weight_[e] / penalty, sg_maxmin_precision);
+          deactivate(var_elem_pos_[e], cnst);
+        } else {
+          // Remember: non-shared constraints only require that max(elem.value * var.value) < cnst->bound
+          deactivate(var_elem_pos_[e], cnst);
+          double usage = 0.0;
+          for (unsigned elem = cnst_elem_begin_[cnst]; elem < cnst_elem_begin_[cnst + 1]; elem++) {
+            unsigned var2 = elem_var_[elem];
+            if (var_value_[var2] > 0)
+              continue;
+            if (elem_weight_[elem] > 0)
+              usage = std::max(usage, elem_weight_[elem] / var_penalty_[var2]);
+          }
+          cnst_usage_[cnst] = usage;
+        }
+        // If the constraint is saturated, remove it from the set of saturable constraints
+        if (is_saturated(cnst)) {
+          remove_light(cnst);
+        } else if (cnst_light_pos_[cnst] >= 0) {
+          comp.light_ratio[cnst_light_pos_[cnst]] = cnst_remaining_[cnst] / cnst_usage_[cnst];
+          xbt_assert(not cnst_fatpipe_[cnst] || cnst_active_[cnst] > 0,
+                     "Should not keep a maximum constraint that has no active"
+                     " element! You want to check the maxmin precision and possible rounding effects.");
+        }
+      }
+    }
+    comp.saturated_variables.clear();
+
+    /* Find out which variables reach the maximum */
+    min_bound = -1;
+    for (unsigned const& cnst : comp.light_cnst)
+      xbt_assert(cnst_active_[cnst] > 0,
+                 "Cannot saturate more a constraint that has no active element! You may want to change the maxmin "
+                 "precision (--cfg=maxmin/precision:<new_value>) because of possible rounding effects.\n\tFor the "
+                 "record, the usage of this constraint is %g while the maxmin precision to which it is compared is %g.",
+                 cnst_usage_[cnst], sg_maxmin_precision);
+    min_usage = select_saturated(comp);
+    saturated_variables_update(comp);
+  }
+}
+
+template <class CnstList> void SoAMaxMin::soa_solve(CnstList& cnst_list)
+{
+  XBT_DEBUG("Active constraints : %zu", cnst_list.size());
+
+  /* Flatten the system. The constraints to solve come first; the other constraints involving the same variables (if
+   * any) are appended afterwards, with their current state. */
+  for (Constraint& cnst : cnst_list)
+    add_constraint(&cnst);
+  size_t cnst_list_num = cnst_ptr_.size();
+
+  for (unsigned cnst = 0; cnst < cnst_ptr_.size(); cnst++) {
+    cnst_elem_begin_.push_back(elem_var_.size());
+    for (Element const& elem : cnst_ptr_[cnst]->enabled_element_set_) {
+      xbt_assert(elem.variable->sharing_penalty_ > 0.0);
+      unsigned var = add_variable(elem.variable);
+      if (cnst < cnst_list_num)
+        var_value_[var] = 0.0;
+      var_elem_pos_[var_elem_begin_[var] + (&elem - elem.variable->cnsts_.data())] = elem_var_.size();
+      elem_var_.push_back(var);
+      elem_weight_.push_back(elem.consumption_weight);
+      elem_active_.push_back(0);
+    }
+  }
+  cnst_elem_begin_.push_back(elem_var_.size());
+
+  for (unsigned cnst = 0; cnst < cnst_list_num; cnst++) {
+    /* INIT: Activate the elements of the constraints that actually need to be saturated (i.e remaining and usage are
+     * strictly positive). The light tables get built afterwards, in each component. */
+    cnst_remaining_[cnst] = cnst_bound_[cnst];
+    if (not double_positive(cnst_remaining_[cnst], cnst_bound_[cnst] * sg_maxmin_precision))
+      continue;
+    double usage = 0.0;
+    for (unsigned elem = cnst_elem_begin_[cnst]; elem < cnst_elem_begin_[cnst + 1]; elem++) {
+      if (elem_weight_[elem] > 0) {
+        double elem_usage = elem_weight_[elem] / var_penalty_[elem_var_[elem]];
+        if (not cnst_fatpipe_[cnst])
+          usage += elem_usage;
+        else if (usage < elem_usage)
+          usage = elem_usage;
+
+        elem_active_[elem] = 1;
+        cnst_active_[cnst]++;
+        resource::Action* action = var_ptr_[elem_var_[elem]]->id_;
+        if (modified_set_ && not action->is_within_modified_set())
+          modified_set_->push_back(*action);
+      }
+    }
+    cnst_usage_[cnst] = usage;
+    XBT_DEBUG("Constraint '%d' usage: %f remaining: %f", cnst_ptr_[cnst]->rank_, usage, cnst_remaining_[cnst]);
+  }
+
+  /* Solve each independent part of the system on its own, in parallel if requested */
+  components_num_ = 0;
+  if (cfg_maxmin_threads > 1 || cfg_maxmin_warm_start) {
+    split_components(cnst_list_num);
+  } else {
+    Component& comp = get_component(components_num_++);
+    comp.cnsts.resize(cnst_list_num);
+    std::iota(begin(comp.cnsts), end(comp.cnsts), 0);
+    std::fill(begin(cnst_comp_), begin(cnst_comp_) + cnst_list_num, 0);
+  }
+  XBT_DEBUG("Solving %u independent component(s)", components_num_);
+
+  if (components_num_ > 1 && cfg_maxmin_threads > 1) {
+    if (not parmap_)
+      parmap_.reset(new xbt::Parmap<Component*>(cfg_maxmin_threads, XBT_PARMAP_DEFAULT));
+    std::vector<Component*> todo;
+    for (unsigned i = 0; i < components_num_; i++)
+      todo.push_back(&components_[i]);
+    // Start with the largest components, so that the workers are balanced at the end of the round
+    std::stable_sort(begin(todo), end(todo),
+                     [](Component const* a, Component const* b) { return a->cnsts.size() > b->cnsts.size(); });
+    parmap_->apply([this](Component* comp) { saturate(*comp); }, todo);
+  } else {
+    for (unsigned i = 0; i < components_num_; i++)
+      saturate(components_[i]);
+  }
+  if (cfg_maxmin_warm_start)
+    for (unsigned i = 0; i < components_num_; i++) {
+      replayed_rounds_ += components_[i].replayed_rounds;
+      save_trace(components_[i]);
+    }
+
+  /* Copy the results back into the system, and forget about the arrays (their capacity is kept for the next round) */
+  for (unsigned cnst = 0; cnst < cnst_ptr_.size(); cnst++) {
+    cnst_ptr_[cnst]->remaining_ = cnst_remaining_[cnst];
+    cnst_ptr_[cnst]->usage_     = cnst_usage_[cnst];
+  }
+  for (unsigned var = 0; var < var_ptr_.size(); var++)
+    var_ptr_[var]->value_ = var_value_[var];
+
+  cnst_ptr_.clear();
+  cnst_remaining_.clear();
+  cnst_usage_.clear();
+  cnst_bound_.clear();
+  cnst_fatpipe_.clear();
+  cnst_light_pos_.clear();
+  cnst_active_.clear();
+  cnst_comp_.clear();
+  cnst_elem_begin_.clear();
+  elem_var_.clear();
+  elem_weight_.clear();
+  elem_active_.clear();
+  var_ptr_.clear();
+  var_penalty_.clear();
+  var_bound_.clear();
+  var_value_.clear();
+  var_saturated_.clear();
+  var_elem_begin_.clear();
+  var_elem_cnst_.clear();
+  var_elem_weight_.clear();
+  var_elem_pos_.clear();
+
+  modified_ = false;
+  if (selective_update_active)
+    remove_all_modified_set();
+
+  if (XBT_LOG_ISENABLED(surf_maxmin, xbt_log_priority_debug)) {
+    print();
+  }
+
+  check_concurrency();
+}
+}
+}
+}
@@ -16,22 +16,20 @@ simgrid::kernel::profile::FutureEvtSet future_evt_set; // FIXME: singleton antip
 FutureEvtSet::FutureEvtSet() = default;
 FutureEvtSet::~FutureEvtSet()
 {
-  while (not heap_.empty()) {
-    delete heap_.top().second;
-    heap_.pop();
-  }
+  while (not heap_.empty())
+    delete heap_.pop();
 }
 
 /** @brief Schedules an event to a future date */
 void FutureEvtSet::add_event(double date, Event* evt)
 {
-  heap_.emplace(date, evt);
+  heap_.push(date, evt);
 }
 
 /** @brief returns the date of the next occurring event (or -1 if empty) */
 double FutureEvtSet::next_date() const
 {
-  return heap_.empty() ? -1.0 : heap_.top().first;
+  return heap_.empty() ? -1.0 : heap_.top_date();
 }
 
 /** @brief Retrieves the next occurring event, or nullptr if none happens before date */
@@ -41,7 +39,7 @@ Event* FutureEvtSet::pop_leq(double date, double* value, resource::Resource** re
   if (event_date > date || heap_.empty())
     return nullptr;
 
-  Event* event       = heap_.top().second;
+  Event* event       = heap_.top();
   Profile* profile   = event->profile;
   DatedValue dateVal = profile->next(event);
 
@@ -7,7 +7,7 @@
 #define FUTUREEVTSET_HPP
 
 #include "simgrid/forward.h"
-#include <queue>
+#include "xbt/event_queue.hpp"
 
 namespace simgrid {
 namespace kernel {
@@ -26,8 +26,7 @@ public:
   void add_event(double date, Event* evt);
 
 private:
-  typedef std::pair<double, Event*> Qelt;
-  std::priority_queue<Qelt, std::vector<Qelt>, std::greater<Qelt>> heap_;
+  xbt::EventQueue<Event*> heap_;
 };
 
 // FIXME: kill that singleton
@@ -108,6 +108,21 @@ Profile* Profile::from_string(const std::string& name, const std::string& input,
     }
   }
 
+  profile->name_ = name;
+  trace_list.insert({name, profile});
+
+  return profile;
+}
+
+/** @brief Creates a profile from its internal representation (as found in the event_list of another profile) */
+Profile* Profile::from_event_list(const std::string& name, const std::vector<DatedValue>& event_list)
+{
+  xbt_assert(trace_list.find(name) == trace_list.end(), "Refusing to define trace %s twice", name.c_str());
+  xbt_assert(not event_list.empty(), "The event list of trace %s lacks its initial placeholder", name.c_str());
+
+  Profile* profile    = new Profile();
+  profile->event_list = event_list;
+  profile->name_      = name;
   trace_list.insert({name, profile});
 
   return profile;
@@ -11,6 +11,7 @@
 #include "src/kernel/resource/profile/FutureEvtSet.hpp"
 
 #include <queue>
+#include <string>
 #include <vector>
 
 namespace simgrid {
@@ -33,10 +34,13 @@ public:
 
   static Profile* from_file(const std::string& path);
   static Profile* from_string(const std::string& name, const std::string& input, double periodicity);
+  static Profile* from_event_list(const std::string& name, const std::vector<DatedValue>& event_list);
+  const std::string& get_name() const { return name_; }
   // private:
   std::vector<DatedValue> event_list;
 
 private:
+  std::string name_;
   FutureEvtSet* fes_ = nullptr;
 };
 
@@ -5,99 +5,147 @@
 
 #include "simgrid/kernel/routing/DijkstraZone.hpp"
 #include "simgrid/kernel/routing/NetPoint.hpp"
+#include "src/include/xbt/parmap.hpp"
 #include "src/surf/network_interface.hpp"
 #include "src/surf/xml/platf_private.hpp"
 #include "surf/surf.hpp"
+#include "xbt/config.hpp"
 #include "xbt/string.hpp"
 
 #include <cfloat>
+#include <numeric>
 #include <queue>
 #include <vector>
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(surf_route_dijkstra, surf, "Routing part of surf -- dijkstra routing logic");
 
+static simgrid::config::Flag<int> cfg_dijkstra_precompute{
+    "network/dijkstra-precompute",
+    "Number of threads computing all the routes of the DijkstraCache zones when sealing them (0: compute them on need)",
+    0, [](int value) { xbt_assert(value >= 0, "The number of threads cannot be negative"); }};
+
 namespace simgrid {
 namespace kernel {
 namespace routing {
 
-class GraphNodeData {
-public:
-  explicit GraphNodeData(int id) : id_(id) {}
-  int id_;
-  int graph_id_ = -1; /* used for caching internal graph id's */
-};
-
 DijkstraZone::DijkstraZone(NetZoneImpl* father, const std::string& name, resource::NetworkModel* netmodel, bool cached)
     : RoutedZone(father, name, netmodel), cached_(cached)
 {
 }
 
-static void graph_node_data_free(void* n)
-{
-  delete static_cast<simgrid::kernel::routing::GraphNodeData*>(n);
-}
-
-static void graph_edge_data_free(void* e)
-{
-  delete static_cast<simgrid::kernel::routing::RouteCreationArgs*>(e);
-}
-
 DijkstraZone::~DijkstraZone()
 {
-  xbt_graph_free_graph(route_graph_, &graph_node_data_free, &graph_edge_data_free, nullptr);
+  for (auto const* route : edge_route_)
+    delete route;
 }
 
 void DijkstraZone::seal()
 {
-  unsigned int cursor;
-  xbt_node_t node = nullptr;
-
-  if (not route_graph_)
-    route_graph_ = xbt_graph_new_graph(1, nullptr);
-
   /* Add the loopback if needed */
   if (network_model_->loopback_ && hierarchy_ == RoutingMode::base) {
-
-    xbt_dynar_foreach (xbt_graph_get_nodes(route_graph_), cursor, node) {
-      bool found = false;
-      xbt_edge_t edge = nullptr;
-      unsigned int cursor2;
-      xbt_dynar_foreach (xbt_graph_node_get_outedges(node), cursor2, edge) {
-        if (xbt_graph_edge_get_target(edge) == node) { // There is an edge from node to itself
-          found = true;
-          break;
-        }
-      }
-
-      if (not found) {
+    for (int node = 0; node < nodes_num_; node++) {
+      if (get_edge(node, node) < 0) { // There is no edge from node to itself
         RouteCreationArgs* route = new simgrid::kernel::routing::RouteCreationArgs();
         route->link_list.push_back(network_model_->loopback_);
-        xbt_graph_new_edge(route_graph_, node, node, route);
+        edge_map_.emplace(std::make_pair(node, node), edge_route_.size());
+        edge_src_.push_back(node);
+        edge_dst_.push_back(node);
+        edge_route_.push_back(route);
       }
     }
   }
 
-  /* initialize graph indexes in nodes after graph has been built */
-  xbt_dynar_t nodes = xbt_graph_get_nodes(route_graph_);
+  build_graph();
+
+  /* Compute the paths from all sources at once, if requested */
+  if (cached_ && cfg_dijkstra_precompute > 0) {
+    XBT_DEBUG("Computing the routes from all %d nodes of %s", nodes_num_, get_cname());
+    std::vector<int> sources(nodes_num_);
+    std::iota(begin(sources), end(sources), 0);
+    auto compute = [this](const int src_node) { compute_predecessors(src_node, route_cache_[src_node]); };
+    if (cfg_dijkstra_precompute > 1 && nodes_num_ > 1) {
+      xbt::Parmap<int> parmap(cfg_dijkstra_precompute, XBT_PARMAP_DEFAULT);
+      parmap.apply(compute, sources);
+    } else {
+      for (int const& src_node : sources)
+        compute(src_node);
+    }
+  }
+}
 
-  xbt_dynar_foreach (nodes, cursor, node) {
-    GraphNodeData* data = static_cast<GraphNodeData*>(xbt_graph_node_get_data(node));
-    data->graph_id_     = cursor;
+/** @brief Compile the edges into the compressed sparse row graph (keeping the edges of each node in creation order) */
+void DijkstraZone::build_graph()
+{
+  out_begin_.assign(nodes_num_ + 1, 0);
+  for (int const& src_node : edge_src_)
+    out_begin_[src_node + 1]++;
+  std::partial_sum(begin(out_begin_), end(out_begin_), begin(out_begin_));
+
+  size_t edges_num = edge_route_.size();
+  out_edge_.resize(edges_num);
+  out_target_.resize(edges_num);
+  out_cost_.resize(edges_num);
+  std::vector<int> pos(begin(out_begin_), end(out_begin_) - 1);
+  for (unsigned edge = 0; edge < edges_num; edge++) {
+    int i          = pos[edge_src_[edge]]++;
+    out_edge_[i]   = edge;
+    out_target_[i] = edge_dst_[edge];
+    out_cost_[i]   = edge_route_[edge]->link_list.size(); /* count of links, old model assume 1 */
   }
+  compiled_edges_num_ = edges_num;
+
+  route_cache_.clear();
+  route_cache_.resize(nodes_num_);
 }
 
-xbt_node_t DijkstraZone::route_graph_new_node(int id)
+int DijkstraZone::route_graph_new_node(int id)
 {
-  xbt_node_t node = xbt_graph_new_node(route_graph_, new GraphNodeData(id));
-  graph_node_map_.emplace(id, node);
+  if (graph_node_map_.size() <= static_cast<unsigned>(id))
+    graph_node_map_.resize(id + 1, -1);
+  graph_node_map_[id] = nodes_num_;
+  return nodes_num_++;
+}
 
-  return node;
+int DijkstraZone::node_map_search(int id)
+{
+  return static_cast<unsigned>(id) < graph_node_map_.size() ? graph_node_map_[id] : -1;
 }
 
-xbt_node_t DijkstraZone::node_map_search(int id)
+int DijkstraZone::get_edge(int src_node, int dst_node)
 {
-  auto ret = graph_node_map_.find(id);
-  return ret == graph_node_map_.end() ? nullptr : ret->second;
+  auto edge = edge_map_.find({src_node, dst_node});
+  return edge == edge_map_.end() ? -1 : edge->second;
+}
+
+/** @brief Compute, for each node, the last edge of the shortest path from src_node (or -1 if there is none) */
+void DijkstraZone::compute_predecessors(int src_node, std::vector<int>& pred_arr)
+{
+  std::vector<double> cost_arr(nodes_num_, DBL_MAX); /* link cost from src to other hosts */
+  pred_arr.assign(nodes_num_, -1);                   /* last edge in path from src */
+  typedef std::pair<double, int> Qelt;
+  std::priority_queue<Qelt, std::vector<Qelt>, std::greater<Qelt>> pqueue;
+
+  /* initialize */
+  cost_arr[src_node] = 0.0;
+  pqueue.emplace(0.0, src_node);
+
+  /* apply dijkstra on the compressed graph */
+  while (not pqueue.empty()) {
+    double v_cost = pqueue.top().first;
+    int v_id      = pqueue.top().second;
+    pqueue.pop();
+    if (v_cost > cost_arr[v_id]) // outdated element, the node was already reached through a shorter path
+      continue;
+
+    for (int i = out_begin_[v_id]; i < out_begin_[v_id + 1]; i++) {
+      int u_id = out_target_[i];
+      if (out_cost_[i] + cost_arr[v_id] < cost_arr[u_id]) {
+        pred_arr[u_id] = out_edge_[i];
+        cost_arr[u_id] = out_cost_[i] + cost_arr[v_id];
+        pqueue.emplace(cost_arr[u_id], u_id);
+      }
+    }
+  }
 }
 
 /* Parsing */
@@ -108,95 +156,42 @@ void DijkstraZone::get_local_route(NetPoint* src, NetPoint* dst, RouteCreationAr
   int src_id = src->id();
   int dst_id = dst->id();
 
-  xbt_dynar_t nodes = xbt_graph_get_nodes(route_graph_);
+  if (compiled_edges_num_ != edge_route_.size()) // Some routes were added after sealing
+    build_graph();
 
   /* Use the graph_node id mapping set to quickly find the nodes */
-  xbt_node_t src_elm = node_map_search(src_id);
-  xbt_node_t dst_elm = node_map_search(dst_id);
-
-  int src_node_id = static_cast<GraphNodeData*>(xbt_graph_node_get_data(src_elm))->graph_id_;
-  int dst_node_id = static_cast<GraphNodeData*>(xbt_graph_node_get_data(dst_elm))->graph_id_;
+  int src_node_id = node_map_search(src_id);
+  int dst_node_id = node_map_search(dst_id);
+  if (src_node_id < 0 || dst_node_id < 0)
+    throw std::invalid_argument(xbt::string_printf("No route from '%s' to '%s'", src->get_cname(), dst->get_cname()));
 
   /* if the src and dst are the same */
   if (src_node_id == dst_node_id) {
+    int edge = get_edge(src_node_id, dst_node_id);
 
-    xbt_node_t node_s_v = xbt_dynar_get_as(nodes, src_node_id, xbt_node_t);
-    xbt_node_t node_e_v = xbt_dynar_get_as(nodes, dst_node_id, xbt_node_t);
-    xbt_edge_t edge     = xbt_graph_get_edge(route_graph_, node_s_v, node_e_v);
-
-    if (edge == nullptr)
+    if (edge < 0)
       throw std::invalid_argument(xbt::string_printf("No route from '%s' to '%s'", src->get_cname(), dst->get_cname()));
 
-    RouteCreationArgs* e_route = static_cast<RouteCreationArgs*>(xbt_graph_edge_get_data(edge));
-
-    for (auto const& link : e_route->link_list) {
+    for (auto const& link : edge_route_[edge]->link_list) {
       route->link_list.insert(route->link_list.begin(), link);
       if (lat)
         *lat += static_cast<resource::LinkImpl*>(link)->get_latency();
     }
   }
 
-  auto elm                   = route_cache_.emplace(src_id, std::vector<int>());
-  std::vector<int>& pred_arr = elm.first->second;
-
-  if (elm.second) { /* new element was inserted (not cached mode, or cache miss) */
-    int nr_nodes      = xbt_dynar_length(nodes);
-    std::vector<double> cost_arr(nr_nodes); /* link cost from src to other hosts */
-    pred_arr.resize(nr_nodes);              /* predecessors in path from src */
-    typedef std::pair<double, int> Qelt;
-    std::priority_queue<Qelt, std::vector<Qelt>, std::greater<Qelt>> pqueue;
-
-    /* initialize */
-    cost_arr[src_node_id] = 0.0;
-
-    for (int i = 0; i < nr_nodes; i++) {
-      if (i != src_node_id) {
-        cost_arr[i] = DBL_MAX;
-      }
-
-      pred_arr[i] = 0;
-
-      /* initialize priority queue */
-      pqueue.emplace(cost_arr[i], i);
-    }
-
-    /* apply dijkstra using the indexes from the graph's node array */
-    while (not pqueue.empty()) {
-      int v_id = pqueue.top().second;
-      pqueue.pop();
-      xbt_node_t v_node = xbt_dynar_get_as(nodes, v_id, xbt_node_t);
-      xbt_edge_t edge   = nullptr;
-      unsigned int cursor;
-
-      xbt_dynar_foreach (xbt_graph_node_get_outedges(v_node), cursor, edge) {
-        xbt_node_t u_node                  = xbt_graph_edge_get_target(edge);
-        GraphNodeData* data                = static_cast<GraphNodeData*>(xbt_graph_node_get_data(u_node));
-        int u_id                           = data->graph_id_;
-        RouteCreationArgs* tmp_e_route     = static_cast<RouteCreationArgs*>(xbt_graph_edge_get_data(edge));
-        int cost_v_u                       = tmp_e_route->link_list.size(); /* count of links, old model assume 1 */
-
-        if (cost_v_u + cost_arr[v_id] < cost_arr[u_id]) {
-          pred_arr[u_id] = v_id;
-          cost_arr[u_id] = cost_v_u + cost_arr[v_id];
-          pqueue.emplace(cost_arr[u_id], u_id);
-        }
-      }
-    }
-  }
+  std::vector<int>& pred_arr = route_cache_[src_node_id];
+  if (pred_arr.empty()) /* not cached mode, or cache miss */
+    compute_predecessors(src_node_id, pred_arr);
 
   /* compose route path with links */
   NetPoint* gw_src   = nullptr;
   NetPoint* first_gw = nullptr;
 
-  for (int v = dst_node_id; v != src_node_id; v = pred_arr[v]) {
-    xbt_node_t node_pred_v = xbt_dynar_get_as(nodes, pred_arr[v], xbt_node_t);
-    xbt_node_t node_v      = xbt_dynar_get_as(nodes, v, xbt_node_t);
-    xbt_edge_t edge        = xbt_graph_get_edge(route_graph_, node_pred_v, node_v);
-
-    if (edge == nullptr)
+  for (int v = dst_node_id; v != src_node_id; v = edge_src_[pred_arr[v]]) {
+    if (pred_arr[v] < 0)
       throw std::invalid_argument(xbt::string_printf("No route from '%s' to '%s'", src->get_cname(), dst->get_cname()));
 
-    RouteCreationArgs* e_route = static_cast<RouteCreationArgs*>(xbt_graph_edge_get_data(edge));
+    RouteCreationArgs* e_route = edge_route_[pred_arr[v]];
 
     NetPoint* prev_gw_src = gw_src;
     gw_src                = e_route->gw_src;
@@ -233,7 +228,7 @@ void DijkstraZone::get_local_route(NetPoint* src, NetPoint* dst, RouteCreationAr
   }
 
   if (not cached_)
-    route_cache_.clear();
+    pred_arr.clear();
 }
 
 void DijkstraZone::add_route(NetPoint* src, NetPoint* dst, NetPoint* gw_src, NetPoint* gw_dst,
@@ -241,9 +236,6 @@ void DijkstraZone::add_route(NetPoint* src, NetPoint* dst, NetPoint* gw_src, Net
 {
   add_route_check_params(src, dst, gw_src, gw_dst, link_list, symmetrical);
 
-  if (not route_graph_)
-    route_graph_ = xbt_graph_new_graph(1, nullptr);
-
   new_edge(src->id(), dst->id(), new_extended_route(hierarchy_, src, dst, gw_src, gw_dst, link_list, symmetrical, 1));
 
   if (symmetrical == true)
@@ -255,16 +247,16 @@ void DijkstraZone::new_edge(int src_id, int dst_id, simgrid::kernel::routing::Ro
   XBT_DEBUG("Create Route from '%d' to '%d'", src_id, dst_id);
 
   // Get the extremities, or create them if they don't exist yet
-  xbt_node_t src = node_map_search(src_id);
-  if (src == nullptr)
+  int src = node_map_search(src_id);
+  if (src < 0)
     src = route_graph_new_node(src_id);
 
-  xbt_node_t dst = node_map_search(dst_id);
-  if (dst == nullptr)
+  int dst = node_map_search(dst_id);
+  if (dst < 0)
     dst = route_graph_new_node(dst_id);
 
   // Make sure that this graph edge was not already added to the graph
-  if (xbt_graph_get_edge(route_graph_, src, dst) != nullptr) {
+  if (get_edge(src, dst) >= 0) {
     if (route->gw_dst == nullptr || route->gw_src == nullptr)
       throw std::invalid_argument(
           xbt::string_printf("Route from %s to %s already exists", route->src->get_cname(), route->dst->get_cname()));
@@ -275,7 +267,10 @@ void DijkstraZone::new_edge(int src_id, int dst_id, simgrid::kernel::routing::Ro
   }
 
   // Finally add it
-  xbt_graph_new_edge(route_graph_, src, dst, route);
+  edge_map_.emplace(std::make_pair(src, dst), edge_route_.size());
+  edge_src_.push_back(src);
+  edge_dst_.push_back(dst);
+  edge_route_.push_back(route);
 }
 }
 }
@@ -5,19 +5,27 @@
 
 #include "simgrid/kernel/routing/FloydZone.hpp"
 #include "simgrid/kernel/routing/NetPoint.hpp"
+#include "src/include/xbt/parmap.hpp"
 #include "src/surf/network_interface.hpp"
 #include "src/surf/xml/platf_private.hpp"
 #include "surf/surf.hpp"
+#include "xbt/config.hpp"
 #include "xbt/string.hpp"
 
+#include <algorithm>
 #include <cfloat>
 #include <limits>
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(surf_route_floyd, surf, "Routing part of surf");
 
-#define TO_FLOYD_COST(i, j) (cost_table_)[(i) + (j)*table_size]
-#define TO_FLOYD_PRED(i, j) (predecessor_table_)[(i) + (j)*table_size]
-#define TO_FLOYD_LINK(i, j) (link_table_)[(i) + (j)*table_size]
+static simgrid::config::Flag<int> cfg_floyd_threads{
+    "network/floyd-threads", "Number of threads computing the routes of the Floyd netzones when sealing them", 1,
+    [](int value) { xbt_assert(value >= 1, "The number of threads must be positive"); }};
+
+static inline unsigned long long floyd_link_key(unsigned int src, unsigned int dst)
+{
+  return (static_cast<unsigned long long>(src) << 32) | dst;
+}
 
 namespace simgrid {
 namespace kernel {
@@ -26,24 +34,17 @@ namespace routing {
 FloydZone::FloydZone(NetZoneImpl* father, const std::string& name, resource::NetworkModel* netmodel)
     : RoutedZone(father, name, netmodel)
 {
-  predecessor_table_ = nullptr;
-  cost_table_        = nullptr;
-  link_table_        = nullptr;
 }
 
-FloydZone::~FloydZone()
+RouteCreationArgs* FloydZone::get_link(unsigned int src, unsigned int dst) const
 {
-  if (link_table_ == nullptr) // Dealing with a parse error in the file?
-    return;
-  unsigned int table_size = get_table_size();
-  /* Delete link_table */
-  for (unsigned int i = 0; i < table_size; i++)
-    for (unsigned int j = 0; j < table_size; j++)
-      delete TO_FLOYD_LINK(i, j);
-  delete[] link_table_;
-
-  delete[] predecessor_table_;
-  delete[] cost_table_;
+  auto it = link_table_.find(floyd_link_key(src, dst));
+  return it == link_table_.end() ? nullptr : it->second;
+}
+
+void FloydZone::set_link(unsigned int src, unsigned int dst, RouteCreationArgs* route)
+{
+  link_table_[floyd_link_key(src, dst)] = share_route(route);
 }
 
 void FloydZone::get_local_route(NetPoint* src, NetPoint* dst, RouteCreationArgs* route, double* lat)
@@ -56,10 +57,10 @@ void FloydZone::get_local_route(NetPoint* src, NetPoint* dst, RouteCreationArgs*
   std::vector<RouteCreationArgs*> route_stack;
   unsigned int cur = dst->id();
   do {
-    int pred = TO_FLOYD_PRED(src->id(), cur);
+    int pred = predecessor_table_[static_cast<size_t>(src->id()) * table_size + cur];
     if (pred == -1)
       throw std::invalid_argument(xbt::string_printf("No route from '%s' to '%s'", src->get_cname(), dst->get_cname()));
-    route_stack.push_back(TO_FLOYD_LINK(pred, cur));
+    route_stack.push_back(get_link(pred, cur));
     cur = pred;
   } while (cur != src->id());
 
@@ -90,49 +91,31 @@ void FloydZone::get_local_route(NetPoint* src, NetPoint* dst, RouteCreationArgs*
 void FloydZone::add_route(NetPoint* src, NetPoint* dst, NetPoint* gw_src, NetPoint* gw_dst,
                           std::vector<resource::LinkImpl*>& link_list, bool symmetrical)
 {
-  /* set the size of table routing */
-  unsigned int table_size = get_table_size();
-
   add_route_check_params(src, dst, gw_src, gw_dst, link_list, symmetrical);
-
-  if (not link_table_) {
-    /* Create Cost, Predecessor and Link tables */
-    cost_table_        = new double[table_size * table_size];             /* link cost from host to host */
-    predecessor_table_ = new int[table_size * table_size];                /* predecessor host numbers */
-    link_table_        = new RouteCreationArgs*[table_size * table_size]; /* actual link between src and dst */
-
-    /* Initialize costs and predecessors */
-    for (unsigned int i = 0; i < table_size; i++)
-      for (unsigned int j = 0; j < table_size; j++) {
-        TO_FLOYD_COST(i, j) = DBL_MAX;
-        TO_FLOYD_PRED(i, j) = -1;
-        TO_FLOYD_LINK(i, j) = nullptr;
-      }
-  }
+  /* The shortest paths are only computed once, when sealing */
+  xbt_assert(predecessor_table_.empty(), "Cannot add a route from %s to %s to the netzone %s, which is already sealed.",
+             src->get_cname(), dst->get_cname(), get_cname());
 
   /* Check that the route does not already exist */
   if (gw_dst) // netzone route (to adapt the error message, if any)
-    xbt_assert(nullptr == TO_FLOYD_LINK(src->id(), dst->id()),
+    xbt_assert(nullptr == get_link(src->id(), dst->id()),
                "The route between %s@%s and %s@%s already exists (Rq: routes are symmetrical by default).",
                src->get_cname(), gw_src->get_cname(), dst->get_cname(), gw_dst->get_cname());
   else
-    xbt_assert(nullptr == TO_FLOYD_LINK(src->id(), dst->id()),
+    xbt_assert(nullptr == get_link(src->id(), dst->id()),
                "The route between %s and %s already exists (Rq: routes are symmetrical by default).", src->get_cname(),
                dst->get_cname());
 
-  TO_FLOYD_LINK(src->id(), dst->id()) =
-      new_extended_route(hierarchy_, src, dst, gw_src, gw_dst, link_list, symmetrical, 1);
-  TO_FLOYD_PRED(src->id(), dst->id()) = src->id();
-  TO_FLOYD_COST(src->id(), dst->id()) = (TO_FLOYD_LINK(src->id(), dst->id()))->link_list.size();
+  set_link(src->id(), dst->id(), new_extended_route(hierarchy_, src, dst, gw_src, gw_dst, link_list, symmetrical, 1));
 
   if (symmetrical == true) {
     if (gw_dst) // netzone route (to adapt the error message, if any)
       xbt_assert(
-          nullptr == TO_FLOYD_LINK(dst->id(), src->id()),
+          nullptr == get_link(dst->id(), src->id()),
           "The route between %s@%s and %s@%s already exists. You should not declare the reverse path as symmetrical.",
           dst->get_cname(), gw_dst->get_cname(), src->get_cname(), gw_src->get_cname());
     else
-      xbt_assert(nullptr == TO_FLOYD_LINK(dst->id(), src->id()),
+      xbt_assert(nullptr == get_link(dst->id(), src->id()),
                  "The route between %s and %s already exists. You should not declare the reverse path as symmetrical.",
                  dst->get_cname(), src->get_cname());
 
@@ -148,11 +131,7 @@ void FloydZone::add_route(NetPoint* src, NetPoint* dst, NetPoint* gw_src, NetPoi
       XBT_DEBUG("Load NetzoneRoute from \"%s(%s)\" to \"%s(%s)\"", dst->get_cname(), gw_src->get_cname(),
                 src->get_cname(), gw_dst->get_cname());
 
-    TO_FLOYD_LINK(dst->id(), src->id()) =
-        new_extended_route(hierarchy_, src, dst, gw_src, gw_dst, link_list, symmetrical, 0);
-    TO_FLOYD_PRED(dst->id(), src->id()) = dst->id();
-    TO_FLOYD_COST(dst->id(), src->id()) =
-        (TO_FLOYD_LINK(dst->id(), src->id()))->link_list.size(); /* count of links, old model assume 1 */
+    set_link(dst->id(), src->id(), new_extended_route(hierarchy_, src, dst, gw_src, gw_dst, link_list, symmetrical, 0));
   }
 }
 
@@ -161,46 +140,65 @@ void FloydZone::seal()
   /* set the size of table routing */
   unsigned int table_size = get_table_size();
 
-  if (not link_table_) {
-    /* Create Cost, Predecessor and Link tables */
-    cost_table_        = new double[table_size * table_size];             /* link cost from host to host */
-    predecessor_table_ = new int[table_size * table_size];                /* predecessor host numbers */
-    link_table_        = new RouteCreationArgs*[table_size * table_size]; /* actual link between src and dst */
-
-    /* Initialize costs and predecessors */
-    for (unsigned int i = 0; i < table_size; i++)
-      for (unsigned int j = 0; j < table_size; j++) {
-        TO_FLOYD_COST(i, j) = DBL_MAX;
-        TO_FLOYD_PRED(i, j) = -1;
-        TO_FLOYD_LINK(i, j) = nullptr;
-      }
-  }
-
   /* Add the loopback if needed */
   if (network_model_->loopback_ && hierarchy_ == RoutingMode::base) {
     for (unsigned int i = 0; i < table_size; i++) {
-      RouteCreationArgs* route = TO_FLOYD_LINK(i, i);
-      if (not route) {
-        route = new RouteCreationArgs();
+      if (not get_link(i, i)) {
+        RouteCreationArgs* route = new RouteCreationArgs();
         route->link_list.push_back(network_model_->loopback_);
-        TO_FLOYD_LINK(i, i) = route;
-        TO_FLOYD_PRED(i, i) = i;
-        TO_FLOYD_COST(i, i) = 1;
+        set_link(i, i, route);
       }
     }
   }
-  /* Calculate path costs */
-  for (unsigned int c = 0; c < table_size; c++) {
-    for (unsigned int a = 0; a < table_size; a++) {
-      for (unsigned int b = 0; b < table_size; b++) {
-        if (TO_FLOYD_COST(a, c) < DBL_MAX && TO_FLOYD_COST(c, b) < DBL_MAX &&
-            (fabs(TO_FLOYD_COST(a, b) - DBL_MAX) < std::numeric_limits<double>::epsilon() ||
-             (TO_FLOYD_COST(a, c) + TO_FLOYD_COST(c, b) < TO_FLOYD_COST(a, b)))) {
-          TO_FLOYD_COST(a, b) = TO_FLOYD_COST(a, c) + TO_FLOYD_COST(c, b);
-          TO_FLOYD_PRED(a, b) = TO_FLOYD_PRED(c, b);
-        }
+
+  /* Initialize costs and predecessors from the one-hop routes. The cost of a route is its count of links */
+  std::vector<double> cost_table(static_cast<size_t>(table_size) * table_size, DBL_MAX);
+  predecessor_table_.assign(static_cast<size_t>(table_size) * table_size, -1);
+  for (auto const& kv : link_table_) {
+    size_t src                = kv.first >> 32;
+    size_t dst                = kv.first & 0xffffffffULL;
+    size_t index              = src * table_size + dst;
+    cost_table[index]         = kv.second->link_list.size();
+    predecessor_table_[index] = static_cast<int>(src);
+  }
+
+  /* Calculate path costs. For a given intermediate point c, the row c does not change (going through c cannot shorten
+   * a path from c), so that the other rows can be updated concurrently with the very same result. */
+  auto relax_row = [this, table_size, &cost_table](unsigned int c, unsigned int a) {
+    const double cost_ac = cost_table[static_cast<size_t>(a) * table_size + c];
+    if (cost_ac >= DBL_MAX)
+      return;
+    const double* cost_c = &cost_table[static_cast<size_t>(c) * table_size];
+    const int* pred_c    = &predecessor_table_[static_cast<size_t>(c) * table_size];
+    double* cost_a       = &cost_table[static_cast<size_t>(a) * table_size];
+    int* pred_a          = &predecessor_table_[static_cast<size_t>(a) * table_size];
+    for (unsigned int b = 0; b < table_size; b++) {
+      if (cost_c[b] < DBL_MAX && (fabs(cost_a[b] - DBL_MAX) < std::numeric_limits<double>::epsilon() ||
+                                  (cost_ac + cost_c[b] < cost_a[b]))) {
+        cost_a[b] = cost_ac + cost_c[b];
+        pred_a[b] = pred_c[b];
       }
     }
+  };
+
+  if (cfg_floyd_threads > 1 && table_size > 1) {
+    const unsigned int rows_per_block = std::max(1U, table_size / (4U * cfg_floyd_threads));
+    std::vector<unsigned int> blocks;
+    for (unsigned int first = 0; first < table_size; first += rows_per_block)
+      blocks.push_back(first);
+    xbt::Parmap<unsigned int> parmap(cfg_floyd_threads, XBT_PARMAP_DEFAULT);
+    for (unsigned int c = 0; c < table_size; c++)
+      parmap.apply(
+          [&relax_row, c, rows_per_block, table_size](unsigned int first) {
+            unsigned int last = std::min(first + rows_per_block, table_size);
+            for (unsigned int a = first; a < last; a++)
+              relax_row(c, a);
+          },
+          blocks);
+  } else {
+    for (unsigned int c = 0; c < table_size; c++)
+      for (unsigned int a = 0; a < table_size; a++)
+        relax_row(c, a);
   }
 }
 }
@@ -11,7 +11,10 @@
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(surf_route_full, surf, "Routing part of surf");
 
-#define TO_ROUTE_FULL(i, j) routing_table_[(i) + (j)*table_size]
+static inline unsigned long long full_route_key(unsigned int src, unsigned int dst)
+{
+  return (static_cast<unsigned long long>(src) << 32) | dst;
+}
 
 namespace simgrid {
 namespace kernel {
@@ -25,41 +28,43 @@ void FullZone::seal()
 {
   unsigned int table_size = get_table_size();
 
-  /* Create table if needed */
-  if (not routing_table_)
-    routing_table_ = new RouteCreationArgs*[table_size * table_size]();
-
   /* Add the loopback if needed */
   if (network_model_->loopback_ && hierarchy_ == RoutingMode::base) {
     for (unsigned int i = 0; i < table_size; i++) {
-      RouteCreationArgs* route = TO_ROUTE_FULL(i, i);
-      if (not route) {
-        route = new RouteCreationArgs();
+      if (not get_route(i, i)) {
+        RouteCreationArgs* route = new RouteCreationArgs();
         route->link_list.push_back(network_model_->loopback_);
-        TO_ROUTE_FULL(i, i) = route;
+        routing_table_[full_route_key(i, i)] = share_route(route);
       }
     }
   }
+
+  /* A hashed route costs about 5 pointers (key, value, link to the next node, cached hash and bucket) while a cell of
+   * the dense matrix costs one: switch to the matrix when more than a fifth of the pairs have a route */
+  if (table_size > 0 && routing_table_.size() * 5 >= static_cast<size_t>(table_size) * table_size) {
+    dense_size_ = table_size;
+    dense_table_.assign(static_cast<size_t>(table_size) * table_size, nullptr);
+    for (auto const& kv : routing_table_)
+      dense_table_[(kv.first >> 32) * table_size + (kv.first & 0xffffffffULL)] = kv.second;
+    std::unordered_map<unsigned long long, RouteCreationArgs*>().swap(routing_table_);
+    XBT_DEBUG("Zone %s: the routes are stored in a dense matrix of %u points", get_cname(), table_size);
+  }
 }
 
-FullZone::~FullZone()
+RouteCreationArgs* FullZone::get_route(unsigned int src, unsigned int dst) const
 {
-  if (routing_table_) {
-    unsigned int table_size = get_table_size();
-    /* Delete routing table */
-    for (unsigned int i = 0; i < table_size; i++)
-      for (unsigned int j = 0; j < table_size; j++)
-        delete TO_ROUTE_FULL(i, j);
-    delete[] routing_table_;
-  }
+  if (not dense_table_.empty())
+    return src < dense_size_ && dst < dense_size_ ? dense_table_[static_cast<size_t>(src) * dense_size_ + dst]
+                                                  : nullptr;
+  auto it = routing_table_.find(full_route_key(src, dst));
+  return it == routing_table_.end() ? nullptr : it->second;
 }
 
 void FullZone::get_local_route(NetPoint* src, NetPoint* dst, RouteCreationArgs* res, double* lat)
 {
   XBT_DEBUG("full getLocalRoute from %s[%u] to %s[%u]", src->get_cname(), src->id(), dst->get_cname(), dst->id());
 
-  unsigned int table_size        = get_table_size();
-  RouteCreationArgs* e_route     = TO_ROUTE_FULL(src->id(), dst->id());
+  const RouteCreationArgs* e_route = get_route(src->id(), dst->id());
 
   if (e_route != nullptr) {
     res->gw_src = e_route->gw_src;
@@ -76,25 +81,22 @@ void FullZone::add_route(NetPoint* src, NetPoint* dst, NetPoint* gw_src, NetPoin
                          std::vector<resource::LinkImpl*>& link_list, bool symmetrical)
 {
   add_route_check_params(src, dst, gw_src, gw_dst, link_list, symmetrical);
-
-  unsigned int table_size = get_table_size();
-
-  if (not routing_table_)
-    routing_table_ = new RouteCreationArgs*[table_size * table_size]();
+  xbt_assert(dense_table_.empty(), "Cannot add a route from %s to %s to the netzone %s, which is already sealed.",
+             src->get_cname(), dst->get_cname(), get_cname());
 
   /* Check that the route does not already exist */
   if (gw_dst) // inter-zone route (to adapt the error message, if any)
-    xbt_assert(nullptr == TO_ROUTE_FULL(src->id(), dst->id()),
+    xbt_assert(nullptr == get_route(src->id(), dst->id()),
                "The route between %s@%s and %s@%s already exists (Rq: routes are symmetrical by default).",
                src->get_cname(), gw_src->get_cname(), dst->get_cname(), gw_dst->get_cname());
   else
-    xbt_assert(nullptr == TO_ROUTE_FULL(src->id(), dst->id()),
+    xbt_assert(nullptr == get_route(src->id(), dst->id()),
                "The route between %s and %s already exists (Rq: routes are symmetrical by default).", src->get_cname(),
                dst->get_cname());
 
   /* Add the route to the base */
-  TO_ROUTE_FULL(src->id(), dst->id()) =
-      new_extended_route(hierarchy_, src, dst, gw_src, gw_dst, link_list, symmetrical, true);
+  routing_table_[full_route_key(src->id(), dst->id())] =
+      share_route(new_extended_route(hierarchy_, src, dst, gw_src, gw_dst, link_list, symmetrical, true));
 
   if (symmetrical == true && src != dst) {
     if (gw_dst && gw_src) {
@@ -104,16 +106,16 @@ void FullZone::add_route(NetPoint* src, NetPoint* dst, NetPoint* gw_src, NetPoin
     }
     if (gw_dst && gw_src) // inter-zone route (to adapt the error message, if any)
       xbt_assert(
-          nullptr == TO_ROUTE_FULL(dst->id(), src->id()),
+          nullptr == get_route(dst->id(), src->id()),
           "The route between %s@%s and %s@%s already exists. You should not declare the reverse path as symmetrical.",
           dst->get_cname(), gw_dst->get_cname(), src->get_cname(), gw_src->get_cname());
     else
-      xbt_assert(nullptr == TO_ROUTE_FULL(dst->id(), src->id()),
+      xbt_assert(nullptr == get_route(dst->id(), src->id()),
                  "The route between %s and %s already exists. You should not declare the reverse path as symmetrical.",
                  dst->get_cname(), src->get_cname());
 
-    TO_ROUTE_FULL(dst->id(), src->id()) =
-        new_extended_route(hierarchy_, src, dst, gw_src, gw_dst, link_list, symmetrical, false);
+    routing_table_[full_route_key(dst->id(), src->id())] =
+        share_route(new_extended_route(hierarchy_, src, dst, gw_src, gw_dst, link_list, symmetrical, false));
   }
 }
 }
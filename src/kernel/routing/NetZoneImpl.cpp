@@ -7,13 +7,22 @@
 #include "simgrid/kernel/routing/NetPoint.hpp"
 #include "simgrid/s4u/Engine.hpp"
 #include "simgrid/s4u/Host.hpp"
+#include "simgrid/simix.h"
 #include "src/surf/cpu_interface.hpp"
 #include "src/surf/network_interface.hpp"
 #include "src/surf/xml/platf_private.hpp"
 #include "surf/surf.hpp"
+#include "xbt/config.hpp"
+
+#include <list>
+#include <unordered_map>
 
 XBT_LOG_EXTERNAL_DEFAULT_CATEGORY(surf_route);
 
+static simgrid::config::Flag<int> cfg_route_cache_size{
+    "network/route-cache-size", "Maximal amount of routes remembered between two hosts (0 to disable the cache)",
+    100000, [](int value) { xbt_assert(value >= 0, "The size of the route cache cannot be negative"); }};
+
 namespace simgrid {
 namespace kernel {
 namespace routing {
@@ -26,6 +35,42 @@ public:
   std::vector<resource::LinkImpl*> links;
 };
 
+/* Routes already computed by get_global_route(), indexed by (src, dst). The most recently used route is at the front
+ * of the list, and the least recently used one gets evicted when the cache is full. Only maestro uses the cache: the
+ * actors may run in parallel. */
+namespace {
+struct CachedRoute {
+  std::pair<NetPoint*, NetPoint*> key;
+  std::vector<resource::LinkImpl*> links;
+  double latency;
+};
+struct NetPointPairHash {
+  size_t operator()(const std::pair<NetPoint*, NetPoint*>& key) const
+  {
+    size_t h = std::hash<NetPoint*>()(key.first);
+    return h ^ (std::hash<NetPoint*>()(key.second) + 0x9e3779b9 + (h << 6) + (h >> 2));
+  }
+};
+std::list<CachedRoute> route_cache_lru;
+std::unordered_map<std::pair<NetPoint*, NetPoint*>, std::list<CachedRoute>::iterator, NetPointPairHash> route_cache;
+unsigned long route_cache_hits   = 0;
+unsigned long route_cache_misses = 0;
+} // namespace
+
+void NetZoneImpl::clear_route_cache()
+{
+  route_cache.clear();
+  route_cache_lru.clear();
+}
+unsigned long NetZoneImpl::get_route_cache_hits()
+{
+  return route_cache_hits;
+}
+unsigned long NetZoneImpl::get_route_cache_misses()
+{
+  return route_cache_misses;
+}
+
 NetZoneImpl::NetZoneImpl(NetZoneImpl* father, const std::string& name, resource::NetworkModel* network_model)
     : network_model_(network_model), piface_(this), father_(father), name_(name)
 {
@@ -44,6 +89,8 @@ NetZoneImpl::~NetZoneImpl()
   for (auto const& kv : bypass_routes_)
     delete kv.second;
 
+  clear_route_cache();
+
   simgrid::s4u::Engine::get_instance()->netpoint_unregister(netpoint_);
 }
 const char* NetZoneImpl::get_cname() const
@@ -114,6 +161,7 @@ simgrid::s4u::Host* NetZoneImpl::create_host(const char* name, const std::vector
 
 int NetZoneImpl::add_component(kernel::routing::NetPoint* elm)
 {
+  clear_route_cache();
   vertices_.push_back(elm);
   return vertices_.size() - 1; // The rank of the newly created object
 }
@@ -127,6 +175,8 @@ void NetZoneImpl::add_route(kernel::routing::NetPoint* /*src*/, kernel::routing:
 void NetZoneImpl::add_bypass_route(NetPoint* src, NetPoint* dst, NetPoint* gw_src, NetPoint* gw_dst,
                                    std::vector<resource::LinkImpl*>& link_list, bool /* symmetrical */)
 {
+  clear_route_cache();
+
   /* Argument validity checks */
   if (gw_dst) {
     XBT_DEBUG("Load bypassNetzoneRoute from %s@%s to %s@%s", src->get_cname(), gw_src->get_cname(), dst->get_cname(),
@@ -357,14 +407,14 @@ bool NetZoneImpl::get_bypass_route(routing::NetPoint* src, routing::NetPoint* ds
               "calls to getRoute",
               src->get_cname(), dst->get_cname(), bypassedRoute->links.size());
     if (src != key.first)
-      get_global_route(src, bypassedRoute->gw_src, links, latency);
+      resolve_global_route(src, bypassedRoute->gw_src, links, latency);
     for (resource::LinkImpl* const& link : bypassedRoute->links) {
       links.push_back(link);
       if (latency)
         *latency += link->get_latency();
     }
     if (dst != key.second)
-      get_global_route(bypassedRoute->gw_dst, dst, links, latency);
+      resolve_global_route(bypassedRoute->gw_dst, dst, links, latency);
     return true;
   }
   XBT_DEBUG("No bypass route from '%s' to '%s'.", src->get_cname(), dst->get_cname());
@@ -373,6 +423,43 @@ bool NetZoneImpl::get_bypass_route(routing::NetPoint* src, routing::NetPoint* ds
 
 void NetZoneImpl::get_global_route(NetPoint* src, NetPoint* dst,
                                    /* OUT */ std::vector<resource::LinkImpl*>& links, double* latency)
+{
+  /* Only use the cache when the latency accumulator starts from 0, so that the additions happen in the same order (and
+   * give the very same result) as when resolving the route */
+  if (cfg_route_cache_size == 0 || (latency != nullptr && *latency != 0.0) || not SIMIX_is_maestro()) {
+    resolve_global_route(src, dst, links, latency);
+    return;
+  }
+
+  std::list<CachedRoute>::iterator cached;
+  auto known = route_cache.find({src, dst});
+  if (known == route_cache.end()) {
+    route_cache_misses++;
+    CachedRoute route;
+    route.key     = {src, dst};
+    route.latency = 0.0;
+    resolve_global_route(src, dst, route.links, &route.latency); // May use the cache for the routes between gateways
+    if (route_cache.size() >= static_cast<unsigned>(cfg_route_cache_size)) {
+      XBT_DEBUG("Route cache full (%zu routes), evicting the least recently used one", route_cache.size());
+      route_cache.erase(route_cache_lru.back().key);
+      route_cache_lru.pop_back();
+    }
+    route_cache_lru.push_front(std::move(route));
+    cached = route_cache_lru.begin();
+    route_cache.emplace(cached->key, cached);
+  } else {
+    route_cache_hits++;
+    cached = known->second;
+    route_cache_lru.splice(route_cache_lru.begin(), route_cache_lru, cached);
+  }
+
+  links.insert(links.end(), cached->links.begin(), cached->links.end());
+  if (latency)
+    *latency += cached->latency;
+}
+
+void NetZoneImpl::resolve_global_route(NetPoint* src, NetPoint* dst,
+                                       /* OUT */ std::vector<resource::LinkImpl*>& links, double* latency)
 {
   RouteCreationArgs route;
 
@@ -406,13 +493,13 @@ void NetZoneImpl::get_global_route(NetPoint* src, NetPoint* dst,
 
   /* If source gateway is not our source, we have to recursively find our way up to this point */
   if (src != route.gw_src)
-    get_global_route(src, route.gw_src, links, latency);
+    resolve_global_route(src, route.gw_src, links, latency);
   for (auto const& link : route.link_list)
     links.push_back(link);
 
   /* If dest gateway is not our destination, we have to recursively find our way from this point */
   if (route.gw_dst != dst)
-    get_global_route(route.gw_dst, dst, links, latency);
+    resolve_global_route(route.gw_dst, dst, links, latency);
 }
 }
 }
@@ -64,6 +64,12 @@ RoutedZone::RoutedZone(NetZoneImpl* father, const std::string& name, resource::N
 {
 }
 
+RoutedZone::~RoutedZone()
+{
+  for (auto const& kv : shared_routes_)
+    delete kv.second;
+}
+
 void RoutedZone::get_graph(xbt_graph_t graph, std::map<std::string, xbt_node_t>* nodes,
                            std::map<std::string, xbt_edge_t>* edges)
 {
@@ -149,6 +155,31 @@ RouteCreationArgs* RoutedZone::new_extended_route(RoutingMode hierarchy, NetPoin
   return result;
 }
 
+/** @brief Returns a route identical to the given one that is shared by all the users of this netzone
+ *
+ * Large netzones often use the same link list between many pairs of points (the loopback, or the up and down links of
+ * a cluster). The given route is either registered, or deleted if an identical route was already registered. Either
+ * way, the returned route belongs to this netzone and must not be deleted by the caller.
+ */
+RouteCreationArgs* RoutedZone::share_route(RouteCreationArgs* route)
+{
+  size_t hash = std::hash<NetPoint*>()(route->gw_src);
+  hash ^= std::hash<NetPoint*>()(route->gw_dst) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  for (auto const* link : route->link_list)
+    hash ^= std::hash<const resource::LinkImpl*>()(link) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+
+  auto candidates = shared_routes_.equal_range(hash);
+  for (auto it = candidates.first; it != candidates.second; ++it) {
+    RouteCreationArgs* known = it->second;
+    if (known->gw_src == route->gw_src && known->gw_dst == route->gw_dst && known->link_list == route->link_list) {
+      delete route;
+      return known;
+    }
+  }
+  shared_routes_.emplace(hash, route);
+  return route;
+}
+
 void RoutedZone::get_route_check_params(NetPoint* src, NetPoint* dst)
 {
   xbt_assert(src, "Cannot find a route from nullptr to %s", dst->get_cname());
@@ -203,6 +234,7 @@ void RoutedZone::add_route_check_params(NetPoint* src, NetPoint* dst, NetPoint*
                dstName, gw_dst->get_cname());
   }
 
+  clear_route_cache();
   simgrid::s4u::NetZone::on_route_creation(symmetrical, src, dst, gw_src, gw_dst, link_list);
 }
 }
@@ -6,12 +6,15 @@
 #ifndef SIMGRID_MC_MODEL_CHECKER_HPP
 #define SIMGRID_MC_MODEL_CHECKER_HPP
 
+#include "src/mc/sosp/ChunkedData.hpp"
 #include "src/mc/sosp/PageStore.hpp"
 #include "xbt/base.h"
 
 #include <memory>
 #include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <event2/event.h>
 
@@ -27,8 +30,9 @@ class ModelChecker {
   /** String pool for host names */
   // TODO, use std::set with heterogeneous comparison lookup (C++14)?
   std::set<std::string> hostnames_;
-  // This is the parent snapshot of the current state:
   PageStore page_store_;
+  // This is the parent snapshot of the current state (start and pages of its regions, with model-check/soft-dirty):
+  std::vector<std::pair<RemotePtr<void>, ChunkedData>> parent_regions_;
   std::unique_ptr<RemoteClient> process_;
   Checker* checker_ = nullptr;
 public:
@@ -44,6 +48,9 @@ public:
     return page_store_;
   }
 
+  /** Regions of the last snapshot taken or restored. The pages that are not soft-dirty are still the same. */
+  std::vector<std::pair<RemotePtr<void>, ChunkedData>>& parent_regions() { return parent_regions_; }
+
   std::string const& get_host_name(std::string const& hostname)
   {
     return *this->hostnames_.insert(hostname).first;
@@ -31,6 +31,9 @@ public:
    * * random can produce different values.
    */
   int argument_ = 0;
+
+  bool operator==(const Transition& that) const { return pid_ == that.pid_ && argument_ == that.argument_; }
+  bool operator!=(const Transition& that) const { return not(*this == that); }
 };
 
 } // namespace mc
@@ -8,8 +8,8 @@
 
 #include <unistd.h>
 #include <sys/wait.h>
+#include <algorithm>
 #include <memory>
-#include <boost/range/algorithm.hpp>
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(mc_VisitedState, mc, "Logging specific to state equality detection mechanisms");
 
@@ -32,15 +32,18 @@ VisitedState::VisitedState(unsigned long state_number) : num(state_number)
 
 void VisitedStates::prune()
 {
-  while (states_.size() > (std::size_t)_sg_mc_max_visited_states) {
+  while (hash_by_num_.size() > (std::size_t)_sg_mc_max_visited_states) {
     XBT_DEBUG("Try to remove visited state (maximum number of stored states reached)");
-    auto min_element = boost::range::min_element(states_,
-      [](std::unique_ptr<simgrid::mc::VisitedState>& a, std::unique_ptr<simgrid::mc::VisitedState>& b) {
-        return a->num < b->num;
-      });
-    xbt_assert(min_element != states_.end());
-    // and drop it:
-    states_.erase(min_element);
+    auto oldest = hash_by_num_.begin();
+    auto bucket = states_.find(oldest->second);
+    xbt_assert(bucket != states_.end());
+    int num    = oldest->first;
+    auto state = std::find_if(bucket->second.begin(), bucket->second.end(),
+                              [num](std::unique_ptr<simgrid::mc::VisitedState>& elm) { return elm->num == num; });
+    bucket->second.erase(state);
+    if (bucket->second.empty())
+      states_.erase(bucket);
+    hash_by_num_.erase(oldest);
     XBT_DEBUG("Remove visited state (maximum number of stored states reached)");
   }
 }
@@ -55,12 +58,15 @@ VisitedStates::addVisitedState(unsigned long state_number, simgrid::mc::State* g
   XBT_DEBUG("Snapshot %p of visited state %d (exploration stack state %d)", new_state->system_state.get(),
             new_state->num, graph_state->num_);
 
-  auto range =
-      boost::range::equal_range(states_, new_state.get(), simgrid::mc::DerefAndCompareByActorsCountAndUsedHeap());
+  hash_type hash = new_state->system_state->hash_;
+  auto& candidates = states_[hash];
 
   if (compare_snapshots)
-    for (auto i = range.first; i != range.second; ++i) {
-      auto& visited_state = *i;
+    for (auto& visited_state : candidates) {
+      if (visited_state->actors_count != new_state->actors_count ||
+          visited_state->heap_bytes_used != new_state->heap_bytes_used)
+        continue;
+      comparisons_++;
       if (snapshot_equal(visited_state->system_state.get(), new_state->system_state.get())) {
         // The state has been visited:
 
@@ -85,16 +91,26 @@ VisitedStates::addVisitedState(unsigned long state_number, simgrid::mc::State* g
         XBT_DEBUG("Replace visited state %d with the new visited state %d",
           old_state->num, new_state->num);
 
+        hash_by_num_.erase(old_state->num);
+        hash_by_num_.emplace(new_state->num, hash);
         visited_state = std::move(new_state);
         return old_state;
       }
+      collisions_++;
+      XBT_DEBUG("State %d has the same hash as state %d, but differs", new_state->num, visited_state->num);
     }
 
-  XBT_DEBUG("Insert new visited state %d (total : %lu)", new_state->num, (unsigned long) states_.size());
-  states_.insert(range.first, std::move(new_state));
+  XBT_DEBUG("Insert new visited state %d (total : %lu)", new_state->num, (unsigned long)hash_by_num_.size());
+  hash_by_num_.emplace(new_state->num, hash);
+  candidates.push_back(std::move(new_state));
   this->prune();
   return nullptr;
 }
 
+void VisitedStates::log_statistics() const
+{
+  XBT_INFO("Visited states comparisons = %lu (%lu between states of same hash that differed)", comparisons_,
+           collisions_);
+}
 }
 }
@@ -6,11 +6,15 @@
 #ifndef SIMGRID_MC_VISITED_STATE_HPP
 #define SIMGRID_MC_VISITED_STATE_HPP
 
+#include "src/mc/mc_hash.hpp"
 #include "src/mc/mc_state.hpp"
 #include "src/mc/sosp/Snapshot.hpp"
 
 #include <cstddef>
+#include <map>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace simgrid {
 namespace mc {
@@ -27,12 +31,27 @@ public:
   ~VisitedState() = default;
 };
 
+/** @brief Set of the visited states, indexed by the hash of their snapshot
+ *
+ * A new state is only compared to the visited states having the same hash, which is computed from what
+ * snapshot_equal() requires to be identical (see simgrid::mc::hash()). The full comparisons of states that turn out to
+ * be different are counted as collisions.
+ */
 class XBT_PRIVATE VisitedStates {
-  std::vector<std::unique_ptr<simgrid::mc::VisitedState>> states_;
+  std::unordered_map<hash_type, std::vector<std::unique_ptr<simgrid::mc::VisitedState>>> states_;
+  std::map<int, hash_type> hash_by_num_; // to drop the oldest states first
+  unsigned long comparisons_ = 0;
+  unsigned long collisions_  = 0;
+
 public:
-  void clear() { states_.clear(); }
+  void clear()
+  {
+    states_.clear();
+    hash_by_num_.clear();
+  }
   std::unique_ptr<simgrid::mc::VisitedState> addVisitedState(unsigned long state_number,
                                                              simgrid::mc::State* graph_state, bool compare_snapshots);
+  void log_statistics() const;
 
 private:
   void prune();
@@ -0,0 +1,345 @@
+/* Copyright (c) 2019. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#include "src/mc/checker/Coordinator.hpp"
+#include "src/mc/Session.hpp"
+#include "src/mc/checker/SafetyChecker.hpp"
+#include "src/mc/mc_config.hpp"
+#include "src/mc/mc_exit.hpp"
+#include "xbt/log.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+
+XBT_LOG_NEW_DEFAULT_SUBCATEGORY(mc_Coordinator, mc, "Distribution of the exploration among several processes");
+
+namespace simgrid {
+namespace mc {
+
+namespace {
+struct WorkMessageHeader {
+  WorkMessageType type;
+  int pid;
+  std::size_t size; // size of the payload following the header
+};
+
+/** How often the busy workers are asked again to give away some work (in ms) */
+constexpr int SPLIT_RETRY_PERIOD = 100;
+}
+
+WorkChannel::~WorkChannel()
+{
+  if (socket_ >= 0)
+    ::close(socket_);
+}
+
+void WorkChannel::send(WorkMessageType type, int pid, const void* payload, std::size_t size) const
+{
+  WorkMessageHeader header = {type, pid, size};
+  std::vector<char> buffer(sizeof(header) + size);
+  std::memcpy(buffer.data(), &header, sizeof(header));
+  if (size > 0)
+    std::memcpy(buffer.data() + sizeof(header), payload, size);
+  while (::send(socket_, buffer.data(), buffer.size(), 0) == -1)
+    xbt_assert(errno == EINTR, "Could not send a work message: %s", strerror(errno));
+}
+
+void WorkChannel::send(const WorkItem& item, WorkMessageType type) const
+{
+  send(type, item.pid, item.prefix.data(), item.prefix.size() * sizeof(Transition));
+}
+
+void WorkChannel::send(const WorkStatistics& statistics) const
+{
+  send(WorkMessageType::STATISTICS, -1, &statistics, sizeof(statistics));
+}
+
+bool WorkChannel::receive(WorkMessageType& type, WorkItem& item, WorkStatistics& statistics, bool block) const
+{
+  // Get the size of the pending message first
+  ssize_t size;
+  do {
+    size = recv(socket_, nullptr, 0, MSG_PEEK | MSG_TRUNC | (block ? 0 : MSG_DONTWAIT));
+  } while (size == -1 && errno == EINTR);
+  if (size == -1 && not block && (errno == EAGAIN || errno == EWOULDBLOCK))
+    return false;
+  xbt_assert(size != -1, "Could not receive a work message: %s", strerror(errno));
+  if (size == 0)
+    return false;
+
+  std::vector<char> buffer(size);
+  ssize_t received;
+  do {
+    received = recv(socket_, buffer.data(), buffer.size(), 0);
+  } while (received == -1 && errno == EINTR);
+  WorkMessageHeader header;
+  xbt_assert(received == size && static_cast<std::size_t>(size) >= sizeof(header), "Broken work message");
+  std::memcpy(&header, buffer.data(), sizeof(header));
+  xbt_assert(sizeof(header) + header.size == static_cast<std::size_t>(size), "Broken work message");
+  const char* payload = buffer.data() + sizeof(header);
+
+  type = header.type;
+  if (type == WorkMessageType::WORK || type == WorkMessageType::MERGE) {
+    item.pid = header.pid;
+    item.prefix.resize(header.size / sizeof(Transition));
+    if (header.size > 0)
+      std::memcpy(item.prefix.data(), payload, header.size);
+  } else if (type == WorkMessageType::STATISTICS) {
+    xbt_assert(header.size == sizeof(statistics), "Broken statistics message");
+    std::memcpy(&statistics, payload, sizeof(statistics));
+  }
+  return true;
+}
+
+/** Main function of the worker processes */
+static int worker_main(int socket, const std::function<void()>& code)
+{
+#ifdef __linux__
+  // Make sure we do not outlive the coordinator
+  int prctl_res = prctl(PR_SET_PDEATHSIG, SIGHUP);
+  xbt_assert(prctl_res == 0, "Could not PR_SET_PDEATHSIG");
+#endif
+  WorkChannel channel(socket);
+  simgrid::mc::session = new simgrid::mc::Session(code);
+
+  int res = SIMGRID_MC_EXIT_SUCCESS;
+  {
+    SafetyChecker checker(*simgrid::mc::session, &channel);
+    try {
+      checker.run();
+    } catch (const simgrid::mc::DeadlockError&) {
+      res = SIMGRID_MC_EXIT_DEADLOCK;
+    } catch (const simgrid::mc::TerminationError&) {
+      res = SIMGRID_MC_EXIT_NON_TERMINATION;
+    }
+  }
+  simgrid::mc::session->close();
+  return res;
+}
+
+/** Returns the busy worker (other than the sender) that explores the deepest subtree containing the root of the item */
+Coordinator::Worker* Coordinator::find_owner(const WorkItem& item, const Worker* sender)
+{
+  Worker* owner = nullptr;
+  for (Worker& worker : workers_) {
+    if (&worker == sender || worker.idle || worker.finished)
+      continue;
+    const RecordTrace& prefix = worker.item.prefix;
+    // The root state of a subtree only belongs to its worker if it explores all its actors
+    if (item.prefix.size() < prefix.size() + (worker.item.pid == -1 ? 0 : 1) ||
+        not std::equal(prefix.begin(), prefix.end(), item.prefix.begin()) ||
+        (worker.item.pid != -1 && item.prefix[prefix.size()].pid_ != worker.item.pid))
+      continue;
+    if (owner == nullptr || owner->item.prefix.size() < prefix.size())
+      owner = &worker;
+  }
+  return owner;
+}
+
+void Coordinator::add_item(WorkItem&& item, const Worker* sender)
+{
+  Worker* owner = find_owner(item, sender);
+  if (owner != nullptr) {
+    XBT_DEBUG("Merge the subtree of actor %d after [%s] into worker %d", item.pid,
+              traceToString(item.prefix).c_str(), static_cast<int>(owner->pid));
+    owner->channel->send(item, WorkMessageType::MERGE);
+    owner->pending_merges++;
+    return;
+  }
+  std::string key = std::to_string(item.pid) + "@" + traceToString(item.prefix);
+  if (not known_items_.insert(std::move(key)).second)
+    return;
+  XBT_DEBUG("New subtree: actor %d after [%s]", item.pid, traceToString(item.prefix).c_str());
+  pending_items_.push_back(std::move(item));
+}
+
+/** Gives the pending subtrees to the idle workers, and asks the busy ones for more if needed */
+void Coordinator::dispatch()
+{
+  if (stopping_)
+    return;
+  for (Worker& worker : workers_) {
+    if (pending_items_.empty())
+      break;
+    if (worker.idle) {
+      worker.item = std::move(pending_items_.front());
+      pending_items_.pop_front();
+      worker.channel->send(worker.item);
+      worker.idle = false;
+    }
+  }
+
+  bool someone_idle = false;
+  bool all_idle     = true;
+  for (Worker const& worker : workers_) {
+    someone_idle = someone_idle || worker.idle;
+    all_idle     = all_idle && worker.idle && worker.pending_merges == 0;
+  }
+
+  if (all_idle && pending_items_.empty()) {
+    XBT_DEBUG("All workers are idle: the exploration is over");
+    stopping_ = true;
+    for (Worker const& worker : workers_)
+      worker.channel->send(WorkMessageType::STOP);
+  } else if (someone_idle && pending_items_.empty()) {
+    for (Worker& worker : workers_)
+      if (not worker.idle && not worker.asked_split && not worker.refused_split) {
+        worker.channel->send(WorkMessageType::SPLIT);
+        worker.asked_split = true;
+      }
+  }
+}
+
+/** Handles the next message of that worker. Returns false if it closed its channel */
+bool Coordinator::handle_message(Worker& worker)
+{
+  WorkMessageType type;
+  WorkItem item;
+  WorkStatistics statistics;
+  if (not worker.channel->receive(type, item, statistics))
+    return false;
+
+  switch (type) {
+    case WorkMessageType::REQUEST:
+      worker.idle = true;
+      break;
+    case WorkMessageType::WORK:
+      worker.asked_split = false;
+      add_item(std::move(item), &worker);
+      break;
+    case WorkMessageType::MERGED:
+      worker.pending_merges--;
+      break;
+    case WorkMessageType::NO_WORK:
+      worker.asked_split   = false;
+      worker.refused_split = true;
+      break;
+    case WorkMessageType::STATISTICS:
+      statistics_.expanded_states += statistics.expanded_states;
+      statistics_.visited_states += statistics.visited_states;
+      statistics_.executed_transitions += statistics.executed_transitions;
+      break;
+    default:
+      xbt_die("Unexpected message from worker %d", static_cast<int>(worker.pid));
+  }
+  return true;
+}
+
+/** Reaps a worker that closed its channel, and returns its exit code */
+int Coordinator::wait_worker(Worker& worker)
+{
+  int status;
+  pid_t res;
+  do {
+    res = waitpid(worker.pid, &status, 0);
+  } while (res == -1 && errno == EINTR);
+  xbt_assert(res == worker.pid, "Could not wait for worker %d", static_cast<int>(worker.pid));
+  worker.finished = true;
+  worker.channel.reset();
+  return WIFEXITED(status) ? WEXITSTATUS(status) : SIMGRID_MC_EXIT_ERROR;
+}
+
+void Coordinator::kill_workers()
+{
+  for (Worker& worker : workers_)
+    if (not worker.finished) {
+      kill(worker.pid, SIGKILL);
+      wait_worker(worker);
+    }
+}
+
+int Coordinator::run(int worker_count, const std::function<void()>& code)
+{
+  xbt_assert(_sg_mc_dot_output_file.get().empty(), "The dot output is not supported with several workers");
+  XBT_INFO("Explore the state space with %d workers", worker_count);
+
+  for (int i = 0; i < worker_count; i++) {
+    int sockets[2];
+    int res = socketpair(AF_LOCAL, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sockets);
+    xbt_assert(res != -1, "Could not create socketpair");
+    pid_t pid = fork();
+    xbt_assert(pid >= 0, "Could not fork model-checker worker");
+    if (pid == 0) { // Worker
+      ::close(sockets[1]);
+      workers_.clear();
+      ::exit(worker_main(sockets[0], code));
+    }
+    ::close(sockets[0]);
+    workers_.emplace_back(pid, sockets[1]);
+  }
+
+  /* The first worker that asks for work explores the whole graph, until it is asked to give a part of it away */
+  add_item(WorkItem());
+
+  int res             = SIMGRID_MC_EXIT_SUCCESS;
+  std::size_t running = workers_.size();
+  std::vector<pollfd> fds;
+  std::vector<Worker*> polled;
+  auto last_retry = std::chrono::steady_clock::now();
+  while (running > 0 && res == SIMGRID_MC_EXIT_SUCCESS) {
+    dispatch();
+
+    fds.clear();
+    polled.clear();
+    for (Worker& worker : workers_)
+      if (not worker.finished) {
+        fds.push_back({worker.channel->get_socket(), POLLIN, 0});
+        polled.push_back(&worker);
+      }
+    int ready = poll(fds.data(), fds.size(), SPLIT_RETRY_PERIOD);
+    xbt_assert(ready != -1 || errno == EINTR, "Could not poll the workers: %s", strerror(errno));
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_retry >= std::chrono::milliseconds(SPLIT_RETRY_PERIOD)) {
+      // Ask again the workers that had nothing to give away, their exploration went on since then
+      for (Worker& worker : workers_)
+        worker.refused_split = false;
+      last_retry = now;
+    }
+    if (ready <= 0)
+      continue;
+
+    for (std::size_t i = 0; i < fds.size(); i++) {
+      if (fds[i].revents == 0)
+        continue;
+      Worker& worker = *polled[i];
+      if (not handle_message(worker)) {
+        int status = wait_worker(worker);
+        running--;
+        if (status != SIMGRID_MC_EXIT_SUCCESS || not stopping_) {
+          XBT_INFO("Worker %d exited with status %d", static_cast<int>(worker.pid), status);
+          res = status == SIMGRID_MC_EXIT_SUCCESS ? SIMGRID_MC_EXIT_ERROR : status;
+          break;
+        }
+      }
+    }
+  }
+
+  if (res != SIMGRID_MC_EXIT_SUCCESS) {
+    kill_workers();
+    return res;
+  }
+  XBT_INFO("No property violation found.");
+  XBT_INFO("Expanded states = %lu", statistics_.expanded_states);
+  XBT_INFO("Visited states = %lu", statistics_.visited_states);
+  XBT_INFO("Executed transitions = %lu", statistics_.executed_transitions);
+  return res;
+}
+
+int check_safety_in_parallel(int worker_count, const std::function<void()>& code)
+{
+  return Coordinator().run(worker_count, code);
+}
+}
+}
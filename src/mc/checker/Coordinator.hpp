@@ -0,0 +1,129 @@
+/* Copyright (c) 2019. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#ifndef SIMGRID_MC_COORDINATOR_HPP
+#define SIMGRID_MC_COORDINATOR_HPP
+
+#include "src/mc/Transition.hpp"
+#include "src/mc/mc_record.hpp"
+#include "xbt/base.h"
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <set>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+namespace simgrid {
+namespace mc {
+
+enum class WorkMessageType {
+  REQUEST,    // worker -> coordinator: the worker is idle
+  WORK,       // both ways: a subtree to explore
+  SPLIT,      // coordinator -> worker: give away a part of your subtree
+  NO_WORK,    // worker -> coordinator: nothing to give away
+  MERGE,      // coordinator -> worker: a subtree found by another worker in the part of the graph that you explore
+  MERGED,     // worker -> coordinator: the merged subtree was added to yours, or sent back as WORK
+  STATISTICS, // worker -> coordinator: exploration statistics, sent before exiting
+  STOP,       // coordinator -> worker: the exploration is over
+};
+
+/** A subtree of the exploration graph
+ *
+ *  Its root is reached from the initial state by executing the transitions of the prefix, and it is explored by
+ *  executing the given actor from there (or the actors that the checker selects in the initial state, if pid is -1).
+ */
+struct WorkItem {
+  RecordTrace prefix;
+  int pid = -1;
+};
+
+struct WorkStatistics {
+  unsigned long expanded_states;
+  unsigned long visited_states;
+  unsigned long executed_transitions;
+};
+
+/** A channel for exchanging messages between the coordinator and a worker of a parallel exploration
+ *
+ *  The messages are sent over a (connected) `SOCK_SEQPACKET` socket, as a header followed by the transitions of the
+ *  work item or by the statistics.
+ */
+class XBT_PRIVATE WorkChannel {
+  int socket_;
+
+  void send(WorkMessageType type, int pid, const void* payload, std::size_t size) const;
+
+public:
+  explicit WorkChannel(int socket) : socket_(socket) {}
+  ~WorkChannel();
+
+  // No copy:
+  WorkChannel(WorkChannel const&) = delete;
+  WorkChannel& operator=(WorkChannel const&) = delete;
+
+  int get_socket() const { return socket_; }
+
+  void send(WorkMessageType type) const { send(type, -1, nullptr, 0); }
+  void send(const WorkItem& item, WorkMessageType type = WorkMessageType::WORK) const;
+  void send(const WorkStatistics& statistics) const;
+
+  /** Receives a message, and the work item or the statistics that it carries
+   *
+   *  Returns false if the peer closed the channel, or if no message is pending in non-blocking mode. */
+  bool receive(WorkMessageType& type, WorkItem& item, WorkStatistics& statistics, bool block = true) const;
+};
+
+/** Distributes the exploration of the state space of a safety property among several model-checker processes
+ *
+ *  Each worker is a fork of simgrid-mc driving its own model-checked process, which explores the subtrees given by
+ *  the coordinator with a SafetyChecker. The subtrees found by the reduction in a part of the graph that belongs to
+ *  another worker are sent back to the coordinator, and the busy workers are asked to give away a part of their
+ *  subtree whenever a worker is idle. The exploration is over when all workers are idle and no subtree is pending.
+ *
+ *  A subtree found in the part of the graph explored by a busy worker is merged into the exploration of that worker,
+ *  which drops it if the state was already explored or scheduled for that actor. The other subtrees are only
+ *  deduplicated among the ones that went through the coordinator: a subtree whose state was already left by the
+ *  worker that owned it may thus be explored twice, which wastes some time but does not change the verdict.
+ */
+class XBT_PRIVATE Coordinator {
+  struct Worker {
+    pid_t pid;
+    std::unique_ptr<WorkChannel> channel;
+    WorkItem item; // subtree being explored, if not idle
+    int pending_merges = 0;
+    bool idle          = false;
+    bool asked_split   = false;
+    bool refused_split = false;
+    bool finished      = false;
+    Worker(pid_t p, int socket) : pid(p), channel(new WorkChannel(socket)) {}
+  };
+
+  std::vector<Worker> workers_;
+  std::deque<WorkItem> pending_items_;
+  std::set<std::string> known_items_; // items already queued, to not explore the same subtree twice
+  WorkStatistics statistics_ = {0, 0, 0};
+  bool stopping_             = false;
+
+  Worker* find_owner(const WorkItem& item, const Worker* sender);
+  void add_item(WorkItem&& item, const Worker* sender = nullptr);
+  void dispatch();
+  bool handle_message(Worker& worker);
+  int wait_worker(Worker& worker);
+  void kill_workers();
+
+public:
+  int run(int worker_count, const std::function<void()>& code);
+};
+
+/** Checks a safety property with several worker processes; returns the exit code of simgrid-mc */
+XBT_PUBLIC int check_safety_in_parallel(int worker_count, const std::function<void()>& code);
+}
+}
+
+#endif
@@ -4,8 +4,10 @@
  * under the terms of the license (GNU LGPL) which comes with this package. */
 
 #include <cassert>
+#include <chrono>
 #include <cstdio>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -16,7 +18,9 @@
 #include "src/mc/Session.hpp"
 #include "src/mc/Transition.hpp"
 #include "src/mc/VisitedState.hpp"
+#include "src/mc/checker/Coordinator.hpp"
 #include "src/mc/checker/SafetyChecker.hpp"
+#include "src/mc/mc_checkpoint.hpp"
 #include "src/mc/mc_config.hpp"
 #include "src/mc/mc_exit.hpp"
 #include "src/mc/mc_private.hpp"
@@ -31,6 +35,25 @@ XBT_LOG_NEW_DEFAULT_SUBCATEGORY(mc_safety, mc,
 namespace simgrid {
 namespace mc {
 
+/** How many states a worker visits between two checks of the messages of the coordinator */
+static constexpr unsigned long COORDINATOR_POLL_PERIOD = 32;
+
+/* Folds a new measure into an average that follows the recent measures */
+static void update_average(double& average, double measure)
+{
+  average = average == 0 ? measure : 0.9 * average + 0.1 * measure;
+}
+
+static double seconds_since(std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool has_snapshot(std::unique_ptr<simgrid::mc::State> const& state)
+{
+  return state->system_state != nullptr;
+}
+
 void SafetyChecker::check_non_termination(simgrid::mc::State* current_state)
 {
   for (auto state = stack_.rbegin(); state != stack_.rend(); ++state)
@@ -75,16 +98,52 @@ void SafetyChecker::log_state() // override
   XBT_INFO("Expanded states = %lu", expanded_states_count_);
   XBT_INFO("Visited states = %lu", mc_model_checker->visited_states);
   XBT_INFO("Executed transitions = %lu", mc_model_checker->executed_transitions);
+  if (_sg_mc_max_visited_states > 0)
+    visited_states_.log_statistics();
 }
 
 void SafetyChecker::run()
+{
+  if (work_channel_ == nullptr) {
+    this->explore();
+    XBT_INFO("No property violation found.");
+    simgrid::mc::session->log_state();
+    return;
+  }
+
+  /* Explore the subtrees given by the coordinator, until it tells us that the exploration is over */
+  WorkMessageType type;
+  WorkItem item;
+  WorkStatistics statistics;
+  work_channel_->send(WorkMessageType::REQUEST);
+  while (work_channel_->receive(type, item, statistics)) {
+    if (type == WorkMessageType::STOP)
+      break;
+    if (type == WorkMessageType::SPLIT) { // Sent before we asked for work: we have nothing to give away anymore
+      work_channel_->send(WorkMessageType::NO_WORK);
+      continue;
+    }
+    if (type == WorkMessageType::MERGE) { // Same, we do not own that subtree anymore
+      work_channel_->send(item);
+      work_channel_->send(WorkMessageType::MERGED);
+      continue;
+    }
+    xbt_assert(type == WorkMessageType::WORK, "Unexpected message from the coordinator");
+    this->start_work(item);
+    this->explore();
+    work_channel_->send(WorkMessageType::REQUEST);
+  }
+  statistics = {expanded_states_count_, mc_model_checker->visited_states, mc_model_checker->executed_transitions};
+  work_channel_->send(statistics);
+}
+
+void SafetyChecker::explore()
 {
   /* This function runs the DFS algorithm the state space.
    * We do so iteratively instead of recursively, dealing with the call stack manually.
    * This allows one to explore the call stack at will. */
 
-  while (not stack_.empty()) {
-
+  while (stack_.size() > root_depth_) {
     /* Get current state */
     simgrid::mc::State* state = stack_.back().get();
 
@@ -94,6 +153,9 @@ void SafetyChecker::run()
 
     mc_model_checker->visited_states++;
 
+    if (work_channel_ != nullptr && mc_model_checker->visited_states % COORDINATOR_POLL_PERIOD == 0)
+      this->handle_coordinator_messages();
+
     // Backtrack if we reached the maximum depth
     if (stack_.size() > (std::size_t)_sg_mc_max_depth) {
       XBT_WARN("/!\\ Max depth reached ! /!\\ ");
@@ -136,7 +198,9 @@ void SafetyChecker::run()
     mc_model_checker->executed_transitions++;
 
     /* Actually answer the request: let execute the selected request (MCed does one step) */
+    auto start = std::chrono::steady_clock::now();
     this->get_session().execute(state->transition_);
+    update_average(transition_duration_, seconds_since(start));
 
     /* Create the new expanded state (copy the state of MCed into our MCer data) */
     std::unique_ptr<simgrid::mc::State> next_state =
@@ -149,6 +213,11 @@ void SafetyChecker::run()
     if (_sg_mc_max_visited_states > 0)
       visited_state_ = visited_states_.addVisitedState(expanded_states_count_, next_state.get(), true);
 
+    /* With model-check/checkpoint-memory, the snapshot of the visited state only becomes a checkpoint if worth it */
+    std::shared_ptr<simgrid::mc::Snapshot> snapshot;
+    if (_sg_mc_checkpoint_memory > 0)
+      snapshot = std::move(next_state->system_state);
+
     /* If this is a new state (or if we don't care about state-equality reduction) */
     if (visited_state_ == nullptr) {
 
@@ -171,14 +240,14 @@ void SafetyChecker::run()
                    req_str.c_str());
 
     stack_.push_back(std::move(next_state));
+    if (_sg_mc_checkpoint_memory > 0 && visited_state_ == nullptr)
+      this->checkpoint(std::move(snapshot));
   }
-
-  XBT_INFO("No property violation found.");
-  simgrid::mc::session->log_state();
 }
 
 void SafetyChecker::backtrack()
 {
+  this->drop_checkpoint(stack_.back().get());
   stack_.pop_back();
 
   /* Check for deadlocks */
@@ -194,7 +263,7 @@ void SafetyChecker::backtrack()
      executed before it. If it does then add it to the interleave set of the
      state that executed that previous request. */
 
-  while (not stack_.empty()) {
+  while (stack_.size() > root_depth_) {
     std::unique_ptr<simgrid::mc::State> state = std::move(stack_.back());
     stack_.pop_back();
     if (reductionMode_ == simgrid::mc::ReductionMode::dpor) {
@@ -203,7 +272,9 @@ void SafetyChecker::backtrack()
         xbt_die("Mutex is currently not supported with DPOR,  use --cfg=model-check/reduction:none");
 
       const smx_actor_t issuer = MC_smx_simcall_get_issuer(req);
+      std::size_t depth        = stack_.size();
       for (auto i = stack_.rbegin(); i != stack_.rend(); ++i) {
+        depth--;
         simgrid::mc::State* prev_state = i->get();
         if (simgrid::mc::request_depend(req, &prev_state->internal_req)) {
           if (XBT_LOG_ISENABLED(mc_safety, xbt_log_priority_debug)) {
@@ -221,7 +292,7 @@ void SafetyChecker::backtrack()
           }
 
           if (not prev_state->actor_states_[issuer->get_pid()].is_done())
-            prev_state->add_interleaving_set(issuer);
+            this->add_interleaving(depth, prev_state, issuer);
           else
             XBT_DEBUG("Process %p is in done set", req->issuer_);
 
@@ -252,34 +323,252 @@ void SafetyChecker::backtrack()
       break;
     } else {
       XBT_DEBUG("Delete state %d at depth %zu", state->num_, stack_.size() + 1);
+      this->drop_checkpoint(state.get());
     }
   }
 }
 
+/* Adds the actor to the interleave set of the state at that depth of the stack, or gives that subtree to the
+ * coordinator if the state belongs to another worker. */
+void SafetyChecker::add_interleaving(std::size_t depth, simgrid::mc::State* state, smx_actor_t actor)
+{
+  if (work_channel_ != nullptr && (depth < root_depth_ || (depth == root_depth_ && root_pid_ != -1))) {
+    this->give_work(depth, actor->get_pid());
+    state->actor_states_[actor->get_pid()].set_done();
+  } else
+    state->add_interleaving_set(actor);
+}
+
 void SafetyChecker::restore_state()
 {
-  /* Intermediate backtracking */
-  simgrid::mc::State* last_state = stack_.back().get();
-  if (last_state->system_state) {
-    last_state->system_state->restore(&mc_model_checker->process());
+  /* Restore the deepest state of the stack that has a snapshot, or the initial state */
+  auto start         = std::chrono::steady_clock::now();
+  auto last_snapshot = std::find_if(stack_.rbegin(), stack_.rend(), has_snapshot);
+  auto state         = stack_.begin();
+  if (last_snapshot != stack_.rend()) {
+    (*last_snapshot)->system_state->restore(&mc_model_checker->process());
+    state = std::prev(last_snapshot.base());
+  } else
+    simgrid::mc::session->restore_initial_state();
+  update_average(restore_duration_, seconds_since(start));
+
+  /* Traverse the stack from that state and re-execute the transitions */
+  for (; *state != stack_.back(); ++state) {
+    session->execute((*state)->transition_);
+    /* Update statistics */
+    mc_model_checker->visited_states++;
+    mc_model_checker->executed_transitions++;
+  }
+}
+
+/* Depths of the snapshots of the stack, but the one of the initial state */
+std::vector<std::size_t> SafetyChecker::checkpoint_depths() const
+{
+  std::vector<std::size_t> depths;
+  std::size_t depth = 0;
+  for (auto const& state : stack_) {
+    if (depth > 0 && state->system_state)
+      depths.push_back(depth);
+    depth++;
+  }
+  return depths;
+}
+
+/* Counts the references of the snapshots of the stack to the pages of the page store, when the snapshot of that state
+ * becomes a checkpoint or stops being one. A page shared by several snapshots is only counted once, and the pages that
+ * are only used by other snapshots (of the visited states for example) are not counted. */
+void SafetyChecker::count_checkpoint_pages(const simgrid::mc::State* state, bool add)
+{
+  for (auto const& region : state->system_state->snapshot_regions_) {
+    if (not region)
+      continue;
+    const std::size_t* pagenos = region->get_chunks().pagenos();
+    for (std::size_t i = 0; i < region->get_chunks().page_count(); i++)
+      if (add)
+        checkpoint_pages_[pagenos[i]]++;
+      else if (--checkpoint_pages_[pagenos[i]] == 0)
+        checkpoint_pages_.erase(pagenos[i]);
+  }
+}
+
+/* Forgets the snapshot of a state that is evicted or removed from the stack */
+void SafetyChecker::drop_checkpoint(simgrid::mc::State* state)
+{
+  if (_sg_mc_checkpoint_memory == 0 || not state->system_state)
     return;
+  XBT_DEBUG("Drop the checkpoint of state %d", state->num_);
+  count_checkpoint_pages(state, false);
+  state->system_state = nullptr;
+}
+
+/* Places a snapshot on the top state when replaying the transitions from the previous snapshot costs more than taking
+ * and restoring one, and evicts the least useful snapshots of the stack when going beyond the memory budget. The given
+ * snapshot of that state (taken for the visited states) is used if any, instead of taking a new one. */
+void SafetyChecker::checkpoint(std::shared_ptr<simgrid::mc::Snapshot> snapshot)
+{
+  simgrid::mc::State* state = stack_.back().get();
+  if (state->system_state)
+    return;
+
+  // Number of transitions to replay from the previous snapshot (or from the initial state)
+  std::vector<std::size_t> depths = checkpoint_depths();
+  std::size_t top_depth           = stack_.size() - 1;
+  std::size_t distance            = top_depth - (depths.empty() ? 0 : depths.back());
+  if (snapshot == nullptr &&
+      not checkpoint_is_worth(distance, transition_duration_, snapshot_duration_, restore_duration_))
+    return;
+
+  auto budget = static_cast<std::size_t>(_sg_mc_checkpoint_memory) * 1024 * 1024;
+  if (checkpoints_size() > budget) {
+    // Only worth it if that snapshot saves more replays than the one that we will have to evict
+    auto victim = least_useful_checkpoint(depths, top_depth);
+    if (victim.first == depths.size() || distance <= victim.second)
+      return;
   }
 
-  /* Restore the initial state */
+  if (snapshot == nullptr) {
+    auto start = std::chrono::steady_clock::now();
+    snapshot   = std::make_shared<simgrid::mc::Snapshot>(state->num_);
+    update_average(snapshot_duration_, seconds_since(start));
+  }
+  state->system_state = std::move(snapshot);
+  count_checkpoint_pages(state, true);
+  XBT_DEBUG("Checkpoint state %d at depth %zu (%zu bytes of checkpoints)", state->num_, top_depth, checkpoints_size());
+
+  depths.push_back(top_depth);
+  while (checkpoints_size() > budget) {
+    auto victim = least_useful_checkpoint(depths, top_depth);
+    if (victim.first == depths.size())
+      break;
+    auto victim_state = std::next(stack_.begin(), depths[victim.first]);
+    XBT_DEBUG("Evict the checkpoint of state %d at depth %zu", (*victim_state)->num_, depths[victim.first]);
+    drop_checkpoint(victim_state->get());
+    depths.erase(depths.begin() + victim.first);
+  }
+}
+
+void SafetyChecker::select_initial_actors(simgrid::mc::State* state)
+{
+  /* Get an enabled actor and insert it in the interleave set of the initial state */
+  for (auto& actor : mc_model_checker->process().actors())
+    if (simgrid::mc::actor_is_enabled(actor.copy.get_buffer())) {
+      state->add_interleaving_set(actor.copy.get_buffer());
+      if (reductionMode_ != simgrid::mc::ReductionMode::none)
+        break;
+    }
+}
+
+/* Replays the prefix of the work item from the initial state, and sets its root as the bottom of the exploration.
+ * The states of the prefix and the root were already expanded by the worker that gave the work away, so they are not
+ * counted in the statistics again (their number is 0). */
+void SafetyChecker::start_work(const WorkItem& item)
+{
+  XBT_DEBUG("Explore the subtree of actor %d after [%s]", item.pid, simgrid::mc::traceToString(item.prefix).c_str());
+  stack_.clear();
+  checkpoint_pages_.clear();
+  visited_state_ = nullptr;
   simgrid::mc::session->restore_initial_state();
 
-  /* Traverse the stack from the state at position start and re-execute the transitions */
-  for (std::unique_ptr<simgrid::mc::State> const& state : stack_) {
-    if (state == stack_.back())
+  for (Transition const& transition : item.prefix) {
+    std::unique_ptr<simgrid::mc::State> state = std::unique_ptr<simgrid::mc::State>(new simgrid::mc::State(0));
+    state->actor_states_[transition.pid_].consider();
+    smx_simcall_t req;
+    do {
+      req = MC_state_choose_request(state.get());
+    } while (req != nullptr && state->transition_.argument_ != transition.argument_);
+    xbt_assert(req != nullptr, "Cannot replay the transition %d/%d of the subtree prefix", transition.pid_,
+               transition.argument_);
+    state->actor_states_[transition.pid_].set_done();
+
+    this->get_session().execute(state->transition_);
+    stack_.push_back(std::move(state));
+  }
+
+  root_depth_ = stack_.size();
+  root_pid_   = item.pid;
+  std::unique_ptr<simgrid::mc::State> root;
+  if (item.pid == -1) { // The initial state
+    root = std::unique_ptr<simgrid::mc::State>(new simgrid::mc::State(++expanded_states_count_));
+    this->select_initial_actors(root.get());
+  } else {
+    root = std::unique_ptr<simgrid::mc::State>(new simgrid::mc::State(0));
+    root->actor_states_[item.pid].consider();
+  }
+  stack_.push_back(std::move(root));
+}
+
+/* Sends to the coordinator the subtree of the given actor from the state at that depth of the stack */
+void SafetyChecker::give_work(std::size_t depth, int pid)
+{
+  WorkItem item;
+  item.pid = pid;
+  for (auto const& state : stack_) {
+    if (item.prefix.size() == depth)
       break;
-    session->execute(state->transition_);
-    /* Update statistics */
-    mc_model_checker->visited_states++;
-    mc_model_checker->executed_transitions++;
+    item.prefix.push_back(state->get_transition());
   }
+  XBT_VERB("Give away the subtree of actor %d at depth %zu", pid, depth);
+  work_channel_->send(item);
 }
 
-SafetyChecker::SafetyChecker(Session& s) : Checker(s)
+/* Handles the pending messages of the coordinator. A split request is answered by giving away a pending actor of the
+ * shallowest state that we own: this is the largest subtree that we can give. */
+void SafetyChecker::handle_coordinator_messages()
+{
+  WorkMessageType type;
+  WorkItem item;
+  WorkStatistics statistics;
+  while (work_channel_->receive(type, item, statistics, false)) {
+    if (type == WorkMessageType::MERGE) {
+      this->merge_work(item);
+      continue;
+    }
+    xbt_assert(type == WorkMessageType::SPLIT, "Unexpected message from the coordinator");
+    this->split_work();
+  }
+}
+
+void SafetyChecker::split_work()
+{
+  std::size_t depth = 0;
+  for (auto const& state : stack_) {
+    // Skip the states of other workers, and the top state if its exploration did not start yet
+    if ((depth > root_depth_ || (depth == root_depth_ && root_pid_ == -1)) && state->transition_.pid_ > 0) {
+      for (unsigned pid = 0; pid < state->actor_states_.size(); pid++)
+        if (state->actor_states_[pid].is_todo() && static_cast<int>(pid) != state->transition_.pid_) {
+          state->actor_states_[pid].set_done();
+          this->give_work(depth, pid);
+          return;
+        }
+    }
+    depth++;
+  }
+  work_channel_->send(WorkMessageType::NO_WORK);
+}
+
+/* Adds a subtree found by another worker to the interleave set of its state, if that state is still on our stack.
+ * Otherwise, we do not know whether that subtree was explored, so it is sent back to the coordinator. */
+void SafetyChecker::merge_work(const WorkItem& item)
+{
+  std::size_t depth = item.prefix.size();
+  bool owned = (depth > root_depth_ || (depth == root_depth_ && root_pid_ == -1)) && depth < stack_.size();
+  auto state = stack_.begin();
+  for (std::size_t i = 0; owned && i < depth; i++, state++)
+    owned = (*state)->get_transition() == item.prefix[i];
+
+  if (not owned) {
+    work_channel_->send(item);
+  } else if (static_cast<std::size_t>(item.pid) < (*state)->actor_states_.size() &&
+             (*state)->actor_states_[item.pid].is_disabled()) {
+    XBT_DEBUG("Merge the subtree of actor %d at depth %zu", item.pid, depth);
+    (*state)->actor_states_[item.pid].consider();
+  } else {
+    XBT_DEBUG("The subtree of actor %d at depth %zu is already explored or scheduled", item.pid, depth);
+  }
+  work_channel_->send(WorkMessageType::MERGED);
+}
+
+SafetyChecker::SafetyChecker(Session& s, WorkChannel* work_channel) : Checker(s), work_channel_(work_channel)
 {
   reductionMode_ = simgrid::mc::reduction_mode;
   if (_sg_mc_termination)
@@ -287,6 +576,10 @@ SafetyChecker::SafetyChecker(Session& s) : Checker(s)
   else if (reductionMode_ == simgrid::mc::ReductionMode::unset)
     reductionMode_ = simgrid::mc::ReductionMode::dpor;
 
+  xbt_assert(_sg_mc_checkpoint_memory == 0 || (_sg_mc_checkpoint == 0 && not _sg_mc_termination),
+             "The model-check/checkpoint-memory option is incompatible with model-check/checkpoint and "
+             "model-check/termination");
+
   if (_sg_mc_termination)
     XBT_INFO("Check non progressive cycles");
   else
@@ -297,19 +590,17 @@ SafetyChecker::SafetyChecker(Session& s) : Checker(s)
 
   XBT_DEBUG("Starting the safety algorithm");
 
+  // The workers of a parallel exploration get their initial state from the coordinator
+  if (work_channel_ != nullptr)
+    return;
+
   std::unique_ptr<simgrid::mc::State> initial_state =
       std::unique_ptr<simgrid::mc::State>(new simgrid::mc::State(++expanded_states_count_));
 
   XBT_DEBUG("**************************************************");
   XBT_DEBUG("Initial state");
 
-  /* Get an enabled actor and insert it in the interleave set of the initial state */
-  for (auto& actor : mc_model_checker->process().actors())
-    if (simgrid::mc::actor_is_enabled(actor.copy.get_buffer())) {
-      initial_state->add_interleaving_set(actor.copy.get_buffer());
-      if (reductionMode_ != simgrid::mc::ReductionMode::none)
-        break;
-    }
+  this->select_initial_actors(initial_state.get());
 
   stack_.push_back(std::move(initial_state));
 }
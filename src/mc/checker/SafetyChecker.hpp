@@ -10,19 +10,26 @@
 #include "src/mc/VisitedState.hpp"
 #include "src/mc/checker/Checker.hpp"
 #include "src/mc/mc_safety.hpp"
+#include "xbt/misc.h"
 
 #include <list>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace simgrid {
 namespace mc {
 
+class WorkChannel;
+struct WorkItem;
+
 class XBT_PRIVATE SafetyChecker : public Checker {
   simgrid::mc::ReductionMode reductionMode_ = simgrid::mc::ReductionMode::unset;
 public:
-  explicit SafetyChecker(Session& session);
+  /** Creates a checker exploring the whole graph, or the subtrees given by the coordinator (see Coordinator) */
+  explicit SafetyChecker(Session& session, WorkChannel* work_channel = nullptr);
   ~SafetyChecker() = default;
   void run() override;
   RecordTrace get_record_trace() override;
@@ -31,14 +38,42 @@ public:
 
 private:
   void check_non_termination(simgrid::mc::State* current_state);
+  void select_initial_actors(simgrid::mc::State* state);
+  void explore();
   void backtrack();
   void restore_state();
+  void checkpoint(std::shared_ptr<simgrid::mc::Snapshot> snapshot);
+  std::vector<std::size_t> checkpoint_depths() const;
+  void count_checkpoint_pages(const simgrid::mc::State* state, bool add);
+  void drop_checkpoint(simgrid::mc::State* state);
+  /** Memory used by the snapshots of the stack */
+  std::size_t checkpoints_size() const { return checkpoint_pages_.size() * xbt_pagesize; }
+  void add_interleaving(std::size_t depth, simgrid::mc::State* state, smx_actor_t actor);
+  void start_work(const WorkItem& item);
+  void give_work(std::size_t depth, int pid);
+  void handle_coordinator_messages();
+  void split_work();
+  void merge_work(const WorkItem& item);
 
   /** Stack representing the position in the exploration graph */
   std::list<std::unique_ptr<simgrid::mc::State>> stack_;
   simgrid::mc::VisitedStates visited_states_;
   std::unique_ptr<simgrid::mc::VisitedState> visited_state_;
   unsigned long expanded_states_count_ = 0;
+
+  /** Channel to the coordinator, if this checker is a worker of a parallel exploration */
+  WorkChannel* work_channel_ = nullptr;
+  /** Depth of the root of the explored subtree: the states above it are explored by other workers */
+  std::size_t root_depth_ = 0;
+  /** Actor executed from the root of the explored subtree, or -1 if the whole root state belongs to this worker */
+  int root_pid_ = -1;
+
+  /** Average durations measured during the exploration (in seconds), to place the checkpoints */
+  double transition_duration_ = 0;
+  double snapshot_duration_   = 0;
+  double restore_duration_    = 0;
+  /** Number of references of the snapshots of the stack to each page of the page store */
+  std::unordered_map<std::size_t, unsigned> checkpoint_pages_;
 };
 
 }
@@ -7,6 +7,7 @@
 #include "simgrid/sg_config.hpp"
 #include "src/mc/Session.hpp"
 #include "src/mc/checker/Checker.hpp"
+#include "src/mc/checker/Coordinator.hpp"
 #include "src/mc/mc_config.hpp"
 #include "src/mc/mc_exit.hpp"
 
@@ -50,7 +51,16 @@ int main(int argc, char** argv)
   xbt_log_init(&argc, argv);
   sg_config_init(&argc, argv);
 
-  simgrid::mc::session = new simgrid::mc::Session([argv_copy] { execvp(argv_copy[1], argv_copy + 1); });
+  std::function<void()> code = [argv_copy] { execvp(argv_copy[1], argv_copy + 1); };
+  if (_sg_mc_workers > 1) {
+    if (_sg_mc_comms_determinism || _sg_mc_send_determinism || not _sg_mc_property_file.get().empty())
+      xbt_die("Only the safety properties can be checked with several workers (model-check/workers)");
+    int res = simgrid::mc::check_safety_in_parallel(_sg_mc_workers, code);
+    delete[] argv_copy;
+    return res;
+  }
+
+  simgrid::mc::session = new simgrid::mc::Session(code);
   delete[] argv_copy;
 
   std::unique_ptr<simgrid::mc::Checker> checker = create_checker(*simgrid::mc::session);
@@ -1233,6 +1233,8 @@ bool snapshot_equal(const Snapshot* s1, const Snapshot* s2)
   static StateComparator state_comparator;
 
   const RemoteClient& process = mc_model_checker->process();
+  /* The remote reads made while comparing (mostly the heap metadata) often hit the same pages */
+  ReadCacheScope read_cache(mc_model_checker->process());
 
   if (s1->hash_ != s2->hash_) {
     XBT_VERB("(%d - %d) Different hash: 0x%" PRIx64 "--0x%" PRIx64, s1->num_state_, s2->num_state_, s1->hash_,
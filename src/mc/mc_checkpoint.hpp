@@ -0,0 +1,52 @@
+/* Copyright (c) 2019. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/** \file mc_checkpoint.hpp
+ *
+ *  Placement of the snapshots along the exploration stack, with model-check/checkpoint-memory.
+ *
+ *  The snapshots of the stack are given by their depths, in increasing order. The initial state (depth 0) can always
+ *  be restored, so it is never part of them.
+ */
+
+#ifndef SIMGRID_MC_CHECKPOINT_HPP
+#define SIMGRID_MC_CHECKPOINT_HPP
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace simgrid {
+namespace mc {
+
+/** Whether replaying that many transitions costs more than taking a snapshot and restoring it */
+inline bool checkpoint_is_worth(std::size_t distance, double transition_duration, double snapshot_duration,
+                                double restore_duration)
+{
+  return distance * transition_duration >= snapshot_duration + restore_duration;
+}
+
+/** Finds the snapshot whose eviction lengthens the least the replays
+ *
+ *  The snapshot of the top state is never evicted. Returns the index of the snapshot in depths, with the number of
+ *  transitions to replay from the previous snapshot to the next one (or to the top state) once it is evicted; or
+ *  depths.size() if no snapshot can be evicted.
+ */
+inline std::pair<std::size_t, std::size_t> least_useful_checkpoint(const std::vector<std::size_t>& depths,
+                                                                   std::size_t top_depth)
+{
+  std::pair<std::size_t, std::size_t> res = {depths.size(), 0};
+  for (std::size_t i = 0; i < depths.size() && depths[i] < top_depth; i++) {
+    std::size_t previous = i > 0 ? depths[i - 1] : 0;
+    std::size_t next     = i + 1 < depths.size() ? depths[i + 1] : top_depth;
+    if (res.first == depths.size() || next - previous < res.second)
+      res = {i, next - previous};
+  }
+  return res;
+}
+}
+}
+
+#endif
@@ -0,0 +1,74 @@
+/* Copyright (c) 2019. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#include "catch.hpp"
+
+#include "src/mc/mc_checkpoint.hpp"
+
+#include <vector>
+
+namespace {
+/* Places the checkpoints along a path going down to the given depth like the SafetyChecker does, with a transition
+ * costing as much as restoring a snapshot and half as much as taking one, and with room for that many snapshots. */
+std::vector<std::size_t> place_checkpoints(std::size_t max_depth, std::size_t budget)
+{
+  std::vector<std::size_t> depths;
+  for (std::size_t top = 1; top <= max_depth; top++) {
+    std::size_t distance = top - (depths.empty() ? 0 : depths.back());
+    if (not simgrid::mc::checkpoint_is_worth(distance, 1.0, 2.0, 1.0))
+      continue;
+    if (depths.size() >= budget) {
+      auto victim = simgrid::mc::least_useful_checkpoint(depths, top);
+      if (victim.first == depths.size() || distance <= victim.second)
+        continue;
+    }
+    depths.push_back(top);
+    while (depths.size() > budget) {
+      auto victim = simgrid::mc::least_useful_checkpoint(depths, top);
+      REQUIRE(victim.first < depths.size());
+      depths.erase(depths.begin() + victim.first);
+    }
+  }
+  return depths;
+}
+}
+
+TEST_CASE("mc::checkpoint Placement of the checkpoints along the stack", "[mc-checkpoint]")
+{
+  SECTION("Worth taking a snapshot")
+  {
+    REQUIRE_FALSE(simgrid::mc::checkpoint_is_worth(0, 1.0, 2.0, 1.0));
+    REQUIRE_FALSE(simgrid::mc::checkpoint_is_worth(2, 1.0, 2.0, 1.0));
+    REQUIRE(simgrid::mc::checkpoint_is_worth(3, 1.0, 2.0, 1.0));
+    // Nothing measured yet: the first snapshot is always taken
+    REQUIRE(simgrid::mc::checkpoint_is_worth(1, 1e-6, 0.0, 0.0));
+  }
+
+  SECTION("Least useful snapshot")
+  {
+    // Evicting the snapshot at depth 6 makes the replays from depth 2 to 7, the shortest ones
+    auto victim = simgrid::mc::least_useful_checkpoint({2, 6, 7}, 12);
+    REQUIRE(victim.first == 1);
+    REQUIRE(victim.second == 5);
+
+    // The first one on ties, and never the snapshot of the top state
+    victim = simgrid::mc::least_useful_checkpoint({3, 6, 9}, 9);
+    REQUIRE(victim.first == 0);
+    REQUIRE(victim.second == 6);
+
+    REQUIRE(simgrid::mc::least_useful_checkpoint({}, 4).first == 0);
+    REQUIRE(simgrid::mc::least_useful_checkpoint({4}, 4).first == 1);
+  }
+
+  SECTION("Placement and eviction within a budget")
+  {
+    REQUIRE(place_checkpoints(10, 10) == std::vector<std::size_t>({3, 6, 9}));
+    // The snapshot at depth 9 would make a gap as long as the one of the eviction, the one at depth 13 is worth it
+    REQUIRE(place_checkpoints(12, 2) == std::vector<std::size_t>({3, 6}));
+    REQUIRE(place_checkpoints(13, 2) == std::vector<std::size_t>({6, 13}));
+    // A single snapshot is never moved down: evicting it would make the replays longer than the ones it saves
+    REQUIRE(place_checkpoints(13, 1) == std::vector<std::size_t>({3}));
+  }
+}
@@ -51,6 +51,21 @@ simgrid::config::Flag<int> _sg_mc_checkpoint{
                               "compromises between speed and memory consumption.",
     0, [](int) { _mc_cfg_cb_check("checkpointing value"); }};
 
+simgrid::config::Flag<int> _sg_mc_checkpoint_memory{
+    "model-check/checkpoint-memory",
+    "Memory budget of the snapshots (in MiB) when placing the checkpoints of safety checks adaptively, depending on "
+    "the measured costs of the snapshots and of the replays (default: 0 => checkpoints every model-check/checkpoint "
+    "steps)",
+    0, [](int value) {
+      _mc_cfg_cb_check("memory budget of the checkpoints");
+      xbt_assert(value >= 0, "The memory budget of the checkpoints cannot be negative");
+    }};
+
+simgrid::config::Flag<bool> _sg_mc_soft_dirty{
+    "model-check/soft-dirty",
+    "Use the soft-dirty bits of the pages (Linux only) to only read the pages modified since the previous snapshot",
+    false, [](bool) { _mc_cfg_cb_check("value to enable/disable the soft-dirty page tracking"); }};
+
 simgrid::config::Flag<std::string> _sg_mc_property_file{
     "model-check/property", "Name of the file containing the property, as formatted by the ltl2ba program.", "",
     [](const std::string&) { _mc_cfg_cb_check("property"); }};
@@ -119,4 +134,11 @@ simgrid::config::Flag<bool> _sg_mc_termination{
     "model-check/termination", "Whether to enable non progressive cycle detection", false,
     [](bool) { _mc_cfg_cb_check("value to enable/disable the detection of non progressive cycles"); }};
 
+simgrid::config::Flag<int> _sg_mc_workers{
+    "model-check/workers", "Number of processes exploring the state space in parallel (only for safety properties)", 1,
+    [](int value) {
+      _mc_cfg_cb_check("number of workers");
+      xbt_assert(value >= 1, "The number of model-checker workers must be at least 1");
+    }};
+
 #endif
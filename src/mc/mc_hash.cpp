@@ -25,8 +25,7 @@ class djb_hash {
   hash_type state_ = 5381LL;
 
 public:
-  template<class T>
-  void update(T& x)
+  template <class T> void update(const T& x)
   {
     state_ = (state_ << 5) + state_ + x;
   }
@@ -42,12 +41,24 @@ hash_type hash(Snapshot const& snapshot)
 {
   XBT_DEBUG("START hash %i", snapshot.num_state_);
   djb_hash hash;
-  // TODO:
-  // * nb_processes
-  // * heap_bytes_used
-  // * root variables
-  // * basic stack frame information
-  // * stack frame local variables
+  /* Only hash what must be identical in two snapshots for snapshot_equal() to consider them as equal: the memory
+   * content cannot be hashed, as equal heaps may differ by the addresses of their blocks. */
+  hash.update(snapshot.enabled_processes_.size());
+  for (pid_t pid : snapshot.enabled_processes_)
+    hash.update(pid);
+  hash.update(snapshot.heap_bytes_used_);
+  const xbt_mheap_t heap = snapshot.process()->get_heap();
+  hash.update(heap->heaplimit);
+  hash.update(heap->heapsize);
+  for (std::size_t stack_size : snapshot.stack_sizes_)
+    hash.update(stack_size);
+  for (auto const& stack : snapshot.stacks_) {
+    hash.update(stack.local_variables.size());
+    for (auto const& variable : stack.local_variables) {
+      hash.update(reinterpret_cast<std::uintptr_t>(variable.subprogram));
+      hash.update(variable.ip);
+    }
+  }
   XBT_DEBUG("END hash %i", snapshot.num_state_);
   return hash.value();
 }
@@ -9,6 +9,8 @@
 #include "xbt/base.h"
 #include "src/mc/mc_forward.hpp"
 
+#include <cstdint>
+
 namespace simgrid {
 namespace mc {
 
@@ -43,15 +43,17 @@ static void MC_process_refresh_simix_actor_dynar(simgrid::mc::RemoteClient* proc
   smx_actor_t* data = static_cast<smx_actor_t*>(::operator new(dynar.elmsize * dynar.used));
   process->read_bytes(data, dynar.elmsize * dynar.used, simgrid::mc::RemotePtr<void>(dynar.data));
 
-  // Load each element of the vector from the MCed process:
+  // Load each element of the vector from the MCed process, all at once:
+  target.resize(dynar.used);
+  std::vector<simgrid::mc::RemoteRead> reads;
+  reads.reserve(dynar.used);
   for (unsigned int i = 0; i < dynar.used; ++i) {
-
-    simgrid::mc::ActorInformation info;
+    simgrid::mc::ActorInformation& info = target[i];
     info.address  = simgrid::mc::RemotePtr<simgrid::kernel::actor::ActorImpl>(data[i]);
     info.hostname = nullptr;
-    process->read_bytes(&info.copy, sizeof(info.copy), remote(data[i]));
-    target.push_back(std::move(info));
+    reads.push_back({&info.copy, sizeof(info.copy), remote(data[i])});
   }
+  process->read_vectored(reads);
   ::operator delete(data);
 }
 namespace simgrid {
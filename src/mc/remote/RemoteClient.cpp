@@ -7,14 +7,20 @@
 
 #include "src/mc/remote/RemoteClient.hpp"
 
+#include "src/internal_config.h"
+#include "src/mc/mc_mmu.hpp"
 #include "src/mc/mc_smx.hpp"
 #include "src/mc/sosp/Snapshot.hpp"
 #include "xbt/file.hpp"
 #include "xbt/log.h"
 
+#include <algorithm>
+#include <climits>
+#include <cstdint>
 #include <fcntl.h>
 #include <libunwind-ptrace.h>
 #include <sys/mman.h> // PROT_*
+#include <sys/uio.h>
 
 using simgrid::mc::remote;
 
@@ -172,11 +178,11 @@ static void zero_buffer_init()
   close(fd);
 }
 
-int open_vm(pid_t pid, int flags)
+static int open_proc_file(pid_t pid, const char* name, int flags)
 {
-  const size_t buffer_size = 30;
+  const size_t buffer_size = 40;
   char buffer[buffer_size];
-  int res = snprintf(buffer, buffer_size, "/proc/%lli/mem", (long long)pid);
+  int res = snprintf(buffer, buffer_size, "/proc/%lli/%s", (long long)pid, name);
   if (res < 0 || (size_t)res >= buffer_size) {
     errno = ENAMETOOLONG;
     return -1;
@@ -184,6 +190,48 @@ int open_vm(pid_t pid, int flags)
   return open(buffer, flags);
 }
 
+int open_vm(pid_t pid, int flags)
+{
+  return open_proc_file(pid, "mem", flags);
+}
+
+/* Flags of the entries of /proc/$pid/pagemap (see Documentation/admin-guide/mm/soft-dirty.rst in Linux) */
+static constexpr std::uint64_t pagemap_soft_dirty = UINT64_C(1) << 55;
+static constexpr std::uint64_t pagemap_swapped    = UINT64_C(1) << 62;
+static constexpr std::uint64_t pagemap_present    = UINT64_C(1) << 63;
+
+static std::uint64_t read_pagemap_entry(int pagemap, const void* address)
+{
+  std::uint64_t entry;
+  off_t offset = simgrid::mc::mmu::split((std::uintptr_t)address).first * sizeof(entry);
+  if (pread_whole(pagemap, &entry, sizeof(entry), offset) < 0)
+    xbt_die("Could not read the pagemap");
+  return entry;
+}
+
+/* Checks on our own memory that the kernel tracks the soft-dirty bits (they are always unset otherwise) */
+bool RemoteClient::soft_dirty_supported()
+{
+  int clear_refs = open_proc_file(getpid(), "clear_refs", O_WRONLY);
+  int pagemap    = open_proc_file(getpid(), "pagemap", O_RDONLY);
+  void* page     = mmap(nullptr, xbt_pagesize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  bool res       = false;
+  if (clear_refs >= 0 && pagemap >= 0 && page != MAP_FAILED) {
+    *(volatile char*)page = 1;
+    if (write(clear_refs, "4", 1) == 1 && not(read_pagemap_entry(pagemap, page) & pagemap_soft_dirty)) {
+      *(volatile char*)page = 2;
+      res                   = read_pagemap_entry(pagemap, page) & pagemap_soft_dirty;
+    }
+  }
+  if (page != MAP_FAILED)
+    munmap(page, xbt_pagesize);
+  if (pagemap >= 0)
+    close(pagemap);
+  if (clear_refs >= 0)
+    close(clear_refs);
+  return res;
+}
+
 // ***** Process
 
 RemoteClient::RemoteClient(pid_t pid, int sockfd) : AddressSpace(this), pid_(pid), channel_(sockfd), running_(true)
@@ -219,6 +267,10 @@ RemoteClient::~RemoteClient()
 {
   if (this->memory_file >= 0)
     close(this->memory_file);
+  if (this->clear_refs_file_ >= 0)
+    close(this->clear_refs_file_);
+  if (this->pagemap_file_ >= 0)
+    close(this->pagemap_file_);
 
   if (this->unw_underlying_addr_space != unw_local_addr_space) {
     if (this->unw_underlying_addr_space)
@@ -428,11 +480,67 @@ std::string RemoteClient::read_string(RemotePtr<char> address) const
 
 void* RemoteClient::read_bytes(void* buffer, std::size_t size, RemotePtr<void> address, ReadOptions /*options*/) const
 {
+  if (read_cache_users_ > 0 && read_cached(buffer, size, address))
+    return buffer;
   if (pread_whole(this->memory_file, buffer, size, (size_t)address.address()) < 0)
     xbt_die("Read at %p from process %lli failed", (void*)address.address(), (long long)this->pid_);
   return buffer;
 }
 
+/* Serves a read that fits in a page from the read cache, after loading that page if needed. Returns false if the read
+ * cannot be cached. */
+bool RemoteClient::read_cached(void* buffer, std::size_t size, RemotePtr<void> address) const
+{
+  auto page = simgrid::mc::mmu::split(address.address());
+  if (page.second + size > static_cast<std::size_t>(xbt_pagesize))
+    return false;
+
+  auto cached = read_cache_.find(page.first);
+  if (cached == read_cache_.end()) {
+    std::vector<char> content(xbt_pagesize);
+    if (pread_whole(this->memory_file, content.data(), xbt_pagesize, simgrid::mc::mmu::join(page.first, 0)) < 0)
+      return false;
+    if (read_cache_.size() >= read_cache_max_pages)
+      read_cache_.clear();
+    cached = read_cache_.emplace(page.first, std::move(content)).first;
+  }
+  memcpy(buffer, cached->second.data() + page.second, size);
+  return true;
+}
+
+void RemoteClient::read_vectored(std::vector<RemoteRead> const& reads) const
+{
+  std::size_t done = 0;
+#if HAVE_PROCESS_VM_READV /* linux but not freebsd */
+  std::vector<struct iovec> local_iov;
+  std::vector<struct iovec> remote_iov;
+  while (done < reads.size()) {
+    std::size_t end = std::min<std::size_t>(reads.size(), done + IOV_MAX);
+    local_iov.clear();
+    remote_iov.clear();
+    for (std::size_t i = done; i < end; i++) {
+      local_iov.push_back({reads[i].buffer, reads[i].size});
+      remote_iov.push_back({(void*)reads[i].address.address(), reads[i].size});
+    }
+    ssize_t res =
+        process_vm_readv(this->pid_, local_iov.data(), local_iov.size(), remote_iov.data(), remote_iov.size(), 0);
+    if (res < 0)
+      break; // Not supported (or not allowed): read them from /proc/$pid/mem instead
+
+    // Skip the areas that were entirely read. The read stops at the first area that cannot be read entirely.
+    std::size_t transferred = res;
+    while (done < end && transferred >= reads[done].size) {
+      transferred -= reads[done].size;
+      done++;
+    }
+    if (done < end)
+      break;
+  }
+#endif
+  for (; done < reads.size(); done++)
+    this->read_bytes(reads[done].buffer, reads[done].size, reads[done].address);
+}
+
 /** Write data to a process memory
  *
  *  @param buffer   local memory address (source)
@@ -441,10 +549,41 @@ void* RemoteClient::read_bytes(void* buffer, std::size_t size, RemotePtr<void> a
  */
 void RemoteClient::write_bytes(const void* buffer, size_t len, RemotePtr<void> address)
 {
+  read_cache_.clear();
   if (pwrite_whole(this->memory_file, buffer, len, (size_t)address.address()) < 0)
     xbt_die("Write to process %lli failed", (long long)this->pid_);
 }
 
+void RemoteClient::reset_soft_dirty()
+{
+  if (this->clear_refs_file_ < 0) {
+    if (not soft_dirty_supported())
+      xbt_die("The soft-dirty bits of the pages are not supported by this kernel (see CONFIG_MEM_SOFT_DIRTY)");
+    this->clear_refs_file_ = open_proc_file(this->pid_, "clear_refs", O_WRONLY);
+    this->pagemap_file_    = open_proc_file(this->pid_, "pagemap", O_RDONLY);
+    xbt_assert(this->clear_refs_file_ >= 0 && this->pagemap_file_ >= 0,
+               "Could not open the soft-dirty bits of process %lli", (long long)this->pid_);
+  }
+  if (write(this->clear_refs_file_, "4", 1) != 1)
+    xbt_die("Could not reset the soft-dirty bits of process %lli", (long long)this->pid_);
+}
+
+std::vector<bool> RemoteClient::read_soft_dirty(RemotePtr<void> address, std::size_t page_count) const
+{
+  xbt_assert(this->pagemap_file_ >= 0, "The soft-dirty bits were never reset");
+  std::vector<std::uint64_t> entries(page_count);
+  std::size_t size = page_count * sizeof(std::uint64_t);
+  off_t offset     = simgrid::mc::mmu::split(address.address()).first * sizeof(std::uint64_t);
+  if (size > 0 && pread_whole(this->pagemap_file_, entries.data(), size, offset) < 0)
+    xbt_die("Could not read the pagemap of process %lli", (long long)this->pid_);
+
+  // The soft-dirty bit of the pages that are not mapped may have been lost (with madvise(MADV_DONTNEED) for example)
+  std::vector<bool> dirty(page_count);
+  for (std::size_t i = 0; i < page_count; i++)
+    dirty[i] = (entries[i] & pagemap_soft_dirty) || not(entries[i] & (pagemap_present | pagemap_swapped));
+  return dirty;
+}
+
 void RemoteClient::clear_bytes(RemotePtr<void> address, size_t len)
 {
   pthread_once(&zero_buffer_flag, zero_buffer_init);
@@ -12,6 +12,7 @@
 #include "src/mc/remote/RemotePtr.hpp"
 #include "src/xbt/mmalloc/mmprivate.h"
 
+#include <unordered_map>
 #include <vector>
 
 namespace simgrid {
@@ -40,6 +41,13 @@ struct IgnoredRegion {
   std::size_t size;
 };
 
+/** A memory area to read with RemoteClient::read_vectored() */
+struct RemoteRead {
+  void* buffer;
+  std::size_t size;
+  RemotePtr<void> address;
+};
+
 struct IgnoredHeapRegion {
   int block;
   int fragment;
@@ -97,13 +105,35 @@ public:
     return res;
   }
 
+  /** Read several memory areas, with as few system calls as possible */
+  void read_vectored(std::vector<RemoteRead> const& reads) const;
+
   std::string read_string(RemotePtr<char> address) const;
   using AddressSpace::read_string;
 
+  /** Keep the pages read from the memory in a cache, until disable_read_cache() is called as many times
+   *
+   *  This saves a system call for each small read of a page already read. The model-checked process must not run
+   *  meanwhile (but the writes through this object are taken into account). See ReadCacheScope. */
+  void enable_read_cache() { read_cache_users_++; }
+  void disable_read_cache()
+  {
+    if (--read_cache_users_ == 0)
+      read_cache_.clear();
+  }
+
   // Write memory:
   void write_bytes(const void* buffer, size_t len, RemotePtr<void> address);
   void clear_bytes(RemotePtr<void> address, size_t len);
 
+  // Soft-dirty bits of the pages (Linux only):
+  /** Whether the kernel tracks the soft-dirty bits (see CONFIG_MEM_SOFT_DIRTY) */
+  static bool soft_dirty_supported();
+  /** Clear the soft-dirty bits of all the pages, so that the pages written from now on can be told apart */
+  void reset_soft_dirty();
+  /** Whether each of the given pages may have been written since the last call to reset_soft_dirty() */
+  std::vector<bool> read_soft_dirty(RemotePtr<void> address, std::size_t page_count) const;
+
   // Debug information:
   std::shared_ptr<simgrid::mc::ObjectInformation> find_object_info(RemotePtr<void> addr) const;
   std::shared_ptr<simgrid::mc::ObjectInformation> find_object_info_exec(RemotePtr<void> addr) const;
@@ -125,7 +155,11 @@ public:
     return this->heap_info.data();
   }
 
-  void clear_cache() { this->cache_flags_ = RemoteClient::cache_none; }
+  void clear_cache()
+  {
+    this->cache_flags_ = RemoteClient::cache_none;
+    read_cache_.clear();
+  }
 
   Channel const& get_channel() const { return channel_; }
   Channel& get_channel() { return channel_; }
@@ -194,6 +228,7 @@ private:
   void refresh_heap();
   void refresh_malloc_info();
   void refresh_simix();
+  bool read_cached(void* buffer, std::size_t size, RemotePtr<void> address) const;
 
   pid_t pid_ = -1;
   Channel channel_;
@@ -202,10 +237,16 @@ private:
   RemotePtr<void> maestro_stack_start_;
   RemotePtr<void> maestro_stack_end_;
   int memory_file = -1;
+  int clear_refs_file_ = -1;
+  int pagemap_file_    = -1;
   std::vector<IgnoredRegion> ignored_regions_;
   std::vector<s_stack_region_t> stack_areas_;
   std::vector<IgnoredHeapRegion> ignored_heap_;
 
+  static constexpr std::size_t read_cache_max_pages = 256;
+  int read_cache_users_                             = 0;
+  mutable std::unordered_map<std::size_t, std::vector<char>> read_cache_; // page number -> content
+
 public:
   // object info
   // TODO, make private (first, objectify simgrid::mc::ObjectInformation*)
@@ -275,6 +316,19 @@ public:
   bool actor_is_enabled(aid_t pid);
 };
 
+/** Caches the pages read from the memory of the process while it lives (see RemoteClient::enable_read_cache()) */
+class ReadCacheScope {
+  RemoteClient& process_;
+
+public:
+  explicit ReadCacheScope(RemoteClient& process) : process_(process) { process_.enable_read_cache(); }
+  ~ReadCacheScope() { process_.disable_read_cache(); }
+
+  // No copy:
+  ReadCacheScope(ReadCacheScope const&) = delete;
+  ReadCacheScope& operator=(ReadCacheScope const&) = delete;
+};
+
 /** Open a FD to a remote process memory (`/dev/$pid/mem`)
  */
 XBT_PRIVATE int open_vm(pid_t pid, int flags);
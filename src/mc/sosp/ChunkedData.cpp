@@ -6,6 +6,8 @@
 #include "src/mc/AddressSpace.hpp"
 #include "src/mc/sosp/ChunkedData.hpp"
 
+#include <algorithm>
+
 namespace simgrid {
 namespace mc {
 
@@ -16,27 +18,47 @@ namespace mc {
  *  @return                Snapshot page numbers of this new snapshot
  */
 ChunkedData::ChunkedData(PageStore& store, AddressSpace& as, RemotePtr<void> addr, std::size_t page_count)
+    : ChunkedData(store, as, addr, page_count, ChunkedData(), std::vector<bool>())
+{
+}
+
+/** Take a per-page snapshot of a region, only reading the pages that changed since a previous snapshot of it
+ *
+ *  @param addr            The start of the region (must be at the beginning of a page)
+ *  @param page_count      Number of pages of the region
+ *  @param parent          Previous snapshot of the region, at the same address
+ *  @param dirty           Which pages of the parent may have changed since then
+ */
+ChunkedData::ChunkedData(PageStore& store, AddressSpace& as, RemotePtr<void> addr, std::size_t page_count,
+                         ChunkedData const& parent, std::vector<bool> const& dirty)
 {
   store_ = &store;
   this->pagenos_.resize(page_count);
-  std::vector<char> buffer(xbt_pagesize);
-
-  for (size_t i = 0; i != page_count; ++i) {
-
-    RemotePtr<void> page = remote((void*)simgrid::mc::mmu::join(i, addr.address()));
-    xbt_assert(simgrid::mc::mmu::split(page.address()).second == 0, "Not at the beginning of a page");
+  xbt_assert(simgrid::mc::mmu::split(addr.address()).second == 0, "Not at the beginning of a page");
+  xbt_assert(parent.page_count() == 0 || parent.store_ == store_, "The parent snapshot is in another page store");
+  xbt_assert(dirty.size() >= std::min(page_count, parent.page_count()), "Missing soft-dirty bits");
 
-    /* Adding another copy (and a syscall) will probably slow things a lot.
-       TODO, optimize this somehow (at least by grouping the syscalls)
-       if needed. Either:
-       - reduce the number of syscalls
-       - let the application snapshot itself
-       - move the segments in shared memory (this will break `fork` however)
-    */
+  auto reusable = [&parent, &dirty](std::size_t i) { return i < parent.page_count() && not dirty[i]; };
 
-    as.read_bytes(buffer.data(), xbt_pagesize, page);
+  /* The modified pages are read by batches, with a system call per batch instead of per page */
+  constexpr std::size_t batch_pages = 64;
+  std::vector<char> buffer(std::min(page_count, batch_pages) * xbt_pagesize);
 
-    pagenos_[i] = store_->store_page(buffer.data());
+  std::size_t i = 0;
+  while (i < page_count) {
+    if (reusable(i)) {
+      pagenos_[i] = parent.pageno(i);
+      store_->ref_page(pagenos_[i]);
+      i++;
+      continue;
+    }
+    std::size_t count = 1;
+    while (count < batch_pages && i + count < page_count && not reusable(i + count))
+      count++;
+    as.read_bytes(buffer.data(), count * xbt_pagesize, remote((void*)simgrid::mc::mmu::join(i, addr.address())));
+    for (size_t j = 0; j != count; ++j)
+      pagenos_[i + j] = store_->store_page(buffer.data() + j * xbt_pagesize);
+    i += count;
   }
 }
 
@@ -85,6 +85,8 @@ public:
   const void* page(std::size_t i) const { return store_->get_page(pagenos_[i]); }
 
   ChunkedData(PageStore& store, AddressSpace& as, RemotePtr<void> addr, std::size_t page_count);
+  ChunkedData(PageStore& store, AddressSpace& as, RemotePtr<void> addr, std::size_t page_count,
+              ChunkedData const& parent, std::vector<bool> const& dirty);
 };
 
 } // namespace mc
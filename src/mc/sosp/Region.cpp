@@ -10,6 +10,7 @@
 #include "src/mc/mc_smx.hpp"
 #include "src/mc/sosp/Region.hpp"
 
+#include <algorithm>
 #include <cstdlib>
 #include <sys/mman.h>
 #ifdef __FreeBSD__
@@ -21,13 +22,31 @@ XBT_LOG_NEW_DEFAULT_SUBCATEGORY(mc_RegionSnaphot, mc, "Logging specific to regio
 namespace simgrid {
 namespace mc {
 
+/** Pages of the region starting at that address in the parent snapshot, if the soft-dirty bits are used */
+static const ChunkedData* parent_chunks(RemotePtr<void> start)
+{
+  if (not _sg_mc_soft_dirty)
+    return nullptr;
+  for (auto const& region : mc_model_checker->parent_regions())
+    if (region.first == start)
+      return &region.second;
+  return nullptr;
+}
+
 Region::Region(RegionType region_type, void* start_addr, size_t size)
     : region_type_(region_type), start_addr_(start_addr), size_(size)
 {
   xbt_assert((((uintptr_t)start_addr) & (xbt_pagesize - 1)) == 0, "Start address not at the beginning of a page");
 
-  chunks_ = ChunkedData(mc_model_checker->page_store(), mc_model_checker->process(), RemotePtr<void>(start_addr),
-                        mmu::chunk_count(size));
+  RemoteClient& process     = mc_model_checker->process();
+  std::size_t page_count    = mmu::chunk_count(size);
+  const ChunkedData* parent = parent_chunks(start());
+  if (parent) {
+    // Only read the pages that were written since the parent snapshot
+    std::vector<bool> dirty = process.read_soft_dirty(start(), std::min(page_count, parent->page_count()));
+    chunks_ = ChunkedData(mc_model_checker->page_store(), process, start(), page_count, *parent, dirty);
+  } else
+    chunks_ = ChunkedData(mc_model_checker->page_store(), process, start(), page_count);
 }
 
 /** @brief Restore a region from a snapshot
@@ -39,7 +58,16 @@ void Region::restore()
   xbt_assert(((start().address()) & (xbt_pagesize - 1)) == 0, "Not at the beginning of a page");
   xbt_assert(simgrid::mc::mmu::chunk_count(size()) == get_chunks().page_count());
 
+  // The pages that were not written since the parent snapshot are already in place if they are the same in both
+  const ChunkedData* parent = parent_chunks(start());
+  std::size_t known         = parent ? std::min(get_chunks().page_count(), parent->page_count()) : 0;
+  std::vector<bool> dirty;
+  if (parent)
+    dirty = mc_model_checker->process().read_soft_dirty(start(), known);
+
   for (size_t i = 0; i != get_chunks().page_count(); ++i) {
+    if (i < known && not dirty[i] && parent->pageno(i) == get_chunks().pageno(i))
+      continue;
     void* target_page       = (void*)simgrid::mc::mmu::join(i, (std::uintptr_t)(void*)start().address());
     const void* source_page = get_chunks().page(i);
     mc_model_checker->process().write_bytes(source_page, xbt_pagesize, remote(target_page));
@@ -155,14 +155,18 @@ static std::vector<s_mc_stack_frame_t> unwind_stack_frames(simgrid::mc::UnwindCo
 
 void simgrid::mc::Snapshot::snapshot_stacks(simgrid::mc::RemoteClient* process)
 {
-  for (auto const& stack : process->stack_areas()) {
+  // Read the contexts from remote process, all at once:
+  std::vector<unw_context_t> contexts(process->stack_areas().size());
+  std::vector<RemoteRead> reads;
+  for (std::size_t i = 0; i < contexts.size(); i++)
+    reads.push_back({&contexts[i], sizeof(unw_context_t), remote(process->stack_areas()[i].context)});
+  process->read_vectored(reads);
+
+  for (std::size_t i = 0; i < contexts.size(); i++) {
+    auto const& stack = process->stack_areas()[i];
     s_mc_snapshot_stack_t st;
 
-    // Read the context from remote process:
-    unw_context_t context;
-    process->read_bytes(&context, sizeof(context), remote(stack.context));
-
-    st.context.initialize(process, &context);
+    st.context.initialize(process, &contexts[i]);
 
     st.stack_frames    = unwind_stack_frames(&st.context);
     st.local_variables = get_local_variables_values(st.stack_frames);
@@ -185,10 +189,13 @@ static void snapshot_handle_ignore(simgrid::mc::Snapshot* snapshot)
     s_mc_snapshot_ignored_data_t ignored_data;
     ignored_data.start = (void*)region.addr;
     ignored_data.data.resize(region.size);
-    // TODO, we should do this once per privatization segment:
-    snapshot->process()->read_bytes(ignored_data.data.data(), region.size, remote(region.addr));
     snapshot->ignored_data_.push_back(std::move(ignored_data));
   }
+  // TODO, we should do this once per privatization segment:
+  std::vector<simgrid::mc::RemoteRead> reads;
+  for (auto& ignored_data : snapshot->ignored_data_)
+    reads.push_back({ignored_data.data.data(), ignored_data.data.size(), remote(ignored_data.start)});
+  snapshot->process()->read_vectored(reads);
 
   // Zero the memory:
   for (auto const& region : snapshot->process()->ignored_regions())
@@ -200,10 +207,26 @@ static void snapshot_ignore_restore(simgrid::mc::Snapshot* snapshot)
     snapshot->process()->write_bytes(ignored_data.data.data(), ignored_data.data.size(), remote(ignored_data.start));
 }
 
+/* The memory of the process is now the one of the snapshot (but the ignored data, that is zeroed again before taking
+ * a snapshot): the pages that are not written from now on do not need to be read or restored again */
+static void snapshot_reset_soft_dirty(simgrid::mc::Snapshot* snapshot)
+{
+  if (not _sg_mc_soft_dirty)
+    return;
+  auto& parent_regions = mc_model_checker->parent_regions();
+  parent_regions.clear();
+  for (auto const& region : snapshot->snapshot_regions_)
+    if (region)
+      parent_regions.emplace_back(region->start(), region->get_chunks());
+  snapshot->process()->reset_soft_dirty();
+}
+
 Snapshot::Snapshot(int num_state, RemoteClient* process)
     : AddressSpace(process), num_state_(num_state), heap_bytes_used_(0), enabled_processes_(), hash_(0)
 {
   XBT_DEBUG("Taking snapshot %i", num_state);
+  /* The small reads of the stack unwinding and of the heap metadata often hit the same pages */
+  ReadCacheScope read_cache(*process);
 
   for (auto const& p : process->actors())
     enabled_processes_.insert(p.copy.get_buffer()->get_pid());
@@ -221,6 +244,7 @@ Snapshot::Snapshot(int num_state, RemoteClient* process)
   }
 
   snapshot_ignore_restore(this);
+  snapshot_reset_soft_dirty(this);
 }
 
 void Snapshot::add_region(RegionType type, ObjectInformation* object_info, void* start_addr, std::size_t size)
@@ -287,6 +311,7 @@ void Snapshot::restore(RemoteClient* process)
   }
 
   snapshot_ignore_restore(this);
+  snapshot_reset_soft_dirty(this);
   process->clear_cache();
 }
 
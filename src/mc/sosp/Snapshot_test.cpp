@@ -26,10 +26,16 @@ public:
   } prologue_return;
   static prologue_return prologue(int n); // common to the below 5 fxs
   static void read_whole_region();
+  static void read_large_region();
   static void read_region_parts();
   static void compare_whole_region();
   static void compare_region_parts();
   static void read_pointer();
+  static void read_vectored();
+  static void read_cached();
+  static void read_with_parent();
+  static void read_soft_dirty();
+  static void restore_with_parent();
 
   static void cleanup()
   {
@@ -106,6 +112,20 @@ void snap_test_helper::read_whole_region()
   }
 }
 
+void snap_test_helper::read_large_region()
+{
+  // Larger than a batch of pages read at once
+  prologue_return ret = prologue(150);
+  const void* read    = ret.region->read(ret.dstn, ret.src, ret.size);
+  INFO("Mismatch in MC_region_read()");
+  REQUIRE(not memcmp(ret.src, read, ret.size));
+
+  munmap(ret.dstn, ret.size);
+  munmap(ret.src, ret.size);
+  delete ret.region0;
+  delete ret.region;
+}
+
 void snap_test_helper::read_region_parts()
 {
   for (int n = 1; n != 32; ++n) {
@@ -179,6 +199,128 @@ void snap_test_helper::read_pointer()
   delete region2;
 }
 
+void snap_test_helper::read_vectored()
+{
+  prologue_return ret = prologue(4);
+  std::vector<simgrid::mc::RemoteRead> reads;
+  for (int j = 0; j != 100; ++j) {
+    size_t offset = rnd_engine() % ret.size;
+    size_t size   = rnd_engine() % (ret.size - offset);
+    reads.push_back({(char*)ret.dstn + offset, size, simgrid::mc::remote((char*)ret.src + offset)});
+  }
+  mc_model_checker->process().read_vectored(reads);
+  for (auto const& read : reads) {
+    size_t offset = (char*)read.buffer - (char*)ret.dstn;
+    INFO("Mismatch in RemoteClient::read_vectored()");
+    REQUIRE(not memcmp((char*)ret.src + offset, read.buffer, read.size));
+  }
+
+  munmap(ret.dstn, ret.size);
+  munmap(ret.src, ret.size);
+  delete ret.region0;
+  delete ret.region;
+}
+
+void snap_test_helper::read_cached()
+{
+  prologue_return ret = prologue(4);
+  simgrid::mc::RemoteClient& process = mc_model_checker->process();
+  {
+    simgrid::mc::ReadCacheScope cache(process);
+    for (int j = 0; j != 100; ++j) {
+      size_t offset = rnd_engine() % ret.size;
+      size_t size   = rnd_engine() % 64;
+      if (offset + size > ret.size)
+        size = ret.size - offset;
+      process.read_bytes((char*)ret.dstn + offset, size, simgrid::mc::remote((char*)ret.src + offset));
+      INFO("Mismatch in cached RemoteClient::read_bytes()");
+      REQUIRE(not memcmp((char*)ret.src + offset, (char*)ret.dstn + offset, size));
+    }
+
+    // The writes through the process are seen by the next reads
+    char value = 42;
+    process.write_bytes(&value, 1, simgrid::mc::remote(ret.src));
+    process.read_bytes(ret.dstn, 1, simgrid::mc::remote(ret.src));
+    INFO("Stale data in the read cache");
+    REQUIRE(*(char*)ret.dstn == 42);
+  }
+
+  munmap(ret.dstn, ret.size);
+  munmap(ret.src, ret.size);
+  delete ret.region0;
+  delete ret.region;
+}
+
+void snap_test_helper::read_with_parent()
+{
+  // The even pages were modified after the first snapshot (region0) of the prologue
+  const int n         = 100;
+  prologue_return ret = prologue(n);
+  std::vector<bool> dirty(n);
+  for (int i = 0; i < n; i += 2)
+    dirty[i] = true;
+
+  simgrid::mc::ChunkedData chunks(mc_model_checker->page_store(), mc_model_checker->process(),
+                                  simgrid::mc::remote(ret.src), n, ret.region0->get_chunks(), dirty);
+  for (int i = 0; i < n; i++) {
+    INFO("Mismatch in the pages taken from the parent snapshot");
+    REQUIRE(not memcmp((char*)ret.src + i * xbt_pagesize, chunks.page(i), xbt_pagesize));
+    REQUIRE(chunks.pageno(i) == (dirty[i] ? ret.region : ret.region0)->get_chunks().pageno(i));
+  }
+
+  munmap(ret.dstn, ret.size);
+  munmap(ret.src, ret.size);
+  delete ret.region0;
+  delete ret.region;
+}
+
+void snap_test_helper::read_soft_dirty()
+{
+  const int n                        = 4;
+  prologue_return ret                = prologue(n);
+  simgrid::mc::RemoteClient& process = mc_model_checker->process();
+  process.reset_soft_dirty();
+  for (int i = 1; i < n; i += 2)
+    init_memory((char*)ret.src + i * xbt_pagesize, xbt_pagesize);
+
+  INFO("Mismatch in RemoteClient::read_soft_dirty()");
+  REQUIRE(process.read_soft_dirty(simgrid::mc::remote(ret.src), n) == std::vector<bool>({false, true, false, true}));
+
+  munmap(ret.dstn, ret.size);
+  munmap(ret.src, ret.size);
+  delete ret.region0;
+  delete ret.region;
+}
+
+void snap_test_helper::restore_with_parent()
+{
+  // The memory is the one of the region (the parent snapshot), whose even pages differ from the ones of region0
+  const int n                        = 8;
+  prologue_return ret                = prologue(n);
+  simgrid::mc::RemoteClient& process = mc_model_checker->process();
+  _sg_mc_soft_dirty                  = true;
+  mc_model_checker->parent_regions().emplace_back(simgrid::mc::remote(ret.src), ret.region->get_chunks());
+  process.reset_soft_dirty();
+  init_memory((char*)ret.src + xbt_pagesize, xbt_pagesize);
+
+  // Only the even pages and the page written since the parent snapshot are restored
+  ret.region0->restore();
+  INFO("Mismatch in the restored memory");
+  REQUIRE(not memcmp(ret.src, ret.region0->read(ret.dstn, ret.src, ret.size), ret.size));
+  std::vector<bool> dirty = process.read_soft_dirty(simgrid::mc::remote(ret.src), n);
+  for (int i = 0; i < n; i++) {
+    INFO("Unexpected write to page " << i);
+    REQUIRE(dirty[i] == (i % 2 == 0 || i == 1));
+  }
+
+  mc_model_checker->parent_regions().clear();
+  _sg_mc_soft_dirty = false;
+  munmap(ret.dstn, ret.size);
+  munmap(ret.src, ret.size);
+  delete ret.region0;
+  delete ret.region;
+}
+
 /*************** End: class snap_test_helper *****************************/
 
 TEST_CASE("MC::Snapshot: A copy/snapshot of a given memory region", "MC::Snapshot")
@@ -191,6 +333,9 @@ TEST_CASE("MC::Snapshot: A copy/snapshot of a given memory region", "MC::Snapsho
   INFO("Read whole region");
   snap_test_helper::read_whole_region();
 
+  INFO("Read large region");
+  snap_test_helper::read_large_region();
+
   INFO("Read region parts");
   snap_test_helper::read_region_parts();
 
@@ -203,5 +348,23 @@ TEST_CASE("MC::Snapshot: A copy/snapshot of a given memory region", "MC::Snapsho
   INFO("Read pointer");
   snap_test_helper::read_pointer();
 
+  INFO("Vectored read");
+  snap_test_helper::read_vectored();
+
+  INFO("Cached read");
+  snap_test_helper::read_cached();
+
+  INFO("Read with a parent snapshot");
+  snap_test_helper::read_with_parent();
+
+  if (simgrid::mc::RemoteClient::soft_dirty_supported()) {
+    INFO("Soft-dirty bits");
+    snap_test_helper::read_soft_dirty();
+
+    INFO("Restore with a parent snapshot");
+    snap_test_helper::restore_with_parent();
+  } else
+    WARN("The soft-dirty bits are not supported by this kernel: their tests are skipped");
+
   snap_test_helper::cleanup();
 }
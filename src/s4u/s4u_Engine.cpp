@@ -341,6 +341,16 @@ kernel::routing::NetPoint* Engine::netpoint_by_name_or_null(const std::string& n
   return netp == pimpl->netpoints_.end() ? nullptr : netp->second;
 }
 
+unsigned long Engine::get_route_cache_hits()
+{
+  return kernel::routing::NetZoneImpl::get_route_cache_hits();
+}
+
+unsigned long Engine::get_route_cache_misses()
+{
+  return kernel::routing::NetZoneImpl::get_route_cache_misses();
+}
+
 std::vector<kernel::routing::NetPoint*> Engine::get_all_netpoints()
 {
   std::vector<kernel::routing::NetPoint*> res;
@@ -218,9 +218,11 @@ static void _sg_cfg_cb_contexts_parallel_mode(const std::string& mode_name)
     SIMIX_context_set_parallel_mode(XBT_PARMAP_FUTEX);
   } else if (mode_name == "busy_wait") {
     SIMIX_context_set_parallel_mode(XBT_PARMAP_BUSY_WAIT);
+  } else if (mode_name == "work_stealing") {
+    SIMIX_context_set_parallel_mode(XBT_PARMAP_WORK_STEALING);
   } else {
     xbt_die("Command line setting of the parallel synchronization mode should "
-            "be one of \"posix\", \"futex\" or \"busy_wait\"");
+            "be one of \"posix\", \"futex\", \"busy_wait\" or \"work_stealing\"");
   }
 }
 
@@ -343,7 +345,8 @@ void sg_config_init(int *argc, char **argv)
   std::string default_synchro_mode = "busy_wait";
 #endif
   simgrid::config::declare_flag<std::string>("contexts/synchro", "Synchronization mode to use when running contexts in "
-                                                                 "parallel (either futex, posix or busy_wait)",
+                                                                 "parallel (either futex, posix, busy_wait or "
+                                                                 "work_stealing)",
                                              default_synchro_mode, &_sg_cfg_cb_contexts_parallel_mode);
 
   // For smpi/bw-factor and smpi/lat-factor
@@ -360,6 +363,10 @@ void sg_config_init(int *argc, char **argv)
                                              "65472:11.6436;15424:3.48845;9376:2.59299;5776:2.18796;3484:1.88101;"
                                              "1426:1.61075;732:1.9503;257:1.95341;0:2.01467");
   simgrid::config::alias("smpi/lat-factor", {"smpi/lat_factor"});
+  simgrid::config::declare_flag<bool>("smpi/interpolate-factors",
+                                      "Whether to interpolate linearly the bandwidth and latency factors between "
+                                      "the thresholds, instead of using steps.",
+                                      false);
   simgrid::config::declare_flag<std::string>("smpi/IB-penalty-factors",
                                              "Correction factor to communications using Infiniband model with "
                                              "contention (default value based on Stampede cluster profiling)",
@@ -444,6 +451,11 @@ void sg_config_init(int *argc, char **argv)
   simgrid::config::declare_flag<std::string>(
       "smpi/or", "Small messages timings (MPI_Recv minimum time for small messages)", "0:0:0:0:0");
 
+  simgrid::config::declare_flag<bool>("smpi/indexed-matching",
+                                      "Whether the mailboxes should index the pending requests by source and tag, "
+                                      "instead of testing all of them to find a matching one.",
+                                      true);
+
   simgrid::config::declare_flag<double>("smpi/iprobe-cpu-usage",
                                         "Maximum usage of CPUs by MPI_Iprobe() calls. We've observed that MPI_Iprobes "
                                         "consume significantly less power than the maximum of a specific application. "
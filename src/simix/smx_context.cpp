@@ -9,6 +9,7 @@
 #include "src/simix/smx_private.hpp"
 #include "xbt/config.hpp"
 
+#include <algorithm>
 #include <thread>
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(simix_context, simix, "Context switching mechanism");
@@ -52,6 +53,12 @@ static int smx_parallel_contexts = 1;
 static int smx_parallel_threshold = 2;
 static e_xbt_parmap_mode_t smx_parallel_synchronization_mode = XBT_PARMAP_DEFAULT;
 
+static simgrid::config::Flag<bool> cfg_adaptive_threshold{
+    "contexts/adaptive-threshold",
+    "Whether to run each scheduling round sequentially or in parallel depending on the measured cost of the previous "
+    "rounds of similar size (raw, ucontext and boost contexts)",
+    false};
+
 /**
  * This function is called by SIMIX_global_init() to initialize the context module.
  */
@@ -191,3 +198,107 @@ e_xbt_parmap_mode_t SIMIX_context_get_parallel_mode() {
 void SIMIX_context_set_parallel_mode(e_xbt_parmap_mode_t mode) {
   smx_parallel_synchronization_mode = mode;
 }
+
+namespace simgrid {
+namespace simix {
+/* Amount of rounds run in the cheapest mode before trying the other one again */
+static constexpr unsigned PROBE_PERIOD = 32;
+
+void RoundPolicy::Cost::add(size_t actors, double time)
+{
+  rounds++;
+  total_time += time;
+  /* The first round pays for the warm-up (creation of the worker threads, cold caches), and is not representative */
+  if (rounds == 1)
+    return;
+  double sample = time / actors;
+  if (per_actor < 0) {
+    per_actor = sample;
+  } else {
+    /* Bound the effect of the rounds that got preempted by the OS */
+    sample = std::min(sample, 4 * per_actor);
+    per_actor += (sample - per_actor) / 8;
+  }
+}
+
+RoundPolicy::Bucket& RoundPolicy::bucket_of(size_t actors)
+{
+  unsigned rank = 0;
+  while (actors >>= 1)
+    rank++;
+  if (rank >= buckets_.size())
+    buckets_.resize(rank + 1);
+  return buckets_[rank];
+}
+
+/** Chooses how to run the next round, of the given amount of actors */
+void RoundPolicy::start_round(size_t actors)
+{
+  actors_   = actors;
+  parallel_ = SIMIX_context_is_parallel() && actors >= static_cast<size_t>(SIMIX_context_get_parallel_threshold());
+  bool adaptive = cfg_adaptive_threshold && SIMIX_context_is_parallel() && actors >= 2;
+  measured_     = actors > 0 && (adaptive || XBT_LOG_ISENABLED(simix_context, xbt_log_priority_debug));
+  if (not measured_)
+    return;
+
+  if (adaptive) {
+    Bucket& bucket = bucket_of(actors);
+    if (bucket.sequential.per_actor < 0) {
+      parallel_ = false;
+    } else if (bucket.parallel.per_actor < 0) {
+      parallel_ = true;
+    } else {
+      parallel_ = bucket.parallel.per_actor < bucket.sequential.per_actor;
+      if (bucket.rounds_before_probe == 0) {
+        parallel_                  = not parallel_;
+        bucket.rounds_before_probe = PROBE_PERIOD;
+      } else {
+        bucket.rounds_before_probe--;
+      }
+    }
+  }
+  start_ = std::chrono::steady_clock::now();
+}
+
+/** Records the cost of the round that just ran */
+void RoundPolicy::end_round()
+{
+  if (not measured_)
+    return;
+  double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+  XBT_DEBUG("Ran %zu actors %s in %g seconds", actors_, parallel_ ? "in parallel" : "sequentially", time);
+  Bucket& bucket = bucket_of(actors_);
+  (parallel_ ? bucket.parallel : bucket.sequential).add(actors_, time);
+}
+
+size_t RoundPolicy::get_adapted_threshold() const
+{
+  size_t threshold = 0;
+  for (size_t rank = buckets_.size(); rank-- > 0;) {
+    Bucket const& bucket = buckets_[rank];
+    if (bucket.sequential.per_actor < 0 || bucket.parallel.per_actor < 0)
+      continue;
+    if (bucket.parallel.per_actor >= bucket.sequential.per_actor)
+      break;
+    threshold = static_cast<size_t>(1) << rank;
+  }
+  return threshold;
+}
+
+/** Logs the cost of the rounds, by size (at verbose level) */
+void RoundPolicy::report() const
+{
+  for (size_t rank = 0; rank < buckets_.size(); rank++) {
+    Bucket const& bucket = buckets_[rank];
+    if (bucket.sequential.rounds + bucket.parallel.rounds == 0)
+      continue;
+    XBT_VERB("Rounds of %zu to %zu actors: %lu sequential (%g s, %g s per actor), %lu parallel (%g s, %g s per actor)",
+             static_cast<size_t>(1) << rank, (static_cast<size_t>(2) << rank) - 1, bucket.sequential.rounds,
+             bucket.sequential.total_time, bucket.sequential.per_actor, bucket.parallel.rounds,
+             bucket.parallel.total_time, bucket.parallel.per_actor);
+  }
+  if (cfg_adaptive_threshold && SIMIX_context_is_parallel())
+    XBT_VERB("Adapted parallel threshold: %zu actors", get_adapted_threshold());
+}
+} // namespace simix
+} // namespace simgrid
@@ -19,6 +19,7 @@
 #include "src/simix/smx_private.hpp"
 #include "src/surf/StorageImpl.hpp"
 #include "src/surf/xml/platf.hpp"
+#include "xbt/event_queue.hpp"
 
 #if SIMGRID_HAVE_MC
 #include "src/mc/remote/Client.hpp"
@@ -130,18 +131,42 @@ static void install_segvhandler()
 namespace simgrid {
 namespace simix {
 
+/* The pending timers, and the ones that can be reused */
+static xbt::EventQueue<Timer*> simix_timers;
+static std::vector<Timer*> free_timers;
+
+static void recycle_timer(Timer* timer)
+{
+  timer->callback = simgrid::xbt::Task<void()>(); // release what the callback captured
+  free_timers.push_back(timer);
+}
+
 Timer* Timer::set(double date, simgrid::xbt::Task<void()>&& callback)
 {
-  Timer* timer   = new Timer(date, std::move(callback));
-  timer->handle_ = simix_timers.emplace(std::make_pair(date, timer));
+  Timer* timer;
+  if (free_timers.empty()) {
+    timer = new Timer(date, std::move(callback));
+  } else {
+    timer = free_timers.back();
+    free_timers.pop_back();
+    timer->date     = date;
+    timer->callback = std::move(callback);
+  }
+  timer->handle_ = simix_timers.push(date, timer);
   return timer;
 }
 
 /** @brief cancels a timer that was added earlier */
 void Timer::remove()
 {
-  simgrid::simix::simix_timers.erase(handle_);
-  delete this;
+  simix_timers.cancel(handle_);
+  recycle_timer(this);
+}
+
+/** @brief Returns the date of the next timer to trigger (or -1 if there is none) */
+double Timer::next()
+{
+  return simix_timers.empty() ? -1.0 : simix_timers.top_date();
 }
 
 /** Execute all the tasks that are queued, e.g. `.then()` callbacks of futures. */
@@ -187,7 +212,9 @@ void Global::empty_trash()
  */
 void Global::run_all_actors()
 {
+  round_policy.start_round(actors_to_run.size());
   simix_global->context_factory->run_all();
+  round_policy.end_round();
 
   actors_to_run.swap(actors_that_ran);
   actors_to_run.clear();
@@ -290,10 +317,11 @@ void SIMIX_clean()
   /* Exit the SIMIX network module */
   SIMIX_mailbox_exit();
 
-  while (not simgrid::simix::simix_timers.empty()) {
-    delete simgrid::simix::simix_timers.top().second;
-    simgrid::simix::simix_timers.pop();
-  }
+  while (not simgrid::simix::simix_timers.empty())
+    delete simgrid::simix::simix_timers.pop();
+  for (auto* timer : simgrid::simix::free_timers)
+    delete timer;
+  simgrid::simix::free_timers.clear();
   /* Free the remaining data structures */
   simix_global->actors_to_run.clear();
   simix_global->actors_that_ran.clear();
@@ -359,13 +387,12 @@ static void SIMIX_wake_processes()
 static bool SIMIX_execute_timers()
 {
   bool result = false;
-  while (not simgrid::simix::simix_timers.empty() && SIMIX_get_clock() >= simgrid::simix::simix_timers.top().first) {
+  while (not simgrid::simix::simix_timers.empty() && SIMIX_get_clock() >= simgrid::simix::simix_timers.top_date()) {
     result = true;
     // FIXME: make the timers being real callbacks (i.e. provide dispatchers that read and expand the args)
-    smx_timer_t timer = simgrid::simix::simix_timers.top().second;
-    simgrid::simix::simix_timers.pop();
+    smx_timer_t timer = simgrid::simix::simix_timers.pop();
     timer->callback();
-    delete timer;
+    simgrid::simix::recycle_timer(timer);
   }
   return result;
 }
@@ -525,6 +552,7 @@ void SIMIX_run()
     simgrid::s4u::Engine::on_deadlock();
     xbt_abort();
   }
+  simix_global->round_policy.report();
   simgrid::s4u::Engine::on_simulation_end();
 }
 
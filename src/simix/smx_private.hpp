@@ -11,6 +11,7 @@
 #include "src/kernel/context/Context.hpp"
 
 #include <boost/intrusive/list.hpp>
+#include <chrono>
 #include <mutex>
 #include <unordered_map>
 #include <vector>
@@ -20,6 +21,44 @@
 namespace simgrid {
 namespace simix {
 
+/** @brief Decides whether each scheduling round runs the ready actors in parallel
+ *
+ * By default, the rounds of at least contexts/parallel-threshold actors are run in parallel. With
+ * contexts/adaptive-threshold, the cost of the rounds is measured, and each round is run in the mode that was the
+ * cheapest so far for the rounds of similar size (rounds of 2^k to 2^(k+1)-1 actors). The other mode is still tried from
+ * time to time, so that the decision follows the changes of the simulation.
+ */
+class RoundPolicy {
+  struct Cost {
+    unsigned long rounds = 0;
+    double total_time    = 0.0;  // in seconds, warm-up rounds included
+    double per_actor     = -1.0; // moving average of the time per actor, or -1 if not measured yet
+    void add(size_t actors, double time);
+  };
+  struct Bucket {
+    Cost sequential;
+    Cost parallel;
+    unsigned rounds_before_probe = 0;
+  };
+  std::vector<Bucket> buckets_;
+  size_t actors_ = 0;
+  bool parallel_ = false;
+  bool measured_ = false;
+  std::chrono::steady_clock::time_point start_;
+
+  Bucket& bucket_of(size_t actors);
+
+public:
+  void start_round(size_t actors);
+  void end_round();
+  /** Whether the current round is run in parallel */
+  bool is_parallel() const { return parallel_; }
+  /** Smallest amount of actors from which the parallel rounds were the cheapest so far, or 0 if they never were */
+  size_t get_adapted_threshold() const;
+  void report() const;
+};
+
+
 class Global {
   friend XBT_PUBLIC bool simgrid::s4u::this_actor::is_maestro();
 
@@ -33,6 +72,8 @@ public:
   void empty_trash();
   void run_all_actors();
 
+  RoundPolicy round_policy;
+
   smx_context_factory_t context_factory = nullptr;
   std::vector<smx_actor_t> actors_to_run;
   std::vector<smx_actor_t> actors_that_ran;
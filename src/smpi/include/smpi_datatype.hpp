@@ -8,7 +8,9 @@
 
 #include "smpi_f2c.hpp"
 #include "smpi_keyvals.hpp"
+#include <mutex>
 #include <string>
+#include <vector>
 
 constexpr unsigned DT_FLAG_DESTROYED   = 0x0001; /**< user destroyed but some other layers still have a reference */
 constexpr unsigned DT_FLAG_COMMITED    = 0x0002; /**< ready to be used for a send/recv operation */
@@ -76,6 +78,17 @@ struct integer128_t {
 namespace simgrid{
 namespace smpi{
 
+/** @brief Block of bytes of the data of a datatype, possibly repeated with a constant stride
+ *
+ * The copy plan of a datatype is the list of the blocks of one element, in the order of its type map. */
+struct DatatypeSegment {
+  MPI_Aint offset;   /**< offset of the first block, from the beginning of the element */
+  size_t length;     /**< size of each block, in bytes */
+  int count;         /**< number of blocks */
+  MPI_Aint stride;   /**< distance between the blocks, in bytes */
+  MPI_Datatype type; /**< non-derived type of the data, on which the operations are applied */
+};
+
 class Datatype : public F2C, public Keyval{
   char* name_;
   /* The id here is the (unique) datatype id used for this datastructure.
@@ -88,6 +101,10 @@ class Datatype : public F2C, public Keyval{
   MPI_Aint ub_;
   int flags_;
   int refcount_;
+  std::vector<DatatypeSegment> plan_;
+  std::once_flag plan_compiled_; // The datatypes that were not committed get compiled by their first user thread
+
+  const std::vector<DatatypeSegment>& get_plan();
 
 public:
   static std::unordered_map<int, smpi_key_elem> keyvals_;
@@ -124,8 +141,11 @@ public:
   void set_name(const char* name);
   static int copy(const void* sendbuf, int sendcount, MPI_Datatype sendtype, void* recvbuf, int recvcount,
                   MPI_Datatype recvtype);
-  virtual void serialize(const void* noncontiguous, void* contiguous, int count);
-  virtual void unserialize(const void* contiguous, void* noncontiguous, int count, MPI_Op op);
+  static void add_segment(std::vector<DatatypeSegment>& plan, MPI_Aint offset, size_t length, MPI_Datatype type);
+  /** Appends to the plan the blocks of count consecutive elements, the first one starting at the given displacement */
+  virtual void flatten(std::vector<DatatypeSegment>& plan, MPI_Aint displacement, int count);
+  void serialize(const void* noncontiguous, void* contiguous, int count);
+  void unserialize(const void* contiguous, void* noncontiguous, int count, MPI_Op op);
   static int keyval_create(MPI_Type_copy_attr_function* copy_fn, MPI_Type_delete_attr_function* delete_fn, int* keyval,
                            void* extra_state);
   static int keyval_free(int* keyval);
@@ -17,9 +17,9 @@ namespace simgrid {
 namespace smpi {
 
 class Host {
-  std::vector<s_smpi_factor_t> orecv_parsed_values;
-  std::vector<s_smpi_factor_t> osend_parsed_values;
-  std::vector<s_smpi_factor_t> oisend_parsed_values;
+  FactorTable orecv_parsed_values;
+  FactorTable osend_parsed_values;
+  FactorTable oisend_parsed_values;
   s4u::Host* host = nullptr;
 
 public:
@@ -13,14 +13,27 @@ namespace simgrid{
 namespace smpi{
 
 class Op : public F2C{
-  MPI_User_function* func_;
+public:
+  /** Function applying a predefined operation to a given datatype */
+  typedef void (*kernel_type)(const void* invec, void* inoutvec, int len, MPI_Datatype datatype);
+  typedef kernel_type (*kernel_selector_type)(MPI_Datatype datatype);
+
+private:
+  MPI_User_function* func_              = nullptr;
+  kernel_selector_type kernel_selector_ = nullptr;
   bool is_commutative_;
   bool is_fortran_op_ = false;
   int refcount_ = 1;
   bool predefined_;
 
+  kernel_type get_kernel(MPI_Datatype datatype);
+
 public:
   Op(MPI_User_function* function, bool commutative, bool predefined=false) : func_(function), is_commutative_(commutative), predefined_(predefined) {}
+  Op(kernel_selector_type selector, bool commutative)
+      : kernel_selector_(selector), is_commutative_(commutative), predefined_(true)
+  {
+  }
   bool is_commutative() { return is_commutative_; }
   bool is_fortran_op() { return is_fortran_op_; }
   // tell that we were created from fortran, so we need to translate the type to fortran when called
@@ -18,4 +18,34 @@ struct s_smpi_factor_t {
 
 XBT_PUBLIC std::vector<s_smpi_factor_t> parse_factor(const std::string& smpi_coef_string);
 
+namespace simgrid {
+namespace smpi {
+
+/** @brief Piecewise function of the message size, given as a string such as "0:1.5;1024:2.5" (see parse_factor())
+ *
+ * Each section applies to the sizes that are larger than its boundary (and not larger than the next boundary). The
+ * section of a given size is binary searched. With interpolation, the factors vary linearly from one boundary to the
+ * next one instead of being constant over each section.
+ */
+class XBT_PUBLIC FactorTable {
+  std::vector<s_smpi_factor_t> sections_;
+  bool interpolate_ = false;
+
+  size_t count_smaller_boundaries(double size) const;
+
+public:
+  FactorTable() = default;
+  explicit FactorTable(const std::string& smpi_coef_string, bool interpolate = false);
+
+  bool empty() const { return sections_.empty(); }
+  /** Returns the first value of the section of that size, or the default value if the size is not larger than the
+   * first boundary */
+  double get_factor(double size, double default_value = 1.0) const;
+  /** Returns the affine cost (first value + second value * size) of the section of that size. The first section is
+   * used for the sizes that are not larger than its boundary, and the cost is 0 if there is no section. */
+  double get_cost(size_t size) const;
+};
+} // namespace smpi
+} // namespace simgrid
+
 #endif
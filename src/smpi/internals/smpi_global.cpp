@@ -9,7 +9,9 @@
 #include "smpi_coll.hpp"
 #include "smpi_f2c.hpp"
 #include "smpi_host.hpp"
+#include "smpi_request.hpp"
 #include "src/kernel/activity/CommImpl.hpp"
+#include "src/kernel/activity/MailboxImpl.hpp"
 #include "src/simix/smx_private.hpp"
 #include "src/smpi/include/smpi_actor.hpp"
 #include "xbt/config.hpp"
@@ -357,6 +359,9 @@ static void smpi_init_options(){
     XBT_INFO("mmap privatization is broken on this platform, switching to dlopen privatization instead.");
     smpi_privatize_global_variables = SmpiPrivStrategies::DLOPEN;
   }
+  if (smpi_privatize_global_variables == SmpiPrivStrategies::MMAP && SIMIX_context_is_parallel())
+    xbt_die("The mmap privatization switches the data segment of the whole process at each context switch, so it "
+            "cannot be used with parallel contexts. Please use smpi/privatization:dlopen instead.");
 
   std::string val = simgrid::config::get_value<std::string>("smpi/shared-malloc");
   if ((val == "yes") || (val == "1") || (val == "on") || (val == "global")) {
@@ -369,6 +374,13 @@ static void smpi_init_options(){
     xbt_die("Invalid value '%s' for option smpi/shared-malloc. Possible values: 'on' or 'global', 'local', 'off'",
             val.c_str());
   }
+
+  if (simgrid::config::get_value<bool>("smpi/indexed-matching")) {
+    simgrid::kernel::activity::MailboxImpl::set_match_key_fun(&simgrid::smpi::Request::match_recv,
+                                                              &simgrid::smpi::Request::match_key);
+    simgrid::kernel::activity::MailboxImpl::set_match_key_fun(&simgrid::smpi::Request::match_send,
+                                                              &simgrid::smpi::Request::match_key);
+  }
 }
 
 typedef std::function<int(int argc, char *argv[])> smpi_entry_point_type;
@@ -528,61 +540,61 @@ static void smpi_init_privatization_dlopen(const std::string& executable)
     }
   }
 
+  // Each copy is loaded by maestro when creating the actor (and not by the actor itself when it starts), so that the
+  // actors can be started by parallel worker threads.
   simix_global->default_function = [executable, fdin_size](std::vector<std::string> args) {
-    return std::function<void()>([executable, fdin_size, args] {
-      static std::size_t rank = 0;
-      // Copy the dynamic library:
-      std::string target_executable =
-          executable + "_" + std::to_string(getpid()) + "_" + std::to_string(rank) + ".so";
-
-      smpi_copy_file(executable, target_executable, fdin_size);
-      // if smpi/privatize-libs is set, duplicate pointed lib and link each executable copy to a different one.
-      std::vector<std::string> target_libs;
-      for (auto const& libpath : privatize_libs_paths) {
-        // if we were given a full path, strip it
-        size_t index = libpath.find_last_of("/\\");
-        std::string libname;
-        if (index != std::string::npos)
-          libname = libpath.substr(index + 1);
-
-        if (not libname.empty()) {
-          // load the library to add it to the local libs, to get the absolute path
-          struct stat fdin_stat2;
-          stat(libpath.c_str(), &fdin_stat2);
-          off_t fdin_size2 = fdin_stat2.st_size;
-
-          // Copy the dynamic library, the new name must be the same length as the old one
-          // just replace the name with 7 digits for the rank and the rest of the name.
-          unsigned int pad = 7;
-          if (libname.length() < pad)
-            pad = libname.length();
-          std::string target_lib =
-              std::string(pad - std::to_string(rank).length(), '0') + std::to_string(rank) + libname.substr(pad);
-          target_libs.push_back(target_lib);
-          XBT_DEBUG("copy lib %s to %s, with size %lld", libpath.c_str(), target_lib.c_str(), (long long)fdin_size2);
-          smpi_copy_file(libpath, target_lib, fdin_size2);
-
-          std::string sedcommand = "sed -i -e 's/" + libname + "/" + target_lib + "/g' " + target_executable;
-          xbt_assert(system(sedcommand.c_str()) == 0, "error while applying sed command %s \n", sedcommand.c_str());
-        }
+    static std::size_t rank = 0;
+    // Copy the dynamic library:
+    std::string target_executable = executable + "_" + std::to_string(getpid()) + "_" + std::to_string(rank) + ".so";
+
+    smpi_copy_file(executable, target_executable, fdin_size);
+    // if smpi/privatize-libs is set, duplicate pointed lib and link each executable copy to a different one.
+    std::vector<std::string> target_libs;
+    for (auto const& libpath : privatize_libs_paths) {
+      // if we were given a full path, strip it
+      size_t index = libpath.find_last_of("/\\");
+      std::string libname;
+      if (index != std::string::npos)
+        libname = libpath.substr(index + 1);
+
+      if (not libname.empty()) {
+        // load the library to add it to the local libs, to get the absolute path
+        struct stat fdin_stat2;
+        stat(libpath.c_str(), &fdin_stat2);
+        off_t fdin_size2 = fdin_stat2.st_size;
+
+        // Copy the dynamic library, the new name must be the same length as the old one
+        // just replace the name with 7 digits for the rank and the rest of the name.
+        unsigned int pad = 7;
+        if (libname.length() < pad)
+          pad = libname.length();
+        std::string target_lib =
+            std::string(pad - std::to_string(rank).length(), '0') + std::to_string(rank) + libname.substr(pad);
+        target_libs.push_back(target_lib);
+        XBT_DEBUG("copy lib %s to %s, with size %lld", libpath.c_str(), target_lib.c_str(), (long long)fdin_size2);
+        smpi_copy_file(libpath, target_lib, fdin_size2);
+
+        std::string sedcommand = "sed -i -e 's/" + libname + "/" + target_lib + "/g' " + target_executable;
+        xbt_assert(system(sedcommand.c_str()) == 0, "error while applying sed command %s \n", sedcommand.c_str());
       }
+    }
 
-      rank++;
-      // Load the copy and resolve the entry point:
-      void* handle    = dlopen(target_executable.c_str(), RTLD_LAZY | RTLD_LOCAL | WANT_RTLD_DEEPBIND);
-      int saved_errno = errno;
-      if (simgrid::config::get_value<bool>("smpi/keep-temps") == false) {
-        unlink(target_executable.c_str());
-        for (const std::string& target_lib : target_libs)
-          unlink(target_lib.c_str());
-      }
-      xbt_assert(handle != nullptr, "dlopen failed: %s (errno: %d -- %s)", dlerror(), saved_errno,
-                 strerror(saved_errno));
+    rank++;
+    // Load the copy and resolve the entry point:
+    void* handle    = dlopen(target_executable.c_str(), RTLD_LAZY | RTLD_LOCAL | WANT_RTLD_DEEPBIND);
+    int saved_errno = errno;
+    if (simgrid::config::get_value<bool>("smpi/keep-temps") == false) {
+      unlink(target_executable.c_str());
+      for (const std::string& target_lib : target_libs)
+        unlink(target_lib.c_str());
+    }
+    xbt_assert(handle != nullptr, "dlopen failed: %s (errno: %d -- %s)", dlerror(), saved_errno,
+               strerror(saved_errno));
 
-      smpi_entry_point_type entry_point = smpi_resolve_function(handle);
-      xbt_assert(entry_point, "Could not resolve entry point");
-      smpi_run_entry_point(entry_point, executable, args);
-    });
+    smpi_entry_point_type entry_point = smpi_resolve_function(handle);
+    xbt_assert(entry_point, "Could not resolve entry point");
+    return std::function<void()>(
+        [entry_point, executable, args] { smpi_run_entry_point(entry_point, executable, args); });
   };
 }
 
@@ -627,6 +639,8 @@ int smpi_main(const char* executable, int argc, char* argv[])
   SIMIX_comm_set_copy_data_callback(smpi_comm_copy_buffer_callback);
 
   smpi_init_options();
+  if (smpi_privatize_global_variables != SmpiPrivStrategies::MMAP)
+    SMPI_switch_data_segment = nullptr; // Only the mmap privatization needs to switch the data segment of the actors
   if (smpi_privatize_global_variables == SmpiPrivStrategies::DLOPEN)
     smpi_init_privatization_dlopen(executable);
   else
@@ -10,6 +10,8 @@
 #include <boost/tokenizer.hpp>
 #include "src/surf/xml/platf_private.hpp"
 
+#include <algorithm>
+
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(smpi_utils, smpi, "Logging specific to SMPI (utils)");
 
 std::vector<s_smpi_factor_t> parse_factor(const std::string& smpi_coef_string)
@@ -70,3 +72,44 @@ std::vector<s_smpi_factor_t> parse_factor(const std::string& smpi_coef_string)
 
   return smpi_factor;
 }
+
+namespace simgrid {
+namespace smpi {
+
+FactorTable::FactorTable(const std::string& smpi_coef_string, bool interpolate)
+    : sections_(parse_factor(smpi_coef_string)), interpolate_(interpolate)
+{
+}
+
+/* The section of a size is the last one with a smaller boundary: this returns its index + 1 */
+size_t FactorTable::count_smaller_boundaries(double size) const
+{
+  return std::lower_bound(sections_.begin(), sections_.end(), size,
+                          [](const s_smpi_factor_t& fact, double value) { return fact.factor < value; }) -
+         sections_.begin();
+}
+
+double FactorTable::get_factor(double size, double default_value) const
+{
+  size_t count = count_smaller_boundaries(size);
+  if (count == 0)
+    return default_value;
+  const s_smpi_factor_t& section = sections_[count - 1];
+  if (not interpolate_ || count == sections_.size())
+    return section.values.front();
+  // the next boundary is strictly larger than the size, which is strictly larger than the boundary of the section
+  const s_smpi_factor_t& next = sections_[count];
+  return section.values.front() + (next.values.front() - section.values.front()) * (size - section.factor) /
+                                      static_cast<double>(next.factor - section.factor);
+}
+
+double FactorTable::get_cost(size_t size) const
+{
+  if (sections_.empty())
+    return 0.0;
+  size_t count                   = count_smaller_boundaries(size);
+  const s_smpi_factor_t& section = sections_[count == 0 ? 0 : count - 1];
+  return section.values[0] + section.values[1] * size;
+}
+} // namespace smpi
+} // namespace simgrid
@@ -11,12 +11,53 @@
 #include "src/instr/instr_private.hpp"
 #include "src/smpi/include/smpi_actor.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <string>
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(smpi_datatype, smpi, "Logging specific to SMPI (datatype)");
 
 static std::unordered_map<std::string, simgrid::smpi::Datatype*> id2type_lookup;
 
+namespace {
+/* Position in the data of some elements of a datatype, walking through the segments of its copy plan */
+class PlanCursor {
+  const std::vector<simgrid::smpi::DatatypeSegment>& plan_;
+  char* element_;
+  MPI_Aint extent_;
+  size_t segment_ = 0;
+  int block_      = 0;
+  size_t done_    = 0; // bytes already walked in the current block
+
+public:
+  PlanCursor(const std::vector<simgrid::smpi::DatatypeSegment>& plan, char* buf, MPI_Aint extent)
+      : plan_(plan), element_(buf), extent_(extent)
+  {
+  }
+  char* position() const
+  {
+    const simgrid::smpi::DatatypeSegment& segment = plan_[segment_];
+    return element_ + segment.offset + block_ * segment.stride + done_;
+  }
+  /** Number of contiguous bytes at the current position */
+  size_t available() const { return plan_[segment_].length - done_; }
+  void advance(size_t bytes)
+  {
+    done_ += bytes;
+    if (done_ < plan_[segment_].length)
+      return;
+    done_ = 0;
+    if (++block_ < plan_[segment_].count)
+      return;
+    block_ = 0;
+    if (++segment_ < plan_.size())
+      return;
+    segment_ = 0;
+    element_ += extent_;
+  }
+};
+} // namespace
+
 #define CREATE_MPI_DATATYPE(name, id, type)                                                                            \
   static simgrid::smpi::Datatype _XBT_CONCAT(mpi_, name)((char*)_XBT_STRINGIFY(name), (id), sizeof(type), /* size */   \
                                                          0,                                               /* lb */     \
@@ -204,6 +245,47 @@ void Datatype::unref(MPI_Datatype datatype)
 void Datatype::commit()
 {
   flags_ |= DT_FLAG_COMMITED;
+  if (flags_ & DT_FLAG_DERIVED)
+    get_plan();
+}
+
+/** Returns the copy plan of this datatype, and compiles it on first use (for the datatypes that were not committed) */
+const std::vector<DatatypeSegment>& Datatype::get_plan()
+{
+  std::call_once(plan_compiled_, [this]() {
+    flatten(plan_, 0, 1);
+    plan_.shrink_to_fit();
+    XBT_DEBUG("Datatype %p (size %zu) compiled into %zu segments", this, size_, plan_.size());
+  });
+  return plan_;
+}
+
+/** Appends a block to the plan, merging it with the previous segment if it extends it or repeats it with the same
+ * stride */
+void Datatype::add_segment(std::vector<DatatypeSegment>& plan, MPI_Aint offset, size_t length, MPI_Datatype type)
+{
+  if (length == 0)
+    return;
+  if (not plan.empty() && plan.back().type == type) {
+    DatatypeSegment& last = plan.back();
+    if (last.count == 1 && last.offset + static_cast<MPI_Aint>(last.length) == offset) {
+      last.length += length;
+      return;
+    }
+    if (last.length == length && (last.count == 1 || last.offset + last.count * last.stride == offset)) {
+      if (last.count == 1)
+        last.stride = offset - last.offset;
+      last.count++;
+      return;
+    }
+  }
+  plan.push_back({offset, length, 1, 0, type});
+}
+
+//Non-derived datatypes are a contiguous block of bytes.
+void Datatype::flatten(std::vector<DatatypeSegment>& plan, MPI_Aint displacement, int count)
+{
+  add_segment(plan, displacement + lb_, count * size_, this);
 }
 
 bool Datatype::is_valid(){
@@ -291,34 +373,79 @@ int Datatype::copy(const void *sendbuf, int sendcount, MPI_Datatype sendtype,
       recvtype->unserialize(sendbuf, recvbuf, count / recvtype->size(), MPI_REPLACE);
     } else if (not(recvtype->flags() & DT_FLAG_DERIVED)) {
       sendtype->serialize(sendbuf, recvbuf, count / sendtype->size());
-    }else{
-
-      void * buf_tmp = xbt_malloc(count);
-
-      sendtype->serialize( sendbuf, buf_tmp,count/sendtype->size());
-      recvtype->unserialize( buf_tmp, recvbuf,count/recvtype->size(), MPI_REPLACE);
-
-      xbt_free(buf_tmp);
+    } else if (not smpi_process()->replaying()) {
+      // walk both plans at once, without serializing the data in between
+      PlanCursor send_cursor(sendtype->get_plan(), static_cast<char*>(const_cast<void*>(sendbuf)),
+                             sendtype->get_extent());
+      PlanCursor recv_cursor(recvtype->get_plan(), static_cast<char*>(recvbuf), recvtype->get_extent());
+      size_t remaining = count;
+      while (remaining > 0) {
+        size_t bytes = std::min(remaining, std::min(send_cursor.available(), recv_cursor.available()));
+        memcpy(recv_cursor.position(), send_cursor.position(), bytes);
+        send_cursor.advance(bytes);
+        recv_cursor.advance(bytes);
+        remaining -= bytes;
+      }
     }
   }
 
   return sendcount > recvcount ? MPI_ERR_TRUNCATE : MPI_SUCCESS;
 }
 
-//Default serialization method : memcpy.
+/** Copies the data of count elements into a contiguous buffer, following the copy plan */
 void Datatype::serialize(const void* noncontiguous_buf, void* contiguous_buf, int count)
 {
+  const std::vector<DatatypeSegment>& plan = get_plan();
   char* contiguous_buf_char = static_cast<char*>(contiguous_buf);
-  const char* noncontiguous_buf_char = static_cast<const char*>(noncontiguous_buf)+lb_;
-  memcpy(contiguous_buf_char, noncontiguous_buf_char, count*size_);
+  const char* noncontiguous_buf_char = static_cast<const char*>(noncontiguous_buf);
+  if (plan.size() == 1 && plan[0].count == 1 && static_cast<MPI_Aint>(plan[0].length) == get_extent()) {
+    memcpy(contiguous_buf_char, noncontiguous_buf_char + plan[0].offset, count * plan[0].length);
+    return;
+  }
+  for (int i = 0; i < count; i++) {
+    for (auto const& segment : plan) {
+      const char* block = noncontiguous_buf_char + segment.offset;
+      for (int j = 0; j < segment.count; j++) {
+        memcpy(contiguous_buf_char, block, segment.length);
+        contiguous_buf_char += segment.length;
+        block += segment.stride;
+      }
+    }
+    noncontiguous_buf_char += get_extent();
+  }
 }
 
+/** Applies the operation to the data of count elements from a contiguous buffer, following the copy plan */
 void Datatype::unserialize(const void* contiguous_buf, void *noncontiguous_buf, int count, MPI_Op op){
+  if (op == MPI_OP_NULL)
+    return;
+  const std::vector<DatatypeSegment>& plan = get_plan();
   const char* contiguous_buf_char = static_cast<const char*>(contiguous_buf);
-  char* noncontiguous_buf_char = static_cast<char*>(noncontiguous_buf)+lb_;
-  int n=count;
-  if(op!=MPI_OP_NULL)
-    op->apply( contiguous_buf_char, noncontiguous_buf_char, &n, this);
+  char* noncontiguous_buf_char = static_cast<char*>(noncontiguous_buf);
+  if (plan.size() == 1 && plan[0].count == 1 && static_cast<MPI_Aint>(plan[0].length) == get_extent()) {
+    int n = count * plan[0].length / plan[0].type->size();
+    op->apply(contiguous_buf_char, noncontiguous_buf_char + plan[0].offset, &n, plan[0].type);
+    return;
+  }
+  // Replacing the data is a plain copy: do it without looking for the kernel of the operation for each block
+  bool replace = (op == MPI_REPLACE);
+  if (replace && smpi_process()->replaying())
+    return;
+  for (int i = 0; i < count; i++) {
+    for (auto const& segment : plan) {
+      char* block = noncontiguous_buf_char + segment.offset;
+      int n       = segment.length / segment.type->size();
+      for (int j = 0; j < segment.count; j++) {
+        if (replace)
+          memcpy(block, contiguous_buf_char, segment.length);
+        else
+          op->apply(contiguous_buf_char, block, &n, segment.type);
+        contiguous_buf_char += segment.length;
+        block += segment.stride;
+      }
+    }
+    noncontiguous_buf_char += get_extent();
+  }
 }
 
 int Datatype::create_contiguous(int count, MPI_Datatype old_type, MPI_Aint lb, MPI_Datatype* new_type){
@@ -5,11 +5,8 @@
  * under the terms of the license (GNU LGPL) which comes with this package. */
 
 #include "smpi_datatype_derived.hpp"
-#include "smpi_op.hpp"
 #include <xbt/log.h>
 
-#include <cstring>
-
 namespace simgrid{
 namespace smpi{
 
@@ -24,20 +21,9 @@ Type_Contiguous::~Type_Contiguous()
   Datatype::unref(old_type_);
 }
 
-void Type_Contiguous::serialize(const void* noncontiguous_buf, void* contiguous_buf, int count)
-{
-  char* contiguous_buf_char = static_cast<char*>(contiguous_buf);
-  const char* noncontiguous_buf_char = static_cast<const char*>(noncontiguous_buf)+lb();
-  memcpy(contiguous_buf_char, noncontiguous_buf_char, count * block_count_ * old_type_->size());
-}
-
-void Type_Contiguous::unserialize(const void* contiguous_buf, void* noncontiguous_buf, int count, MPI_Op op)
+void Type_Contiguous::flatten(std::vector<DatatypeSegment>& plan, MPI_Aint displacement, int count)
 {
-  const char* contiguous_buf_char = static_cast<const char*>(contiguous_buf);
-  char* noncontiguous_buf_char = static_cast<char*>(noncontiguous_buf)+lb();
-  int n= count*block_count_;
-  if(op!=MPI_OP_NULL)
-    op->apply( contiguous_buf_char, noncontiguous_buf_char, &n, old_type_);
+  old_type_->flatten(plan, displacement + lb(), count * block_count_);
 }
 
 Type_Hvector::Type_Hvector(int size,MPI_Aint lb, MPI_Aint ub, int flags, int count, int block_length, MPI_Aint stride, MPI_Datatype old_type): Datatype(size, lb, ub, flags), block_count_(count), block_length_(block_length), block_stride_(stride), old_type_(old_type){
@@ -47,42 +33,11 @@ Type_Hvector::~Type_Hvector(){
   Datatype::unref(old_type_);
 }
 
-void Type_Hvector::serialize(const void* noncontiguous_buf, void *contiguous_buf,
-                    int count){
-  char* contiguous_buf_char = static_cast<char*>(contiguous_buf);
-  const char* noncontiguous_buf_char = static_cast<const char*>(noncontiguous_buf);
-
-  for (int i = 0; i < block_count_ * count; i++) {
-    if (not(old_type_->flags() & DT_FLAG_DERIVED))
-      memcpy(contiguous_buf_char, noncontiguous_buf_char, block_length_ * old_type_->size());
-    else
-      old_type_->serialize( noncontiguous_buf_char, contiguous_buf_char, block_length_);
-
-    contiguous_buf_char += block_length_*old_type_->size();
-    if((i+1)%block_count_ ==0)
-      noncontiguous_buf_char += block_length_*old_type_->size();
-    else
-      noncontiguous_buf_char += block_stride_;
-  }
-}
-
-void Type_Hvector::unserialize(const void* contiguous_buf, void *noncontiguous_buf,
-                              int count, MPI_Op op){
-  const char* contiguous_buf_char = static_cast<const char*>(contiguous_buf);
-  char* noncontiguous_buf_char = static_cast<char*>(noncontiguous_buf);
-
-  for (int i = 0; i < block_count_ * count; i++) {
-    if (not(old_type_->flags() & DT_FLAG_DERIVED)) {
-      if(op!=MPI_OP_NULL)
-        op->apply( contiguous_buf_char, noncontiguous_buf_char, &block_length_, old_type_);
-    }else
-      old_type_->unserialize( contiguous_buf_char, noncontiguous_buf_char, block_length_, op);
-    contiguous_buf_char += block_length_*old_type_->size();
-    if((i+1)%block_count_ ==0)
-      noncontiguous_buf_char += block_length_*old_type_->size();
-    else
-      noncontiguous_buf_char += block_stride_;
-  }
+void Type_Hvector::flatten(std::vector<DatatypeSegment>& plan, MPI_Aint displacement, int count)
+{
+  for (int i = 0; i < count; i++)
+    for (int j = 0; j < block_count_; j++)
+      old_type_->flatten(plan, displacement + i * get_extent() + j * block_stride_, block_length_);
 }
 
 Type_Vector::Type_Vector(int size, MPI_Aint lb, MPI_Aint ub, int flags, int count, int block_length, int stride,
@@ -126,49 +81,11 @@ Type_Hindexed::~Type_Hindexed()
   }
 }
 
-void Type_Hindexed::serialize(const void* noncontiguous_buf, void *contiguous_buf,
-                int count){
-  char* contiguous_buf_char = static_cast<char*>(contiguous_buf);
-  const char* noncontiguous_buf_iter = static_cast<const char*>(noncontiguous_buf);
-  const char* noncontiguous_buf_char = noncontiguous_buf_iter + block_indices_[0];
-  for (int j = 0; j < count; j++) {
-    for (int i = 0; i < block_count_; i++) {
-      if (not(old_type_->flags() & DT_FLAG_DERIVED))
-        memcpy(contiguous_buf_char, noncontiguous_buf_char, block_lengths_[i] * old_type_->size());
-      else
-        old_type_->serialize(noncontiguous_buf_char, contiguous_buf_char,block_lengths_[i]);
-
-      contiguous_buf_char += block_lengths_[i]*old_type_->size();
-      if (i<block_count_-1)
-        noncontiguous_buf_char = noncontiguous_buf_iter + block_indices_[i+1];
-      else
-        noncontiguous_buf_char += block_lengths_[i]*old_type_->get_extent();
-    }
-    noncontiguous_buf_iter=noncontiguous_buf_char;
-  }
-}
-
-void Type_Hindexed::unserialize(const void* contiguous_buf, void *noncontiguous_buf,
-                          int count, MPI_Op op){
-  const char* contiguous_buf_char = static_cast<const char*>(contiguous_buf);
-  char* noncontiguous_buf_char = static_cast<char*>(noncontiguous_buf)+ block_indices_[0];
-  for (int j = 0; j < count; j++) {
-    for (int i = 0; i < block_count_; i++) {
-      if (not(old_type_->flags() & DT_FLAG_DERIVED)) {
-        if(op!=MPI_OP_NULL)
-          op->apply( contiguous_buf_char, noncontiguous_buf_char, &block_lengths_[i],
-                            old_type_);
-      }else
-        old_type_->unserialize( contiguous_buf_char,noncontiguous_buf_char,block_lengths_[i], op);
-
-      contiguous_buf_char += block_lengths_[i]*old_type_->size();
-      if (i<block_count_-1)
-        noncontiguous_buf_char = static_cast<char*>(noncontiguous_buf) + block_indices_[i+1];
-      else
-        noncontiguous_buf_char += block_lengths_[i]*old_type_->get_extent();
-    }
-    noncontiguous_buf=static_cast<void*>(noncontiguous_buf_char);
-  }
+void Type_Hindexed::flatten(std::vector<DatatypeSegment>& plan, MPI_Aint displacement, int count)
+{
+  for (int i = 0; i < count; i++)
+    for (int j = 0; j < block_count_; j++)
+      old_type_->flatten(plan, displacement + i * get_extent() + block_indices_[j], block_lengths_[j]);
 }
 
 Type_Indexed::Type_Indexed(int size, MPI_Aint lb, MPI_Aint ub, int flags, int count, const int* block_lengths,
@@ -201,49 +118,11 @@ Type_Struct::~Type_Struct(){
 }
 
 
-void Type_Struct::serialize(const void* noncontiguous_buf, void *contiguous_buf,
-                        int count){
-  char* contiguous_buf_char = static_cast<char*>(contiguous_buf);
-  const char* noncontiguous_buf_iter = static_cast<const char*>(noncontiguous_buf);
-  const char* noncontiguous_buf_char = noncontiguous_buf_iter + block_indices_[0];
-  for (int j = 0; j < count; j++) {
-    for (int i = 0; i < block_count_; i++) {
-      if (not(old_types_[i]->flags() & DT_FLAG_DERIVED))
-        memcpy(contiguous_buf_char, noncontiguous_buf_char, block_lengths_[i] * old_types_[i]->size());
-      else
-        old_types_[i]->serialize( noncontiguous_buf_char,contiguous_buf_char,block_lengths_[i]);
-
-
-      contiguous_buf_char += block_lengths_[i]*old_types_[i]->size();
-      if (i<block_count_-1)
-        noncontiguous_buf_char = noncontiguous_buf_iter + block_indices_[i+1];
-      else //let's hope this is MPI_UB ?
-        noncontiguous_buf_char += block_lengths_[i]*old_types_[i]->get_extent();
-    }
-    noncontiguous_buf_iter=noncontiguous_buf_char;
-  }
-}
-
-void Type_Struct::unserialize(const void* contiguous_buf, void *noncontiguous_buf,
-                              int count, MPI_Op op){
-  const char* contiguous_buf_char = static_cast<const char*>(contiguous_buf);
-  char* noncontiguous_buf_char = static_cast<char*>(noncontiguous_buf)+ block_indices_[0];
-  for (int j = 0; j < count; j++) {
-    for (int i = 0; i < block_count_; i++) {
-      if (not(old_types_[i]->flags() & DT_FLAG_DERIVED)) {
-        if(op!=MPI_OP_NULL)
-          op->apply( contiguous_buf_char, noncontiguous_buf_char, &block_lengths_[i], old_types_[i]);
-      }else
-        old_types_[i]->unserialize( contiguous_buf_char, noncontiguous_buf_char,block_lengths_[i], op);
-
-      contiguous_buf_char += block_lengths_[i]*old_types_[i]->size();
-      if (i<block_count_-1)
-        noncontiguous_buf_char =  static_cast<char*>(noncontiguous_buf) + block_indices_[i+1];
-      else
-        noncontiguous_buf_char += block_lengths_[i]*old_types_[i]->get_extent();
-    }
-    noncontiguous_buf=static_cast<void*>(noncontiguous_buf_char);
-  }
+void Type_Struct::flatten(std::vector<DatatypeSegment>& plan, MPI_Aint displacement, int count)
+{
+  for (int i = 0; i < count; i++)
+    for (int j = 0; j < block_count_; j++)
+      old_types_[j]->flatten(plan, displacement + i * get_extent() + block_indices_[j], block_lengths_[j]);
 }
 
 }
@@ -35,205 +35,226 @@ XBT_LOG_NEW_DEFAULT_SUBCATEGORY(smpi_op, smpi, "Logging specific to SMPI (op)");
 #define MINLOC_OP(a, b)                                                                                                \
   (b) = ((a).value) < ((b).value) ? (a) : (((a).value) == ((b).value) ? (((a).index) < ((b).index) ? (a) : (b)) : (b))
 
-#define APPLY_FUNC(a, b, length, type, func) \
-{                                          \
-  int i;                                   \
-  type* x = (type*)(a);                    \
-  type* y = (type*)(b);                    \
-  for(i = 0; i < *(length); i++) {         \
-    func(x[i], y[i]);                      \
-  }                                        \
+/* Each operation is a functor, so that its kernel for a given type is a single loop that the compiler can vectorize */
+#define DEFINE_OP_FUNCTOR(name, op)                                                                                    \
+  struct name {                                                                                                        \
+    template <class T> static void apply(const T& a, T& b) { op(a, b); }                                               \
+  };
+
+DEFINE_OP_FUNCTOR(MaxOp, MAX_OP)
+DEFINE_OP_FUNCTOR(MinOp, MIN_OP)
+DEFINE_OP_FUNCTOR(SumOp, SUM_OP)
+DEFINE_OP_FUNCTOR(SumPairOp, SUM_OP_COMPLEX)
+DEFINE_OP_FUNCTOR(ProdOp, PROD_OP)
+DEFINE_OP_FUNCTOR(ProdPairOp, PROD_OP_COMPLEX)
+DEFINE_OP_FUNCTOR(LandOp, LAND_OP)
+DEFINE_OP_FUNCTOR(LorOp, LOR_OP)
+DEFINE_OP_FUNCTOR(LxorOp, LXOR_OP)
+DEFINE_OP_FUNCTOR(BandOp, BAND_OP)
+DEFINE_OP_FUNCTOR(BorOp, BOR_OP)
+DEFINE_OP_FUNCTOR(BxorOp, BXOR_OP)
+DEFINE_OP_FUNCTOR(MaxlocOp, MAXLOC_OP)
+DEFINE_OP_FUNCTOR(MinlocOp, MINLOC_OP)
+
+template <class T, class Op> static void apply_kernel(const void* a, void* b, int length, MPI_Datatype)
+{
+  const T* x = static_cast<const T*>(a);
+  T* y       = static_cast<T*>(b);
+  for (int i = 0; i < length; i++)
+    Op::apply(x[i], y[i]);
 }
 
-#define APPLY_OP_LOOP(dtype, type, op)                                                                                 \
-  if (*datatype == (dtype)) {                                                                                          \
-    APPLY_FUNC(a, b, length, type, op)                                                                                 \
+#define SELECT_KERNEL(dtype, type, op)                                                                                 \
+  if (datatype == (dtype)) {                                                                                           \
+    return &apply_kernel<type, op>;                                                                                    \
   } else
 
-#define APPLY_BASIC_OP_LOOP(op)\
-APPLY_OP_LOOP(MPI_CHAR, char,op)\
-APPLY_OP_LOOP(MPI_SHORT, short,op)\
-APPLY_OP_LOOP(MPI_INT, int,op)\
-APPLY_OP_LOOP(MPI_LONG, long,op)\
-APPLY_OP_LOOP(MPI_LONG_LONG, long long,op)\
-APPLY_OP_LOOP(MPI_SIGNED_CHAR, signed char,op)\
-APPLY_OP_LOOP(MPI_UNSIGNED_CHAR, unsigned char,op)\
-APPLY_OP_LOOP(MPI_UNSIGNED_SHORT, unsigned short,op)\
-APPLY_OP_LOOP(MPI_UNSIGNED, unsigned int,op)\
-APPLY_OP_LOOP(MPI_UNSIGNED_LONG, unsigned long,op)\
-APPLY_OP_LOOP(MPI_UNSIGNED_LONG_LONG, unsigned long long,op)\
-APPLY_OP_LOOP(MPI_WCHAR, wchar_t,op)\
-APPLY_OP_LOOP(MPI_BYTE, int8_t,op)\
-APPLY_OP_LOOP(MPI_INT8_T, int8_t,op)\
-APPLY_OP_LOOP(MPI_INT16_T, int16_t,op)\
-APPLY_OP_LOOP(MPI_INT32_T, int32_t,op)\
-APPLY_OP_LOOP(MPI_INT64_T, int64_t,op)\
-APPLY_OP_LOOP(MPI_UINT8_T, uint8_t,op)\
-APPLY_OP_LOOP(MPI_UINT16_T, uint16_t,op)\
-APPLY_OP_LOOP(MPI_UINT32_T, uint32_t,op)\
-APPLY_OP_LOOP(MPI_UINT64_T, uint64_t,op)\
-APPLY_OP_LOOP(MPI_AINT, MPI_Aint,op)\
-APPLY_OP_LOOP(MPI_OFFSET, MPI_Offset,op)\
-APPLY_OP_LOOP(MPI_INTEGER1, int,op)\
-APPLY_OP_LOOP(MPI_INTEGER2, int16_t,op)\
-APPLY_OP_LOOP(MPI_INTEGER4, int32_t,op)\
-APPLY_OP_LOOP(MPI_INTEGER8, int64_t,op)\
-APPLY_OP_LOOP(MPI_COUNT, long long,op)
-
-
-#define APPLY_BOOL_OP_LOOP(op)\
-APPLY_OP_LOOP(MPI_C_BOOL, bool,op)
-
-#define APPLY_FLOAT_OP_LOOP(op)\
-APPLY_OP_LOOP(MPI_FLOAT, float,op)\
-APPLY_OP_LOOP(MPI_DOUBLE, double,op)\
-APPLY_OP_LOOP(MPI_LONG_DOUBLE, long double,op)\
-APPLY_OP_LOOP(MPI_REAL, float,op)\
-APPLY_OP_LOOP(MPI_REAL4, float,op)\
-APPLY_OP_LOOP(MPI_REAL8, double,op)\
-APPLY_OP_LOOP(MPI_REAL16, long double,op)
-
-#define APPLY_COMPLEX_OP_LOOP(op)\
-APPLY_OP_LOOP(MPI_C_FLOAT_COMPLEX, float _Complex,op)\
-APPLY_OP_LOOP(MPI_C_DOUBLE_COMPLEX, double _Complex,op)\
-APPLY_OP_LOOP(MPI_C_LONG_DOUBLE_COMPLEX, long double _Complex,op)
-
-#define APPLY_PAIR_OP_LOOP(op)\
-APPLY_OP_LOOP(MPI_FLOAT_INT, float_int,op)\
-APPLY_OP_LOOP(MPI_LONG_INT, long_int,op)\
-APPLY_OP_LOOP(MPI_DOUBLE_INT, double_int,op)\
-APPLY_OP_LOOP(MPI_SHORT_INT, short_int,op)\
-APPLY_OP_LOOP(MPI_2INT, int_int,op)\
-APPLY_OP_LOOP(MPI_2FLOAT, float_float,op)\
-APPLY_OP_LOOP(MPI_2DOUBLE, double_double,op)\
-APPLY_OP_LOOP(MPI_LONG_DOUBLE_INT, long_double_int,op)\
-APPLY_OP_LOOP(MPI_2LONG, long_long,op)\
-APPLY_OP_LOOP(MPI_COMPLEX8, float_float,op)\
-APPLY_OP_LOOP(MPI_COMPLEX16, double_double,op)\
-APPLY_OP_LOOP(MPI_COMPLEX32, double_double,op)
-
-#define APPLY_END_OP_LOOP(op)                                                                                          \
+#define SELECT_BASIC_KERNEL(op)\
+SELECT_KERNEL(MPI_CHAR, char,op)\
+SELECT_KERNEL(MPI_SHORT, short,op)\
+SELECT_KERNEL(MPI_INT, int,op)\
+SELECT_KERNEL(MPI_LONG, long,op)\
+SELECT_KERNEL(MPI_LONG_LONG, long long,op)\
+SELECT_KERNEL(MPI_SIGNED_CHAR, signed char,op)\
+SELECT_KERNEL(MPI_UNSIGNED_CHAR, unsigned char,op)\
+SELECT_KERNEL(MPI_UNSIGNED_SHORT, unsigned short,op)\
+SELECT_KERNEL(MPI_UNSIGNED, unsigned int,op)\
+SELECT_KERNEL(MPI_UNSIGNED_LONG, unsigned long,op)\
+SELECT_KERNEL(MPI_UNSIGNED_LONG_LONG, unsigned long long,op)\
+SELECT_KERNEL(MPI_WCHAR, wchar_t,op)\
+SELECT_KERNEL(MPI_BYTE, int8_t,op)\
+SELECT_KERNEL(MPI_INT8_T, int8_t,op)\
+SELECT_KERNEL(MPI_INT16_T, int16_t,op)\
+SELECT_KERNEL(MPI_INT32_T, int32_t,op)\
+SELECT_KERNEL(MPI_INT64_T, int64_t,op)\
+SELECT_KERNEL(MPI_UINT8_T, uint8_t,op)\
+SELECT_KERNEL(MPI_UINT16_T, uint16_t,op)\
+SELECT_KERNEL(MPI_UINT32_T, uint32_t,op)\
+SELECT_KERNEL(MPI_UINT64_T, uint64_t,op)\
+SELECT_KERNEL(MPI_AINT, MPI_Aint,op)\
+SELECT_KERNEL(MPI_OFFSET, MPI_Offset,op)\
+SELECT_KERNEL(MPI_INTEGER1, int,op)\
+SELECT_KERNEL(MPI_INTEGER2, int16_t,op)\
+SELECT_KERNEL(MPI_INTEGER4, int32_t,op)\
+SELECT_KERNEL(MPI_INTEGER8, int64_t,op)\
+SELECT_KERNEL(MPI_COUNT, long long,op)
+
+
+#define SELECT_BOOL_KERNEL(op)\
+SELECT_KERNEL(MPI_C_BOOL, bool,op)
+
+#define SELECT_FLOAT_KERNEL(op)\
+SELECT_KERNEL(MPI_FLOAT, float,op)\
+SELECT_KERNEL(MPI_DOUBLE, double,op)\
+SELECT_KERNEL(MPI_LONG_DOUBLE, long double,op)\
+SELECT_KERNEL(MPI_REAL, float,op)\
+SELECT_KERNEL(MPI_REAL4, float,op)\
+SELECT_KERNEL(MPI_REAL8, double,op)\
+SELECT_KERNEL(MPI_REAL16, long double,op)
+
+#define SELECT_COMPLEX_KERNEL(op)\
+SELECT_KERNEL(MPI_C_FLOAT_COMPLEX, float _Complex,op)\
+SELECT_KERNEL(MPI_C_DOUBLE_COMPLEX, double _Complex,op)\
+SELECT_KERNEL(MPI_C_LONG_DOUBLE_COMPLEX, long double _Complex,op)
+
+#define SELECT_PAIR_KERNEL(op)\
+SELECT_KERNEL(MPI_FLOAT_INT, float_int,op)\
+SELECT_KERNEL(MPI_LONG_INT, long_int,op)\
+SELECT_KERNEL(MPI_DOUBLE_INT, double_int,op)\
+SELECT_KERNEL(MPI_SHORT_INT, short_int,op)\
+SELECT_KERNEL(MPI_2INT, int_int,op)\
+SELECT_KERNEL(MPI_2FLOAT, float_float,op)\
+SELECT_KERNEL(MPI_2DOUBLE, double_double,op)\
+SELECT_KERNEL(MPI_LONG_DOUBLE_INT, long_double_int,op)\
+SELECT_KERNEL(MPI_2LONG, long_long,op)\
+SELECT_KERNEL(MPI_COMPLEX8, float_float,op)\
+SELECT_KERNEL(MPI_COMPLEX16, double_double,op)\
+SELECT_KERNEL(MPI_COMPLEX32, double_double,op)
+
+#define SELECT_END_KERNEL(op)                                                                                          \
   {                                                                                                                    \
-    xbt_die("Failed to apply " _XBT_STRINGIFY(op) " to type %s", (*datatype)->name());                                 \
+    xbt_die("Failed to apply " _XBT_STRINGIFY(op) " to type %s", datatype->name());                                    \
   }
 
-static void max_func(void *a, void *b, int *length, MPI_Datatype * datatype)
+using simgrid::smpi::Op;
+
+static Op::kernel_type max_kernel(MPI_Datatype datatype)
 {
-  APPLY_BASIC_OP_LOOP(MAX_OP)
-  APPLY_FLOAT_OP_LOOP(MAX_OP)
-  APPLY_END_OP_LOOP(MAX_OP)
+  SELECT_BASIC_KERNEL(MaxOp)
+  SELECT_FLOAT_KERNEL(MaxOp)
+  SELECT_END_KERNEL(MAX_OP)
 }
 
-static void min_func(void *a, void *b, int *length, MPI_Datatype * datatype)
+static Op::kernel_type min_kernel(MPI_Datatype datatype)
 {
-  APPLY_BASIC_OP_LOOP(MIN_OP)
-  APPLY_FLOAT_OP_LOOP(MIN_OP)
-  APPLY_END_OP_LOOP(MIN_OP)
+  SELECT_BASIC_KERNEL(MinOp)
+  SELECT_FLOAT_KERNEL(MinOp)
+  SELECT_END_KERNEL(MIN_OP)
 }
 
-static void sum_func(void *a, void *b, int *length, MPI_Datatype * datatype)
+static Op::kernel_type sum_kernel(MPI_Datatype datatype)
 {
-  APPLY_BASIC_OP_LOOP(SUM_OP)
-  APPLY_FLOAT_OP_LOOP(SUM_OP)
-  APPLY_COMPLEX_OP_LOOP(SUM_OP)
-  APPLY_PAIR_OP_LOOP(SUM_OP_COMPLEX)
-  APPLY_END_OP_LOOP(SUM_OP)
+  SELECT_BASIC_KERNEL(SumOp)
+  SELECT_FLOAT_KERNEL(SumOp)
+  SELECT_COMPLEX_KERNEL(SumOp)
+  SELECT_PAIR_KERNEL(SumPairOp)
+  SELECT_END_KERNEL(SUM_OP)
 }
 
-static void prod_func(void *a, void *b, int *length, MPI_Datatype * datatype)
+static Op::kernel_type prod_kernel(MPI_Datatype datatype)
 {
-  APPLY_BASIC_OP_LOOP(PROD_OP)
-  APPLY_FLOAT_OP_LOOP(PROD_OP)
-  APPLY_COMPLEX_OP_LOOP(PROD_OP)
-  APPLY_PAIR_OP_LOOP(PROD_OP_COMPLEX)
-  APPLY_END_OP_LOOP(PROD_OP)
+  SELECT_BASIC_KERNEL(ProdOp)
+  SELECT_FLOAT_KERNEL(ProdOp)
+  SELECT_COMPLEX_KERNEL(ProdOp)
+  SELECT_PAIR_KERNEL(ProdPairOp)
+  SELECT_END_KERNEL(PROD_OP)
 }
 
-static void land_func(void *a, void *b, int *length, MPI_Datatype * datatype)
+static Op::kernel_type land_kernel(MPI_Datatype datatype)
 {
-  APPLY_BASIC_OP_LOOP(LAND_OP)
-  APPLY_FLOAT_OP_LOOP(LAND_OP)
-  APPLY_BOOL_OP_LOOP(LAND_OP)
-  APPLY_END_OP_LOOP(LAND_OP)
+  SELECT_BASIC_KERNEL(LandOp)
+  SELECT_FLOAT_KERNEL(LandOp)
+  SELECT_BOOL_KERNEL(LandOp)
+  SELECT_END_KERNEL(LAND_OP)
 }
 
-static void lor_func(void *a, void *b, int *length, MPI_Datatype * datatype)
+static Op::kernel_type lor_kernel(MPI_Datatype datatype)
 {
-  APPLY_BASIC_OP_LOOP(LOR_OP)
-  APPLY_FLOAT_OP_LOOP(LOR_OP)
-  APPLY_BOOL_OP_LOOP(LOR_OP)
-  APPLY_END_OP_LOOP(LOR_OP)
+  SELECT_BASIC_KERNEL(LorOp)
+  SELECT_FLOAT_KERNEL(LorOp)
+  SELECT_BOOL_KERNEL(LorOp)
+  SELECT_END_KERNEL(LOR_OP)
 }
 
-static void lxor_func(void *a, void *b, int *length, MPI_Datatype * datatype)
+static Op::kernel_type lxor_kernel(MPI_Datatype datatype)
 {
-  APPLY_BASIC_OP_LOOP(LXOR_OP)
-  APPLY_FLOAT_OP_LOOP(LXOR_OP)
-  APPLY_BOOL_OP_LOOP(LXOR_OP)
-  APPLY_END_OP_LOOP(LXOR_OP)
+  SELECT_BASIC_KERNEL(LxorOp)
+  SELECT_FLOAT_KERNEL(LxorOp)
+  SELECT_BOOL_KERNEL(LxorOp)
+  SELECT_END_KERNEL(LXOR_OP)
 }
 
-static void band_func(void *a, void *b, int *length, MPI_Datatype * datatype)
+static Op::kernel_type band_kernel(MPI_Datatype datatype)
 {
-  APPLY_BASIC_OP_LOOP(BAND_OP)
-  APPLY_BOOL_OP_LOOP(BAND_OP)
-  APPLY_END_OP_LOOP(BAND_OP)
+  SELECT_BASIC_KERNEL(BandOp)
+  SELECT_BOOL_KERNEL(BandOp)
+  SELECT_END_KERNEL(BAND_OP)
 }
 
-static void bor_func(void *a, void *b, int *length, MPI_Datatype * datatype)
+static Op::kernel_type bor_kernel(MPI_Datatype datatype)
 {
-  APPLY_BASIC_OP_LOOP(BOR_OP)
-  APPLY_BOOL_OP_LOOP(BOR_OP)
-  APPLY_END_OP_LOOP(BOR_OP)
+  SELECT_BASIC_KERNEL(BorOp)
+  SELECT_BOOL_KERNEL(BorOp)
+  SELECT_END_KERNEL(BOR_OP)
 }
 
-static void bxor_func(void *a, void *b, int *length, MPI_Datatype * datatype)
+static Op::kernel_type bxor_kernel(MPI_Datatype datatype)
 {
-  APPLY_BASIC_OP_LOOP(BXOR_OP)
-  APPLY_BOOL_OP_LOOP(BXOR_OP)
-  APPLY_END_OP_LOOP(BXOR_OP)
+  SELECT_BASIC_KERNEL(BxorOp)
+  SELECT_BOOL_KERNEL(BxorOp)
+  SELECT_END_KERNEL(BXOR_OP)
 }
 
-static void minloc_func(void *a, void *b, int *length, MPI_Datatype * datatype)
+static Op::kernel_type minloc_kernel(MPI_Datatype datatype)
 {
-  APPLY_PAIR_OP_LOOP(MINLOC_OP)
-  APPLY_END_OP_LOOP(MINLOC_OP)
+  SELECT_PAIR_KERNEL(MinlocOp)
+  SELECT_END_KERNEL(MINLOC_OP)
 }
 
-static void maxloc_func(void *a, void *b, int *length, MPI_Datatype * datatype)
+static Op::kernel_type maxloc_kernel(MPI_Datatype datatype)
 {
-  APPLY_PAIR_OP_LOOP(MAXLOC_OP)
-  APPLY_END_OP_LOOP(MAXLOC_OP)
+  SELECT_PAIR_KERNEL(MaxlocOp)
+  SELECT_END_KERNEL(MAXLOC_OP)
 }
 
-static void replace_func(void *a, void *b, int *length, MPI_Datatype * datatype)
+static Op::kernel_type replace_kernel(MPI_Datatype)
 {
-  memcpy(b, a, *length * (*datatype)->size());
+  return [](const void* a, void* b, int length, MPI_Datatype datatype) { memcpy(b, a, length * datatype->size()); };
 }
 
-static void no_func(void*, void*, int*, MPI_Datatype*)
+static Op::kernel_type no_kernel(MPI_Datatype)
 {
-  /* obviously a no-op */
+  return [](const void*, void*, int, MPI_Datatype) { /* obviously a no-op */ };
 }
 
-#define CREATE_MPI_OP(name, func)                                                                                      \
-  static SMPI_Op _XBT_CONCAT(mpi_, name)(&(func) /* func */, true, true);                                              \
+#define CREATE_MPI_OP(name, selector)                                                                                  \
+  static SMPI_Op _XBT_CONCAT(mpi_, name)(&(selector) /* selector */, true);                                            \
   MPI_Op name = &_XBT_CONCAT(mpi_, name);
 
-CREATE_MPI_OP(MPI_MAX, max_func);
-CREATE_MPI_OP(MPI_MIN, min_func);
-CREATE_MPI_OP(MPI_SUM, sum_func);
-CREATE_MPI_OP(MPI_PROD, prod_func);
-CREATE_MPI_OP(MPI_LAND, land_func);
-CREATE_MPI_OP(MPI_LOR, lor_func);
-CREATE_MPI_OP(MPI_LXOR, lxor_func);
-CREATE_MPI_OP(MPI_BAND, band_func);
-CREATE_MPI_OP(MPI_BOR, bor_func);
-CREATE_MPI_OP(MPI_BXOR, bxor_func);
-CREATE_MPI_OP(MPI_MAXLOC, maxloc_func);
-CREATE_MPI_OP(MPI_MINLOC, minloc_func);
-CREATE_MPI_OP(MPI_REPLACE, replace_func);
-CREATE_MPI_OP(MPI_NO_OP, no_func);
+CREATE_MPI_OP(MPI_MAX, max_kernel);
+CREATE_MPI_OP(MPI_MIN, min_kernel);
+CREATE_MPI_OP(MPI_SUM, sum_kernel);
+CREATE_MPI_OP(MPI_PROD, prod_kernel);
+CREATE_MPI_OP(MPI_LAND, land_kernel);
+CREATE_MPI_OP(MPI_LOR, lor_kernel);
+CREATE_MPI_OP(MPI_LXOR, lxor_kernel);
+CREATE_MPI_OP(MPI_BAND, band_kernel);
+CREATE_MPI_OP(MPI_BOR, bor_kernel);
+CREATE_MPI_OP(MPI_BXOR, bxor_kernel);
+CREATE_MPI_OP(MPI_MAXLOC, maxloc_kernel);
+CREATE_MPI_OP(MPI_MINLOC, minloc_kernel);
+CREATE_MPI_OP(MPI_REPLACE, replace_kernel);
+CREATE_MPI_OP(MPI_NO_OP, no_kernel);
 
 namespace simgrid{
 namespace smpi{
@@ -247,7 +268,9 @@ void Op::apply(const void* invec, void* inoutvec, const int* len, MPI_Datatype d
   }
 
   if (not smpi_process()->replaying() && *len > 0) {
-    if (not is_fortran_op_)
+    if (kernel_selector_ != nullptr)
+      get_kernel(datatype)(invec, inoutvec, *len, datatype);
+    else if (not is_fortran_op_)
       this->func_(const_cast<void*>(invec), inoutvec, const_cast<int*>(len), &datatype);
     else{
       XBT_DEBUG("Applying operation of length %d from %p and from/to %p", *len, invec, inoutvec);
@@ -259,6 +282,27 @@ void Op::apply(const void* invec, void* inoutvec, const int* len, MPI_Datatype d
   }
 }
 
+/** Returns the kernel applying this (predefined) operation to the given datatype
+ *
+ * Reductions apply the same operation to the same datatype over and over, so the last kernel is kept aside.
+ */
+Op::kernel_type Op::get_kernel(MPI_Datatype datatype)
+{
+  static thread_local const Op* last_op;
+  static thread_local MPI_Datatype last_datatype;
+  static thread_local kernel_type last_kernel;
+  if (this == last_op && datatype == last_datatype)
+    return last_kernel;
+
+  kernel_type kernel = kernel_selector_(datatype);
+  if (datatype->flags() & DT_FLAG_PREDEFINED) { // the other datatypes may be freed, and their address reused
+    last_op       = this;
+    last_datatype = datatype;
+    last_kernel   = kernel;
+  }
+  return kernel;
+}
+
 Op* Op::f2c(int id){
   return static_cast<Op*>(F2C::f2c(id));
 }
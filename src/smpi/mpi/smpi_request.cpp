@@ -162,6 +162,18 @@ int Request::match_send(void* a, void* b, simgrid::kernel::activity::CommImpl*)
     return 0;
 }
 
+/* Key of the request for the indexed matching in mailboxes: a send and a receive can only match if they have the same
+ * source and tag, unless the receive uses a wildcard. The communicator is not part of the key, as the requests of
+ * communicators without id (such as MPI_COMM_WORLD) match the requests of any communicator. */
+bool Request::match_key(void* a, size_t* key)
+{
+  MPI_Request req = static_cast<MPI_Request>(a);
+  if (req->src_ == MPI_ANY_SOURCE || req->tag_ == MPI_ANY_TAG)
+    return false;
+  *key = (static_cast<size_t>(static_cast<unsigned>(req->src_)) * 0x9e3779b9U) ^ static_cast<unsigned>(req->tag_);
+  return true;
+}
+
 void Request::print_request(const char *message)
 {
   XBT_VERB("%s  request %p  [buf = %p, size = %zu, src = %d, dst = %d, tag = %d, flags = %x]",
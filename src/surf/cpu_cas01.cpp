@@ -70,7 +70,7 @@ CpuCas01Model::CpuCas01Model(Model::UpdateAlgo algo) : CpuModel(algo)
     select = true;
   }
 
-  set_maxmin_system(new lmm::System(select));
+  set_maxmin_system(lmm::make_new_maxmin_system(select));
 }
 
 CpuCas01Model::~CpuCas01Model()
@@ -4,6 +4,7 @@
  * under the terms of the license (GNU LGPL) which comes with this package. */
 
 #include "network_cm02.hpp"
+#include "simgrid/kernel/routing/NetZoneImpl.hpp"
 #include "simgrid/s4u/Host.hpp"
 #include "simgrid/sg_config.hpp"
 #include "src/kernel/resource/profile/Event.hpp"
@@ -200,14 +201,15 @@ Action* NetworkCm02Model::communicate(s4u::Host* src, s4u::Host* dst, double siz
         });
   }
 
-  double bandwidth_bound = route.empty() ? -1.0 : get_bandwidth_factor(size) * route.front()->get_bandwidth();
+  double bandwidth_factor = get_bandwidth_factor(size, src, dst);
+  double bandwidth_bound  = route.empty() ? -1.0 : bandwidth_factor * route.front()->get_bandwidth();
 
   for (auto const& link : route)
-    bandwidth_bound = std::min(bandwidth_bound, get_bandwidth_factor(size) * link->get_bandwidth());
+    bandwidth_bound = std::min(bandwidth_bound, bandwidth_factor * link->get_bandwidth());
 
   action->lat_current_ = action->latency_;
-  action->latency_ *= get_latency_factor(size);
-  action->rate_ = get_bandwidth_constraint(action->rate_, bandwidth_bound, size);
+  action->latency_ *= get_latency_factor(size, src, dst);
+  action->rate_ = get_bandwidth_constraint(action->rate_, bandwidth_bound, size, src, dst);
 
   size_t constraints_per_variable = route.size();
   constraints_per_variable += back_route.size();
@@ -369,6 +371,7 @@ void NetworkCm02Link::set_latency(double value)
   int numelem                  = 0;
 
   latency_.peak = value;
+  kernel::routing::NetZoneImpl::clear_route_cache(); // The cached routes include the previous latency
 
   while ((var = get_constraint()->get_variable_safe(&elem, &nextelem, &numelem))) {
     auto* action = static_cast<NetworkCm02Action*>(var->get_id());
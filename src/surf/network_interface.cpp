@@ -39,17 +39,18 @@ simgrid::config::Flag<bool> NetworkModel::cfg_crosstraffic(
 
 NetworkModel::~NetworkModel() = default;
 
-double NetworkModel::get_latency_factor(double /*size*/)
+double NetworkModel::get_latency_factor(double /*size*/, s4u::Host* /*src*/, s4u::Host* /*dst*/)
 {
   return sg_latency_factor;
 }
 
-double NetworkModel::get_bandwidth_factor(double /*size*/)
+double NetworkModel::get_bandwidth_factor(double /*size*/, s4u::Host* /*src*/, s4u::Host* /*dst*/)
 {
   return sg_bandwidth_factor;
 }
 
-double NetworkModel::get_bandwidth_constraint(double rate, double /*bound*/, double /*size*/)
+double NetworkModel::get_bandwidth_constraint(double rate, double /*bound*/, double /*size*/, s4u::Host* /*src*/,
+                                              s4u::Host* /*dst*/)
 {
   return rate;
 }
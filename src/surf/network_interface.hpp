@@ -70,9 +70,11 @@ public:
    * this factor.
    *
    * @param size The size of the message.
+   * @param src The source of the message
+   * @param dst The destination of the message
    * @return The latency factor.
    */
-  virtual double get_latency_factor(double size);
+  virtual double get_latency_factor(double size, s4u::Host* src, s4u::Host* dst);
 
   /**
    * @brief Get the right multiplicative factor for the bandwidth.
@@ -81,9 +83,11 @@ public:
    * gets this factor.
    *
    * @param size The size of the message.
+   * @param src The source of the message
+   * @param dst The destination of the message
    * @return The bandwidth factor.
    */
-  virtual double get_bandwidth_factor(double size);
+  virtual double get_bandwidth_factor(double size, s4u::Host* src, s4u::Host* dst);
 
   /**
    * @brief Get definitive bandwidth.
@@ -92,9 +96,11 @@ public:
    * @param rate The desired maximum bandwidth.
    * @param bound The bandwidth with only the network taken into account.
    * @param size The size of the message.
+   * @param src The source of the message
+   * @param dst The destination of the message
    * @return The new bandwidth.
    */
-  virtual double get_bandwidth_constraint(double rate, double bound, double size);
+  virtual double get_bandwidth_constraint(double rate, double bound, double size, s4u::Host* src, s4u::Host* dst);
   double next_occuring_event_full(double now) override;
 
   LinkImpl* loopback_ = nullptr;
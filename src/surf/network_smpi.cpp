@@ -4,16 +4,16 @@
  * under the terms of the license (GNU LGPL) which comes with this package. */
 
 #include "network_smpi.hpp"
+#include "simgrid/kernel/routing/NetPoint.hpp"
+#include "simgrid/kernel/routing/NetZoneImpl.hpp"
+#include "simgrid/s4u/Host.hpp"
+#include "simgrid/s4u/NetZone.hpp"
 #include "simgrid/sg_config.hpp"
-#include "smpi_utils.hpp"
 #include "src/surf/surf_interface.hpp"
 #include "surf/surf.hpp"
 
 XBT_LOG_EXTERNAL_DEFAULT_CATEGORY(surf_network);
 
-std::vector<s_smpi_factor_t> smpi_bw_factor;
-std::vector<s_smpi_factor_t> smpi_lat_factor;
-
 /*********
  * Model *
  *********/
@@ -47,45 +47,81 @@ NetworkSmpiModel::NetworkSmpiModel() : NetworkCm02Model()
   /* Do not add this into all_existing_models: our ancestor already does so */
 }
 
-double NetworkSmpiModel::get_bandwidth_factor(double size)
+const NetworkSmpiModel::Factors& NetworkSmpiModel::get_zone_factors(routing::NetZoneImpl* zone)
 {
-  if (smpi_bw_factor.empty())
-    smpi_bw_factor = parse_factor(config::get_value<std::string>("smpi/bw-factor"));
-
-  double current = 1.0;
-  for (auto const& fact : smpi_bw_factor) {
-    if (size <= fact.factor) {
-      XBT_DEBUG("%f <= %zu return %f", size, fact.factor, current);
-      return current;
-    } else
-      current = fact.values.front();
+  auto factors = zone_factors_.find(zone);
+  if (factors != zone_factors_.end())
+    return factors->second;
+
+  bool interpolate = config::get_value<bool>("smpi/interpolate-factors");
+  Factors result;
+  if (zone->get_father() != nullptr) {
+    result = get_zone_factors(zone->get_father());
+  } else {
+    bandwidth_factors_ = smpi::FactorTable(config::get_value<std::string>("smpi/bw-factor"), interpolate);
+    latency_factors_   = smpi::FactorTable(config::get_value<std::string>("smpi/lat-factor"), interpolate);
+    result             = {&bandwidth_factors_, &latency_factors_};
   }
-  XBT_DEBUG("%f > %zu return %f", size, smpi_bw_factor.back().factor, current);
 
-  return current;
+  const char* bandwidth = zone->get_iface()->get_property("smpi/bw-factor");
+  if (bandwidth != nullptr) {
+    XBT_DEBUG("Netzone %s has its own bandwidth factors: %s", zone->get_cname(), bandwidth);
+    zone_tables_.emplace_back(new smpi::FactorTable(bandwidth, interpolate));
+    result.bandwidth = zone_tables_.back().get();
+  }
+  const char* latency = zone->get_iface()->get_property("smpi/lat-factor");
+  if (latency != nullptr) {
+    XBT_DEBUG("Netzone %s has its own latency factors: %s", zone->get_cname(), latency);
+    zone_tables_.emplace_back(new smpi::FactorTable(latency, interpolate));
+    result.latency = zone_tables_.back().get();
+  }
+  return zone_factors_.emplace(zone, result).first->second;
 }
 
-double NetworkSmpiModel::get_latency_factor(double size)
+/** Returns the factors of the innermost netzone containing both hosts */
+const NetworkSmpiModel::Factors& NetworkSmpiModel::get_factors(s4u::Host* src, s4u::Host* dst)
 {
-  if (smpi_lat_factor.empty())
-    smpi_lat_factor = parse_factor(config::get_value<std::string>("smpi/lat-factor"));
-
-  double current = 1.0;
-  for (auto const& fact : smpi_lat_factor) {
-    if (size <= fact.factor) {
-      XBT_DEBUG("%f <= %zu return %f", size, fact.factor, current);
-      return current;
-    } else
-      current = fact.values.front();
+  routing::NetZoneImpl* src_zone = src->pimpl_netpoint->get_englobing_zone();
+  routing::NetZoneImpl* dst_zone = dst->pimpl_netpoint->get_englobing_zone();
+  if (src_zone != dst_zone) {
+    auto depth = [](routing::NetZoneImpl* zone) {
+      int result = 0;
+      for (; zone != nullptr; zone = zone->get_father())
+        result++;
+      return result;
+    };
+    int src_depth = depth(src_zone);
+    int dst_depth = depth(dst_zone);
+    for (; src_depth > dst_depth; src_depth--)
+      src_zone = src_zone->get_father();
+    for (; dst_depth > src_depth; dst_depth--)
+      dst_zone = dst_zone->get_father();
+    while (src_zone != dst_zone) {
+      src_zone = src_zone->get_father();
+      dst_zone = dst_zone->get_father();
+    }
   }
-  XBT_DEBUG("%f > %zu return %f", size, smpi_lat_factor.back().factor, current);
+  return get_zone_factors(src_zone);
+}
 
-  return current;
+double NetworkSmpiModel::get_bandwidth_factor(double size, s4u::Host* src, s4u::Host* dst)
+{
+  double factor = get_factors(src, dst).bandwidth->get_factor(size);
+  XBT_DEBUG("Bandwidth factor for %f bytes: %f", size, factor);
+  return factor;
+}
+
+double NetworkSmpiModel::get_latency_factor(double size, s4u::Host* src, s4u::Host* dst)
+{
+  double factor = get_factors(src, dst).latency->get_factor(size);
+  XBT_DEBUG("Latency factor for %f bytes: %f", size, factor);
+  return factor;
 }
 
-double NetworkSmpiModel::get_bandwidth_constraint(double rate, double bound, double size)
+double NetworkSmpiModel::get_bandwidth_constraint(double rate, double bound, double size, s4u::Host* src,
+                                                  s4u::Host* dst)
 {
-  return rate < 0 ? bound : std::min(bound, rate * get_bandwidth_factor(size));
+  return rate < 0 ? bound : std::min(bound, rate * get_bandwidth_factor(size, src, dst));
 }
 } // namespace resource
 } // namespace kernel
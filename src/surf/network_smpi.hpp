@@ -7,19 +7,38 @@
 #include <xbt/base.h>
 
 #include "network_cm02.hpp"
+#include "smpi_utils.hpp"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace simgrid {
 namespace kernel {
 namespace resource {
 
 class XBT_PRIVATE NetworkSmpiModel : public NetworkCm02Model {
+  /* Tables used for the messages within a netzone: its own ones, or the ones of its closest ancestor defining them
+   * (through the smpi/bw-factor and smpi/lat-factor properties), or the ones given by the configuration */
+  struct Factors {
+    const smpi::FactorTable* bandwidth;
+    const smpi::FactorTable* latency;
+  };
+  smpi::FactorTable bandwidth_factors_;
+  smpi::FactorTable latency_factors_;
+  std::vector<std::unique_ptr<smpi::FactorTable>> zone_tables_;
+  std::unordered_map<const routing::NetZoneImpl*, Factors> zone_factors_;
+
+  const Factors& get_zone_factors(routing::NetZoneImpl* zone);
+  const Factors& get_factors(s4u::Host* src, s4u::Host* dst);
+
 public:
   NetworkSmpiModel();
   ~NetworkSmpiModel() = default;
 
-  double get_latency_factor(double size);
-  double get_bandwidth_factor(double size);
-  double get_bandwidth_constraint(double rate, double bound, double size);
+  double get_latency_factor(double size, s4u::Host* src, s4u::Host* dst) override;
+  double get_bandwidth_factor(double size, s4u::Host* src, s4u::Host* dst) override;
+  double get_bandwidth_constraint(double rate, double bound, double size, s4u::Host* src, s4u::Host* dst) override;
 };
 } // namespace resource
 } // namespace kernel
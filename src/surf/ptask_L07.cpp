@@ -4,6 +4,7 @@
  * under the terms of the license (GNU LGPL) which comes with this package. */
 
 #include "ptask_L07.hpp"
+#include "simgrid/kernel/routing/NetZoneImpl.hpp"
 #include "src/kernel/resource/profile/Event.hpp"
 #include "surf/surf.hpp"
 #include "xbt/config.hpp"
@@ -367,6 +368,7 @@ void LinkL07::set_latency(double value)
   const kernel::lmm::Element* elem = nullptr;
 
   latency_.peak = value;
+  kernel::routing::NetZoneImpl::clear_route_cache(); // The cached routes include the previous latency
   while ((var = get_constraint()->get_variable(&elem))) {
     action = static_cast<L07Action*>(var->get_id());
     action->updateBound();
@@ -24,6 +24,7 @@
 #include "src/simix/smx_private.hpp"
 #include "src/surf/HostImpl.hpp"
 #include "src/surf/xml/platf_private.hpp"
+#include "src/surf/xml/platf_snapshot.hpp"
 
 #include <string>
 
@@ -68,6 +69,9 @@ void sg_platf_exit() {
 /** @brief Add a host to the current AS */
 void sg_platf_new_host(simgrid::kernel::routing::HostCreationArgs* args)
 {
+  if (auto* snapshot = sg_platf_snapshot_writer())
+    snapshot->add_host(*args);
+
   std::map<std::string, std::string> props;
   if (args->properties) {
     for (auto const& elm : *args->properties)
@@ -99,6 +103,8 @@ void sg_platf_new_host(simgrid::kernel::routing::HostCreationArgs* args)
 /** @brief Add a "router" to the network element list */
 simgrid::kernel::routing::NetPoint* sg_platf_new_router(const std::string& name, const char* coords)
 {
+  if (auto* snapshot = sg_platf_snapshot_writer())
+    snapshot->add_router(name, coords);
   if (current_routing->hierarchy_ == simgrid::kernel::routing::NetZoneImpl::RoutingMode::unset)
     current_routing->hierarchy_ = simgrid::kernel::routing::NetZoneImpl::RoutingMode::base;
   xbt_assert(nullptr == simgrid::s4u::Engine::get_instance()->netpoint_by_name_or_null(name),
@@ -134,6 +140,9 @@ static void sg_platf_new_link(simgrid::kernel::routing::LinkCreationArgs* link,
 
 void sg_platf_new_link(simgrid::kernel::routing::LinkCreationArgs* link)
 {
+  if (auto* snapshot = sg_platf_snapshot_writer())
+    snapshot->add_link(*link);
+
   if (link->policy == simgrid::s4u::Link::SharingPolicy::SPLITDUPLEX) {
     sg_platf_new_link(link, link->id + "_UP");
     sg_platf_new_link(link, link->id + "_DOWN");
@@ -150,6 +159,10 @@ void sg_platf_new_cluster(simgrid::kernel::routing::ClusterCreationArgs* cluster
   using simgrid::kernel::routing::FatTreeZone;
   using simgrid::kernel::routing::TorusZone;
 
+  if (auto* snapshot = sg_platf_snapshot_writer())
+    snapshot->add_cluster(*cluster);
+  simgrid::kernel::routing::PlatformSnapshotMute mute; // The snapshot replays the whole cluster at once
+
   int rankId=0;
 
   // What an inventive way of initializing the AS that I have as ancestor :-(
@@ -305,12 +318,19 @@ void routing_cluster_add_backbone(simgrid::kernel::resource::LinkImpl* bb)
   xbt_assert(cluster, "Only hosts from Cluster can get a backbone.");
   xbt_assert(nullptr == cluster->backbone_, "Cluster %s already has a backbone link!", cluster->get_cname());
 
+  if (auto* snapshot = sg_platf_snapshot_writer())
+    snapshot->add_backbone(bb);
+
   cluster->backbone_ = bb;
   XBT_DEBUG("Add a backbone to AS '%s'", current_routing->get_cname());
 }
 
 void sg_platf_new_cabinet(simgrid::kernel::routing::CabinetCreationArgs* cabinet)
 {
+  if (auto* snapshot = sg_platf_snapshot_writer())
+    snapshot->add_cabinet(*cabinet);
+  simgrid::kernel::routing::PlatformSnapshotMute mute; // The snapshot replays the whole cabinet at once
+
   for (int const& radical : *cabinet->radicals) {
     std::string hostname = cabinet->prefix + std::to_string(radical) + cabinet->suffix;
     simgrid::kernel::routing::HostCreationArgs host;
@@ -338,6 +358,8 @@ void sg_platf_new_cabinet(simgrid::kernel::routing::CabinetCreationArgs* cabinet
 
 simgrid::kernel::resource::DiskImpl* sg_platf_new_disk(simgrid::kernel::routing::DiskCreationArgs* disk)
 {
+  if (auto* snapshot = sg_platf_snapshot_writer())
+    snapshot->add_disk(*disk);
   simgrid::kernel::resource::DiskImpl* d = surf_disk_model->createDisk(disk->id, disk->read_bw, disk->write_bw);
   if (disk->properties) {
     d->set_properties(*disk->properties);
@@ -349,6 +371,9 @@ simgrid::kernel::resource::DiskImpl* sg_platf_new_disk(simgrid::kernel::routing:
 
 void sg_platf_new_storage(simgrid::kernel::routing::StorageCreationArgs* storage)
 {
+  if (auto* snapshot = sg_platf_snapshot_writer())
+    snapshot->add_storage(*storage);
+
   xbt_assert(std::find(known_storages.begin(), known_storages.end(), storage->id) == known_storages.end(),
              "Refusing to add a second storage named \"%s\"", storage->id.c_str());
 
@@ -388,6 +413,9 @@ void sg_platf_new_storage(simgrid::kernel::routing::StorageCreationArgs* storage
 
 void sg_platf_new_storage_type(simgrid::kernel::routing::StorageTypeCreationArgs* storage_type)
 {
+  if (auto* snapshot = sg_platf_snapshot_writer())
+    snapshot->add_storage_type(*storage_type);
+
   xbt_assert(storage_types.find(storage_type->id) == storage_types.end(),
              "Reading a storage type, processing unit \"%s\" already exists", storage_type->id.c_str());
 
@@ -403,6 +431,9 @@ void sg_platf_new_storage_type(simgrid::kernel::routing::StorageTypeCreationArgs
 
 void sg_platf_new_mount(simgrid::kernel::routing::MountCreationArgs* mount)
 {
+  if (auto* snapshot = sg_platf_snapshot_writer())
+    snapshot->add_mount(*mount);
+
   xbt_assert(std::find(known_storages.begin(), known_storages.end(), mount->storageId) != known_storages.end(),
              "Cannot mount non-existent disk \"%s\"", mount->storageId.c_str());
 
@@ -415,18 +446,25 @@ void sg_platf_new_mount(simgrid::kernel::routing::MountCreationArgs* mount)
 
 void sg_platf_new_route(simgrid::kernel::routing::RouteCreationArgs* route)
 {
+  if (auto* snapshot = sg_platf_snapshot_writer())
+    snapshot->add_route(*route, false);
   routing_get_current()->add_route(route->src, route->dst, route->gw_src, route->gw_dst, route->link_list,
                                    route->symmetrical);
 }
 
 void sg_platf_new_bypassRoute(simgrid::kernel::routing::RouteCreationArgs* bypassRoute)
 {
+  if (auto* snapshot = sg_platf_snapshot_writer())
+    snapshot->add_route(*bypassRoute, true);
   routing_get_current()->add_bypass_route(bypassRoute->src, bypassRoute->dst, bypassRoute->gw_src, bypassRoute->gw_dst,
                                           bypassRoute->link_list, bypassRoute->symmetrical);
 }
 
 void sg_platf_new_actor(simgrid::kernel::routing::ActorCreationArgs* actor)
 {
+  if (auto* snapshot = sg_platf_snapshot_writer())
+    snapshot->add_actor(*actor);
+
   sg_host_t host = sg_host_by_name(actor->host);
   if (not host) {
     // The requested host does not exist. Do a nice message to the user
@@ -496,6 +534,9 @@ void sg_platf_new_actor(simgrid::kernel::routing::ActorCreationArgs* actor)
 
 void sg_platf_new_peer(simgrid::kernel::routing::PeerCreationArgs* peer)
 {
+  if (auto* snapshot = sg_platf_snapshot_writer())
+    snapshot->add_peer(*peer);
+
   simgrid::kernel::routing::VivaldiZone* as = dynamic_cast<simgrid::kernel::routing::VivaldiZone*>(current_routing);
   xbt_assert(as, "<peer> tag can only be used in Vivaldi netzones.");
 
@@ -568,6 +609,9 @@ static void surf_config_models_setup()
  */
 simgrid::kernel::routing::NetZoneImpl* sg_platf_new_Zone_begin(simgrid::kernel::routing::ZoneCreationArgs* zone)
 {
+  if (auto* snapshot = sg_platf_snapshot_writer())
+    snapshot->add_zone_begin(*zone);
+
   if (not surf_parse_models_setup_already_called) {
     simgrid::s4u::Engine::on_platform_creation();
 
@@ -651,7 +695,10 @@ simgrid::kernel::routing::NetZoneImpl* sg_platf_new_Zone_begin(simgrid::kernel::
 void sg_platf_new_Zone_seal()
 {
   xbt_assert(current_routing, "Cannot seal the current AS: none under construction");
+  if (auto* snapshot = sg_platf_snapshot_writer())
+    snapshot->add_zone_seal();
   current_routing->seal();
+  simgrid::kernel::routing::NetZoneImpl::clear_route_cache();
   simgrid::s4u::NetZone::on_seal(*current_routing->get_iface());
   current_routing = static_cast<simgrid::kernel::routing::NetZoneImpl*>(current_routing->get_father());
 }
@@ -659,6 +706,9 @@ void sg_platf_new_Zone_seal()
 /** @brief Add a link connecting a host to the rest of its AS (which must be cluster or vivaldi) */
 void sg_platf_new_hostlink(simgrid::kernel::routing::HostLinkCreationArgs* hostlink)
 {
+  if (auto* snapshot = sg_platf_snapshot_writer())
+    snapshot->add_hostlink(*hostlink);
+
   simgrid::kernel::routing::NetPoint* netpoint = simgrid::s4u::Host::by_name(hostlink->id)->pimpl_netpoint;
   xbt_assert(netpoint, "Host '%s' not found!", hostlink->id.c_str());
   xbt_assert(dynamic_cast<simgrid::kernel::routing::ClusterZone*>(current_routing),
@@ -690,4 +740,7 @@ void sg_platf_new_trace(simgrid::kernel::routing::ProfileCreationArgs* profile)
     mgr_profile = simgrid::kernel::profile::Profile::from_string(profile->id, profile->pc_data, profile->periodicity);
   }
   traces_set_list.insert({profile->id, mgr_profile});
+
+  if (auto* snapshot = sg_platf_snapshot_writer())
+    snapshot->add_trace(profile->id, mgr_profile);
 }
@@ -0,0 +1,774 @@
+/* Copyright (c) 2019. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#include "src/surf/xml/platf_snapshot.hpp"
+#include "simgrid/kernel/routing/NetPoint.hpp"
+#include "simgrid/kernel/routing/NetZoneImpl.hpp"
+#include "simgrid/s4u/Engine.hpp"
+#include "simgrid/s4u/NetZone.hpp"
+#include "src/include/simgrid/sg_config.hpp"
+#include "src/kernel/resource/profile/Profile.hpp"
+#include "src/surf/network_interface.hpp"
+#include "src/surf/surf_interface.hpp"
+#include "xbt/config.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+XBT_LOG_NEW_DEFAULT_SUBCATEGORY(surf_snapshot, surf_parse, "Binary snapshots of the platform");
+
+namespace simgrid {
+namespace kernel {
+namespace routing {
+
+namespace {
+/* The file starts with this magic string, followed by the version of the format (as an uint32_t) */
+const char snapshot_magic[8]          = {'S', 'G', 'P', 'L', 'A', 'T', 'F', '\0'};
+constexpr uint32_t snapshot_version   = 1;
+constexpr uint32_t snapshot_no_string = UINT32_MAX;
+
+enum class Record : uint8_t {
+  CONFIG,
+  ZONE_BEGIN,
+  ZONE_SEAL,
+  ZONE_PROPERTY,
+  HOST,
+  DISK,
+  ROUTER,
+  LINK,
+  BACKBONE,
+  HOSTLINK,
+  PEER,
+  CLUSTER,
+  CABINET,
+  ROUTE,
+  BYPASS_ROUTE,
+  TRACE,
+  TRACE_CONNECT,
+  STORAGE_TYPE,
+  STORAGE,
+  MOUNT,
+  ACTOR
+};
+
+PlatformSnapshotWriter* current_writer = nullptr;
+int writer_muted                       = 0;
+} // namespace
+
+PlatformSnapshotWriter::PlatformSnapshotWriter(const std::string& path) : path_(path)
+{
+  buffer_.append(snapshot_magic, sizeof(snapshot_magic));
+  put(snapshot_version);
+}
+
+void PlatformSnapshotWriter::save() const
+{
+  std::ofstream out(path_, std::ios::binary | std::ios::trunc);
+  xbt_assert(out.good(), "Cannot open %s to save the platform snapshot", path_.c_str());
+  out.write(buffer_.data(), buffer_.size());
+  xbt_assert(out.good(), "Error while writing the platform snapshot to %s", path_.c_str());
+  XBT_INFO("Platform snapshot saved to %s (%zu bytes)", path_.c_str(), buffer_.size());
+}
+
+/* Each string is written once: it is then referred to by its rank among the strings of the file */
+void PlatformSnapshotWriter::put_string(const std::string& str)
+{
+  auto inserted = strings_.emplace(str, strings_.size());
+  put(inserted.first->second);
+  if (inserted.second) {
+    put(static_cast<uint32_t>(str.size()));
+    buffer_.append(str);
+  }
+}
+
+void PlatformSnapshotWriter::put_properties(const std::unordered_map<std::string, std::string>* properties)
+{
+  put(static_cast<uint32_t>(properties ? properties->size() : 0));
+  if (properties)
+    for (auto const& kv : *properties) {
+      put_string(kv.first);
+      put_string(kv.second);
+    }
+}
+
+/* Profiles are given a rank the same way, and embedded with their events the first time they are used */
+void PlatformSnapshotWriter::put_profile(const profile::Profile* profile)
+{
+  if (profile == nullptr) {
+    put(snapshot_no_string);
+    return;
+  }
+  auto inserted = profiles_.emplace(profile, profiles_.size());
+  put(inserted.first->second);
+  if (inserted.second) {
+    put_string(profile->get_name());
+    put(static_cast<uint32_t>(profile->event_list.size()));
+    for (auto const& event : profile->event_list) {
+      put(event.date_);
+      put(event.value_);
+    }
+  }
+}
+
+void PlatformSnapshotWriter::put_netpoint(const NetPoint* netpoint)
+{
+  put_string(netpoint ? netpoint->get_name() : "");
+}
+
+void PlatformSnapshotWriter::add_config(const std::string& key, const std::string& value)
+{
+  put(Record::CONFIG);
+  put_string(key);
+  put_string(value);
+}
+
+void PlatformSnapshotWriter::add_zone_begin(const ZoneCreationArgs& zone)
+{
+  put(Record::ZONE_BEGIN);
+  put_string(zone.id);
+  put(static_cast<int32_t>(zone.routing));
+}
+
+void PlatformSnapshotWriter::add_zone_seal()
+{
+  put(Record::ZONE_SEAL);
+}
+
+void PlatformSnapshotWriter::add_zone_property(const std::string& zone, const std::string& key,
+                                               const std::string& value)
+{
+  put(Record::ZONE_PROPERTY);
+  put_string(zone);
+  put_string(key);
+  put_string(value);
+}
+
+void PlatformSnapshotWriter::add_host(const HostCreationArgs& host)
+{
+  put(Record::HOST);
+  put_string(host.id);
+  put(static_cast<uint32_t>(host.speed_per_pstate.size()));
+  for (double const& speed : host.speed_per_pstate)
+    put(speed);
+  put(static_cast<int32_t>(host.pstate));
+  put(static_cast<int32_t>(host.core_amount));
+  put_profile(host.speed_trace);
+  put_profile(host.state_trace);
+  put_string(host.coord);
+  put_properties(host.properties);
+}
+
+void PlatformSnapshotWriter::add_disk(const DiskCreationArgs& disk)
+{
+  put(Record::DISK);
+  put_string(disk.id);
+  put(disk.read_bw);
+  put(disk.write_bw);
+  put_properties(disk.properties);
+}
+
+void PlatformSnapshotWriter::add_router(const std::string& name, const char* coords)
+{
+  put(Record::ROUTER);
+  put_string(name);
+  put_string(coords ? coords : "");
+}
+
+void PlatformSnapshotWriter::add_link(const LinkCreationArgs& link)
+{
+  put(Record::LINK);
+  put_string(link.id);
+  put(static_cast<uint32_t>(link.bandwidths.size()));
+  for (double const& bw : link.bandwidths)
+    put(bw);
+  put(link.latency);
+  put_profile(link.bandwidth_trace);
+  put_profile(link.latency_trace);
+  put_profile(link.state_trace);
+  put(static_cast<int32_t>(link.policy));
+  put_properties(link.properties);
+}
+
+void PlatformSnapshotWriter::add_backbone(const resource::LinkImpl* link)
+{
+  put(Record::BACKBONE);
+  put_string(link->get_name());
+}
+
+void PlatformSnapshotWriter::add_hostlink(const HostLinkCreationArgs& hostlink)
+{
+  put(Record::HOSTLINK);
+  put_string(hostlink.id);
+  put_string(hostlink.link_up);
+  put_string(hostlink.link_down);
+}
+
+void PlatformSnapshotWriter::add_peer(const PeerCreationArgs& peer)
+{
+  put(Record::PEER);
+  put_string(peer.id);
+  put(peer.speed);
+  put(peer.bw_in);
+  put(peer.bw_out);
+  put_string(peer.coord);
+  put_profile(peer.speed_trace);
+  put_profile(peer.state_trace);
+}
+
+void PlatformSnapshotWriter::add_cluster(const ClusterCreationArgs& cluster)
+{
+  put(Record::CLUSTER);
+  put_string(cluster.id);
+  put_string(cluster.prefix);
+  put_string(cluster.suffix);
+  put(static_cast<uint32_t>(cluster.radicals->size()));
+  for (int const& radical : *cluster.radicals)
+    put(static_cast<int32_t>(radical));
+  put(static_cast<uint32_t>(cluster.speeds.size()));
+  for (double const& speed : cluster.speeds)
+    put(speed);
+  put(static_cast<int32_t>(cluster.core_amount));
+  put(cluster.bw);
+  put(cluster.lat);
+  put(cluster.bb_bw);
+  put(cluster.bb_lat);
+  put(cluster.loopback_bw);
+  put(cluster.loopback_lat);
+  put(cluster.limiter_link);
+  put(static_cast<int32_t>(cluster.topology));
+  put_string(cluster.topo_parameters);
+  put_properties(cluster.properties);
+  put_string(cluster.router_id);
+  put(static_cast<int32_t>(cluster.sharing_policy));
+  put(static_cast<int32_t>(cluster.bb_sharing_policy));
+}
+
+void PlatformSnapshotWriter::add_cabinet(const CabinetCreationArgs& cabinet)
+{
+  put(Record::CABINET);
+  put_string(cabinet.id);
+  put_string(cabinet.prefix);
+  put_string(cabinet.suffix);
+  put(static_cast<uint32_t>(cabinet.radicals->size()));
+  for (int const& radical : *cabinet.radicals)
+    put(static_cast<int32_t>(radical));
+  put(cabinet.speed);
+  put(cabinet.bw);
+  put(cabinet.lat);
+}
+
+void PlatformSnapshotWriter::add_route(const RouteCreationArgs& route, bool bypass)
+{
+  put(bypass ? Record::BYPASS_ROUTE : Record::ROUTE);
+  put(static_cast<uint8_t>(route.symmetrical));
+  put_netpoint(route.src);
+  put_netpoint(route.dst);
+  put_netpoint(route.gw_src);
+  put_netpoint(route.gw_dst);
+  put(static_cast<uint32_t>(route.link_list.size()));
+  for (auto const* link : route.link_list)
+    put_string(link->get_name());
+}
+
+void PlatformSnapshotWriter::add_trace(const std::string& id, const profile::Profile* profile)
+{
+  put(Record::TRACE);
+  put_string(id);
+  put_profile(profile);
+}
+
+void PlatformSnapshotWriter::add_trace_connect(const TraceConnectCreationArgs& trace_connect)
+{
+  put(Record::TRACE_CONNECT);
+  put(static_cast<int32_t>(trace_connect.kind));
+  put_string(trace_connect.trace);
+  put_string(trace_connect.element);
+}
+
+void PlatformSnapshotWriter::add_storage_type(const StorageTypeCreationArgs& storage_type)
+{
+  put(Record::STORAGE_TYPE);
+  put_string(storage_type.id);
+  put_string(storage_type.model);
+  put_string(storage_type.content);
+  put_properties(storage_type.properties);
+  put_properties(storage_type.model_properties);
+  put(storage_type.size);
+}
+
+void PlatformSnapshotWriter::add_storage(const StorageCreationArgs& storage)
+{
+  put(Record::STORAGE);
+  put_string(storage.id);
+  put_string(storage.type_id);
+  put_string(storage.content);
+  put_properties(storage.properties);
+  put_string(storage.attach);
+}
+
+void PlatformSnapshotWriter::add_mount(const MountCreationArgs& mount)
+{
+  put(Record::MOUNT);
+  put_string(mount.storageId);
+  put_string(mount.name);
+}
+
+void PlatformSnapshotWriter::add_actor(const ActorCreationArgs& actor)
+{
+  put(Record::ACTOR);
+  put(static_cast<uint32_t>(actor.args.size()));
+  for (auto const& arg : actor.args)
+    put_string(arg);
+  put_properties(actor.properties);
+  put_string(actor.host);
+  put_string(actor.function);
+  put(actor.start_time);
+  put(actor.kill_time);
+  put(static_cast<int32_t>(actor.on_failure));
+}
+
+PlatformSnapshotMute::PlatformSnapshotMute()
+{
+  writer_muted++;
+}
+
+PlatformSnapshotMute::~PlatformSnapshotMute()
+{
+  writer_muted--;
+}
+
+namespace {
+/** @brief Replays the calls recorded in a snapshot */
+class PlatformSnapshotReader {
+public:
+  explicit PlatformSnapshotReader(const std::string& file);
+  void load();
+
+private:
+  std::string file_;
+  std::string buffer_;
+  size_t pos_ = 0;
+  std::vector<std::string> strings_;
+  std::vector<profile::Profile*> profiles_;
+  std::vector<resource::DiskImpl*> parsed_disks_;
+
+  template <class T> T get()
+  {
+    xbt_assert(pos_ + sizeof(T) <= buffer_.size(), "Truncated platform snapshot %s", file_.c_str());
+    T value;
+    memcpy(&value, buffer_.data() + pos_, sizeof(T));
+    pos_ += sizeof(T);
+    return value;
+  }
+  /* Reads the count of the items of a sequence, checking that the snapshot can hold them before they get allocated */
+  uint32_t get_count(size_t min_item_size)
+  {
+    uint32_t count = get<uint32_t>();
+    xbt_assert(count <= (buffer_.size() - pos_) / min_item_size, "Truncated platform snapshot %s", file_.c_str());
+    return count;
+  }
+  const std::string& get_string();
+  std::unordered_map<std::string, std::string>* get_properties();
+  std::vector<double> get_doubles();
+  std::vector<int>* get_radicals();
+  profile::Profile* get_profile();
+  NetPoint* get_netpoint();
+  resource::LinkImpl* get_link();
+
+  void load_config();
+  void load_host();
+  void load_link();
+  void load_cluster();
+  void load_route(bool bypass);
+  void load_actor();
+};
+
+PlatformSnapshotReader::PlatformSnapshotReader(const std::string& file) : file_(file)
+{
+  FILE* in = surf_fopen(file, "rb");
+  xbt_assert(in, "Cannot open platform snapshot %s", file.c_str());
+  char chunk[65536];
+  size_t read;
+  while ((read = fread(chunk, 1, sizeof(chunk), in)) > 0)
+    buffer_.append(chunk, read);
+  fclose(in);
+
+  xbt_assert(buffer_.size() >= sizeof(snapshot_magic) &&
+                 memcmp(buffer_.data(), snapshot_magic, sizeof(snapshot_magic)) == 0,
+             "%s is not a platform snapshot", file.c_str());
+  pos_             = sizeof(snapshot_magic);
+  uint32_t version = get<uint32_t>();
+  xbt_assert(version == snapshot_version,
+             "Platform snapshot %s uses version %u of the format, but this SimGrid only understands version %u. "
+             "Please regenerate it from the XML file.",
+             file.c_str(), version, snapshot_version);
+}
+
+const std::string& PlatformSnapshotReader::get_string()
+{
+  uint32_t rank = get<uint32_t>();
+  if (rank == strings_.size()) {
+    uint32_t size = get<uint32_t>();
+    xbt_assert(pos_ + size <= buffer_.size(), "Truncated platform snapshot %s", file_.c_str());
+    strings_.emplace_back(buffer_.data() + pos_, size);
+    pos_ += size;
+  }
+  xbt_assert(rank < strings_.size(), "Corrupted platform snapshot %s: unknown string #%u", file_.c_str(), rank);
+  return strings_[rank];
+}
+
+std::unordered_map<std::string, std::string>* PlatformSnapshotReader::get_properties()
+{
+  uint32_t count = get_count(2 * sizeof(uint32_t));
+  if (count == 0)
+    return nullptr;
+  std::unique_ptr<std::unordered_map<std::string, std::string>> properties(
+      new std::unordered_map<std::string, std::string>);
+  for (uint32_t i = 0; i < count; i++) {
+    std::string key = get_string();
+    properties->insert({key, get_string()});
+  }
+  return properties.release();
+}
+
+std::vector<double> PlatformSnapshotReader::get_doubles()
+{
+  std::vector<double> values(get_count(sizeof(double)));
+  for (double& value : values)
+    value = get<double>();
+  return values;
+}
+
+std::vector<int>* PlatformSnapshotReader::get_radicals()
+{
+  std::unique_ptr<std::vector<int>> radicals(new std::vector<int>(get_count(sizeof(int32_t))));
+  for (int& radical : *radicals)
+    radical = get<int32_t>();
+  return radicals.release();
+}
+
+profile::Profile* PlatformSnapshotReader::get_profile()
+{
+  uint32_t rank = get<uint32_t>();
+  if (rank == snapshot_no_string)
+    return nullptr;
+  if (rank == profiles_.size()) {
+    std::string name = get_string();
+    std::vector<profile::DatedValue> events(get_count(2 * sizeof(double)));
+    for (auto& event : events) {
+      event.date_  = get<double>();
+      event.value_ = get<double>();
+    }
+    profiles_.push_back(profile::Profile::from_event_list(name, events));
+  }
+  xbt_assert(rank < profiles_.size(), "Corrupted platform snapshot %s: unknown profile #%u", file_.c_str(), rank);
+  return profiles_[rank];
+}
+
+NetPoint* PlatformSnapshotReader::get_netpoint()
+{
+  const std::string& name = get_string();
+  if (name.empty())
+    return nullptr;
+  NetPoint* netpoint = s4u::Engine::get_instance()->netpoint_by_name_or_null(name);
+  xbt_assert(netpoint, "Corrupted platform snapshot %s: unknown netpoint %s", file_.c_str(), name.c_str());
+  return netpoint;
+}
+
+resource::LinkImpl* PlatformSnapshotReader::get_link()
+{
+  const std::string& name = get_string();
+  s4u::Link* link         = s4u::Link::by_name_or_null(name);
+  xbt_assert(link, "Corrupted platform snapshot %s: unknown link %s", file_.c_str(), name.c_str());
+  return link->get_impl();
+}
+
+/* Same semantic as the <config> tag: the values given on the command line take precedence */
+void PlatformSnapshotReader::load_config()
+{
+  std::string key   = get_string();
+  std::string value = get_string();
+  if (config::is_default(key.c_str()))
+    config::set_parse(key + ":" + value);
+  else
+    XBT_INFO("The custom configuration '%s' is already defined by user!", key.c_str());
+}
+
+void PlatformSnapshotReader::load_host()
+{
+  HostCreationArgs host;
+  std::string id        = get_string();
+  host.id               = id.c_str();
+  host.speed_per_pstate = get_doubles();
+  host.pstate           = get<int32_t>();
+  host.core_amount      = get<int32_t>();
+  host.speed_trace      = get_profile();
+  host.state_trace      = get_profile();
+  host.coord            = get_string();
+  host.properties       = get_properties();
+  host.disks.swap(parsed_disks_);
+  sg_platf_new_host(&host);
+}
+
+void PlatformSnapshotReader::load_link()
+{
+  LinkCreationArgs link;
+  link.id              = get_string();
+  link.bandwidths      = get_doubles();
+  link.latency         = get<double>();
+  link.bandwidth_trace = get_profile();
+  link.latency_trace   = get_profile();
+  link.state_trace     = get_profile();
+  link.policy          = static_cast<s4u::Link::SharingPolicy>(get<int32_t>());
+  link.properties      = get_properties();
+  sg_platf_new_link(&link);
+}
+
+void PlatformSnapshotReader::load_cluster()
+{
+  ClusterCreationArgs cluster;
+  cluster.id                = get_string();
+  cluster.prefix            = get_string();
+  cluster.suffix            = get_string();
+  cluster.radicals          = get_radicals();
+  cluster.speeds            = get_doubles();
+  cluster.core_amount       = get<int32_t>();
+  cluster.bw                = get<double>();
+  cluster.lat               = get<double>();
+  cluster.bb_bw             = get<double>();
+  cluster.bb_lat            = get<double>();
+  cluster.loopback_bw       = get<double>();
+  cluster.loopback_lat      = get<double>();
+  cluster.limiter_link      = get<double>();
+  cluster.topology          = static_cast<ClusterTopology>(get<int32_t>());
+  cluster.topo_parameters   = get_string();
+  cluster.properties        = get_properties();
+  cluster.router_id         = get_string();
+  cluster.sharing_policy    = static_cast<s4u::Link::SharingPolicy>(get<int32_t>());
+  cluster.bb_sharing_policy = static_cast<s4u::Link::SharingPolicy>(get<int32_t>());
+  sg_platf_new_cluster(&cluster);
+}
+
+void PlatformSnapshotReader::load_route(bool bypass)
+{
+  RouteCreationArgs route;
+  route.symmetrical = get<uint8_t>() != 0;
+  route.src         = get_netpoint();
+  route.dst         = get_netpoint();
+  route.gw_src      = get_netpoint();
+  route.gw_dst      = get_netpoint();
+  route.link_list.resize(get_count(sizeof(uint32_t)));
+  for (auto& link : route.link_list)
+    link = get_link();
+  if (bypass)
+    sg_platf_new_bypassRoute(&route);
+  else
+    sg_platf_new_route(&route);
+}
+
+void PlatformSnapshotReader::load_actor()
+{
+  ActorCreationArgs actor;
+  actor.args.resize(get_count(sizeof(uint32_t)));
+  for (auto& arg : actor.args)
+    arg = get_string();
+  actor.properties     = get_properties();
+  std::string host     = get_string();
+  std::string function = get_string();
+  actor.host           = host.c_str();
+  actor.function       = function.c_str();
+  actor.start_time     = get<double>();
+  actor.kill_time      = get<double>();
+  actor.on_failure     = static_cast<ActorOnFailure>(get<int32_t>());
+  sg_platf_new_actor(&actor);
+}
+
+void PlatformSnapshotReader::load()
+{
+  while (pos_ < buffer_.size()) {
+    auto record = get<Record>();
+    switch (record) {
+      case Record::CONFIG:
+        load_config();
+        break;
+      case Record::ZONE_BEGIN: {
+        ZoneCreationArgs zone;
+        zone.id      = get_string();
+        zone.routing = get<int32_t>();
+        sg_platf_new_Zone_begin(&zone);
+        break;
+      }
+      case Record::ZONE_SEAL:
+        sg_platf_new_Zone_seal();
+        break;
+      case Record::ZONE_PROPERTY: {
+        std::string zone  = get_string();
+        std::string key   = get_string();
+        std::string value = get_string();
+        s4u::NetZone* netzone = s4u::Engine::get_instance()->netzone_by_name_or_null(zone);
+        xbt_assert(netzone, "Corrupted platform snapshot %s: unknown netzone %s", file_.c_str(), zone.c_str());
+        netzone->set_property(key, value);
+        break;
+      }
+      case Record::HOST:
+        load_host();
+        break;
+      case Record::DISK: {
+        DiskCreationArgs disk;
+        disk.id         = get_string();
+        disk.read_bw    = get<double>();
+        disk.write_bw   = get<double>();
+        disk.properties = get_properties();
+        parsed_disks_.push_back(sg_platf_new_disk(&disk));
+        break;
+      }
+      case Record::ROUTER: {
+        std::string name   = get_string();
+        std::string coords = get_string();
+        sg_platf_new_router(name, coords.c_str());
+        break;
+      }
+      case Record::LINK:
+        load_link();
+        break;
+      case Record::BACKBONE:
+        routing_cluster_add_backbone(get_link());
+        break;
+      case Record::HOSTLINK: {
+        HostLinkCreationArgs hostlink;
+        hostlink.id        = get_string();
+        hostlink.link_up   = get_string();
+        hostlink.link_down = get_string();
+        sg_platf_new_hostlink(&hostlink);
+        break;
+      }
+      case Record::PEER: {
+        PeerCreationArgs peer;
+        peer.id          = get_string();
+        peer.speed       = get<double>();
+        peer.bw_in       = get<double>();
+        peer.bw_out      = get<double>();
+        peer.coord       = get_string();
+        peer.speed_trace = get_profile();
+        peer.state_trace = get_profile();
+        sg_platf_new_peer(&peer);
+        break;
+      }
+      case Record::CLUSTER:
+        load_cluster();
+        break;
+      case Record::CABINET: {
+        CabinetCreationArgs cabinet;
+        cabinet.id       = get_string();
+        cabinet.prefix   = get_string();
+        cabinet.suffix   = get_string();
+        cabinet.radicals = get_radicals();
+        cabinet.speed    = get<double>();
+        cabinet.bw       = get<double>();
+        cabinet.lat      = get<double>();
+        sg_platf_new_cabinet(&cabinet);
+        break;
+      }
+      case Record::ROUTE:
+        load_route(false);
+        break;
+      case Record::BYPASS_ROUTE:
+        load_route(true);
+        break;
+      case Record::TRACE: {
+        std::string id = get_string();
+        traces_set_list.insert({id, get_profile()});
+        break;
+      }
+      case Record::TRACE_CONNECT: {
+        TraceConnectCreationArgs trace_connect;
+        trace_connect.kind    = static_cast<TraceConnectKind>(get<int32_t>());
+        trace_connect.trace   = get_string();
+        trace_connect.element = get_string();
+        sg_platf_trace_connect(&trace_connect);
+        break;
+      }
+      case Record::STORAGE_TYPE: {
+        StorageTypeCreationArgs storage_type;
+        storage_type.id               = get_string();
+        storage_type.model            = get_string();
+        storage_type.content          = get_string();
+        storage_type.properties       = get_properties();
+        storage_type.model_properties = get_properties();
+        storage_type.size             = get<sg_size_t>();
+        sg_platf_new_storage_type(&storage_type);
+        break;
+      }
+      case Record::STORAGE: {
+        StorageCreationArgs storage;
+        storage.id         = get_string();
+        storage.type_id    = get_string();
+        storage.content    = get_string();
+        storage.properties = get_properties();
+        storage.attach     = get_string();
+        sg_platf_new_storage(&storage);
+        break;
+      }
+      case Record::MOUNT: {
+        MountCreationArgs mount;
+        mount.storageId = get_string();
+        mount.name      = get_string();
+        sg_platf_new_mount(&mount);
+        break;
+      }
+      case Record::ACTOR:
+        load_actor();
+        break;
+      default:
+        xbt_die("Corrupted platform snapshot %s: unknown record type %d", file_.c_str(), static_cast<int>(record));
+    }
+  }
+}
+} // namespace
+} // namespace routing
+} // namespace kernel
+} // namespace simgrid
+
+void sg_platf_snapshot_start(const std::string& path)
+{
+  xbt_assert(simgrid::kernel::routing::current_writer == nullptr, "A platform snapshot is already being recorded");
+  if (not path.empty())
+    simgrid::kernel::routing::current_writer = new simgrid::kernel::routing::PlatformSnapshotWriter(path);
+}
+
+void sg_platf_snapshot_stop()
+{
+  if (simgrid::kernel::routing::current_writer) {
+    simgrid::kernel::routing::current_writer->save();
+    delete simgrid::kernel::routing::current_writer;
+    simgrid::kernel::routing::current_writer = nullptr;
+  }
+}
+
+simgrid::kernel::routing::PlatformSnapshotWriter* sg_platf_snapshot_writer()
+{
+  return simgrid::kernel::routing::writer_muted > 0 ? nullptr : simgrid::kernel::routing::current_writer;
+}
+
+bool sg_platf_snapshot_check(const std::string& file)
+{
+  FILE* in = surf_fopen(file, "rb");
+  if (in == nullptr)
+    return false;
+  char magic[sizeof(simgrid::kernel::routing::snapshot_magic)];
+  bool res = fread(magic, 1, sizeof(magic), in) == sizeof(magic) &&
+             memcmp(magic, simgrid::kernel::routing::snapshot_magic, sizeof(magic)) == 0;
+  fclose(in);
+  return res;
+}
+
+void sg_platf_snapshot_load(const std::string& file)
+{
+  simgrid::kernel::routing::PlatformSnapshotReader(file).load();
+  simgrid::s4u::Engine::on_platform_created();
+}
@@ -0,0 +1,96 @@
+/* Copyright (c) 2019. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#ifndef SURF_PLATF_SNAPSHOT_HPP
+#define SURF_PLATF_SNAPSHOT_HPP
+
+#include "src/surf/xml/platf_private.hpp"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace simgrid {
+namespace kernel {
+namespace routing {
+
+/** @brief Records the platform creation calls into a binary file that can be loaded in place of the XML file
+ *
+ * The snapshot is a flat sequence of records, one per call to the sg_platf_new_* functions (plus the configuration
+ * and the netzone properties, that the XML parser handles directly). Loading it replays these calls, bypassing the
+ * lexer, the SAX callbacks and the conversion of the attributes from text. The strings are interned (each string is
+ * written only once, and then referred to by its rank), and the profiles are embedded with their values so that the
+ * snapshot does not depend on the profile files.
+ *
+ * Compound elements such as clusters and cabinets are recorded as such: the calls that they trigger are not recorded.
+ */
+class XBT_PRIVATE PlatformSnapshotWriter {
+public:
+  explicit PlatformSnapshotWriter(const std::string& path);
+  PlatformSnapshotWriter(const PlatformSnapshotWriter&) = delete;
+  PlatformSnapshotWriter& operator=(const PlatformSnapshotWriter&) = delete;
+
+  void add_config(const std::string& key, const std::string& value);
+  void add_zone_begin(const ZoneCreationArgs& zone);
+  void add_zone_seal();
+  void add_zone_property(const std::string& zone, const std::string& key, const std::string& value);
+  void add_host(const HostCreationArgs& host);
+  void add_disk(const DiskCreationArgs& disk);
+  void add_router(const std::string& name, const char* coords);
+  void add_link(const LinkCreationArgs& link);
+  void add_backbone(const resource::LinkImpl* link);
+  void add_hostlink(const HostLinkCreationArgs& hostlink);
+  void add_peer(const PeerCreationArgs& peer);
+  void add_cluster(const ClusterCreationArgs& cluster);
+  void add_cabinet(const CabinetCreationArgs& cabinet);
+  void add_route(const RouteCreationArgs& route, bool bypass);
+  void add_trace(const std::string& id, const profile::Profile* profile);
+  void add_trace_connect(const TraceConnectCreationArgs& trace_connect);
+  void add_storage_type(const StorageTypeCreationArgs& storage_type);
+  void add_storage(const StorageCreationArgs& storage);
+  void add_mount(const MountCreationArgs& mount);
+  void add_actor(const ActorCreationArgs& actor);
+
+  /** Writes the snapshot to its file */
+  void save() const;
+
+private:
+  std::string path_;
+  std::string buffer_;
+  std::unordered_map<std::string, uint32_t> strings_;
+  std::unordered_map<const profile::Profile*, uint32_t> profiles_;
+
+  template <class T> void put(T value) { buffer_.append(reinterpret_cast<const char*>(&value), sizeof(T)); }
+  void put_string(const std::string& str);
+  void put_properties(const std::unordered_map<std::string, std::string>* properties);
+  void put_profile(const profile::Profile* profile);
+  void put_netpoint(const NetPoint* netpoint);
+};
+
+/** @brief Prevents the recording of the sg_platf calls made during its lifetime (by a compound element) */
+class XBT_PRIVATE PlatformSnapshotMute {
+public:
+  PlatformSnapshotMute();
+  PlatformSnapshotMute(const PlatformSnapshotMute&) = delete;
+  PlatformSnapshotMute& operator=(const PlatformSnapshotMute&) = delete;
+  ~PlatformSnapshotMute();
+};
+} // namespace routing
+} // namespace kernel
+} // namespace simgrid
+
+/** Starts recording the platform creation calls into the given file (if not empty) */
+XBT_PRIVATE void sg_platf_snapshot_start(const std::string& path);
+/** Stops the current recording (if any), and saves the snapshot */
+XBT_PRIVATE void sg_platf_snapshot_stop();
+/** Returns the recorder to which the current sg_platf call must be reported, or nullptr if it must not be recorded */
+XBT_PRIVATE simgrid::kernel::routing::PlatformSnapshotWriter* sg_platf_snapshot_writer();
+
+/** Tells whether the given file is a platform snapshot (instead of an XML or Lua file) */
+XBT_PRIVATE bool sg_platf_snapshot_check(const std::string& file);
+/** Creates the platform described in the given snapshot */
+XBT_PRIVATE void sg_platf_snapshot_load(const std::string& file);
+
+#endif
@@ -8,6 +8,8 @@
 #include "src/surf/network_interface.hpp"
 #include "src/surf/surf_interface.hpp"
 #include "src/surf/xml/platf_private.hpp"
+#include "src/surf/xml/platf_snapshot.hpp"
+#include "xbt/config.hpp"
 
 #include <vector>
 
@@ -22,6 +24,10 @@
 
 XBT_LOG_EXTERNAL_DEFAULT_CATEGORY(surf_parse);
 
+static simgrid::config::Flag<std::string> cfg_platform_snapshot{
+    "surf/platform-snapshot",
+    "File in which the loaded platform is saved, in a binary format that loads faster than the XML file", ""};
+
 /* Trace related stuff */
 XBT_PRIVATE std::unordered_map<std::string, simgrid::kernel::profile::Profile*> traces_set_list;
 XBT_PRIVATE std::unordered_map<std::string, std::string> trace_connect_list_host_avail;
@@ -32,6 +38,9 @@ XBT_PRIVATE std::unordered_map<std::string, std::string> trace_connect_list_link
 
 void sg_platf_trace_connect(simgrid::kernel::routing::TraceConnectCreationArgs* trace_connect)
 {
+  if (auto* snapshot = sg_platf_snapshot_writer())
+    snapshot->add_trace_connect(*trace_connect);
+
   xbt_assert(traces_set_list.find(trace_connect->trace) != traces_set_list.end(),
              "Cannot connect trace %s to %s: trace unknown", trace_connect->trace.c_str(),
              trace_connect->element.c_str());
@@ -58,48 +67,9 @@ void sg_platf_trace_connect(simgrid::kernel::routing::TraceConnectCreationArgs*
   }
 }
 
-/* This function acts as a main in the parsing area. */
-void parse_platform_file(const std::string& file)
+/* Connect the profiles that were declared with <trace_connect> to their resources */
+static void connect_profiles()
 {
-  const char* cfile = file.c_str();
-  int len           = strlen(cfile);
-  int is_lua        = len > 3 && file[len - 3] == 'l' && file[len - 2] == 'u' && file[len - 1] == 'a';
-
-  sg_platf_init();
-
-  /* Check if file extension is "lua". If so, we will use
-   * the lua bindings to parse the platform file (since it is
-   * written in lua). If not, we will use the (old?) XML parser
-   */
-  if (is_lua) {
-#if SIMGRID_HAVE_LUA
-    lua_State* L = luaL_newstate();
-    luaL_openlibs(L);
-
-    luaL_loadfile(L, cfile); // This loads the file without executing it.
-
-    /* Run the script */
-    if (lua_pcall(L, 0, 0, 0)) {
-      XBT_ERROR("FATAL ERROR:\n  %s: %s\n\n", "Lua call failed. Error message:", lua_tostring(L, -1));
-      xbt_die("Lua call failed. See Log");
-    }
-    lua_close(L);
-    return;
-#else
-    XBT_WARN("This looks like a lua platform file, but your SimGrid was not compiled with lua. Loading it as XML.");
-#endif
-  }
-
-  // Use XML parser
-
-  int parse_status;
-
-  /* init the flex parser */
-  surf_parse_open(file);
-
-  /* Do the actual parsing */
-  parse_status = surf_parse();
-
   /* connect all profiles relative to hosts */
   for (auto const& elm : trace_connect_list_host_avail) {
     xbt_assert(traces_set_list.find(elm.first) != traces_set_list.end(), "Trace %s undefined", elm.first.c_str());
@@ -147,8 +117,63 @@ void parse_platform_file(const std::string& file)
     xbt_assert(link, "Link %s undefined", elm.second.c_str());
     link->set_latency_profile(profile);
   }
+}
+
+/* This function acts as a main in the parsing area. */
+void parse_platform_file(const std::string& file)
+{
+  const char* cfile = file.c_str();
+  int len           = strlen(cfile);
+  int is_lua        = len > 3 && file[len - 3] == 'l' && file[len - 2] == 'u' && file[len - 1] == 'a';
+
+  sg_platf_init();
+
+  /* Platform snapshots are loaded directly, without any parsing */
+  if (sg_platf_snapshot_check(file)) {
+    sg_platf_snapshot_load(file);
+    connect_profiles();
+    return;
+  }
+  sg_platf_snapshot_start(cfg_platform_snapshot);
+
+  /* Check if file extension is "lua". If so, we will use
+   * the lua bindings to parse the platform file (since it is
+   * written in lua). If not, we will use the (old?) XML parser
+   */
+  if (is_lua) {
+#if SIMGRID_HAVE_LUA
+    lua_State* L = luaL_newstate();
+    luaL_openlibs(L);
+
+    luaL_loadfile(L, cfile); // This loads the file without executing it.
+
+    /* Run the script */
+    if (lua_pcall(L, 0, 0, 0)) {
+      XBT_ERROR("FATAL ERROR:\n  %s: %s\n\n", "Lua call failed. Error message:", lua_tostring(L, -1));
+      xbt_die("Lua call failed. See Log");
+    }
+    lua_close(L);
+    sg_platf_snapshot_stop();
+    return;
+#else
+    XBT_WARN("This looks like a lua platform file, but your SimGrid was not compiled with lua. Loading it as XML.");
+#endif
+  }
+
+  // Use XML parser
+
+  int parse_status;
+
+  /* init the flex parser */
+  surf_parse_open(file);
+
+  /* Do the actual parsing */
+  parse_status = surf_parse();
+
+  connect_profiles();
 
   surf_parse_close();
+  sg_platf_snapshot_stop();
 
   if (parse_status)
     surf_parse_error(std::string("Parse error in ") + file);
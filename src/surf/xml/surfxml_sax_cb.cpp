@@ -11,6 +11,7 @@
 #include "src/surf/network_interface.hpp"
 #include "src/surf/surf_interface.hpp"
 #include "src/surf/xml/platf_private.hpp"
+#include "src/surf/xml/platf_snapshot.hpp"
 #include "surf/surf.hpp"
 #include "xbt/file.hpp"
 
@@ -424,6 +425,8 @@ void STag_surfxml_prop()
     simgrid::s4u::NetZone* netzone = simgrid::s4u::Engine::get_instance()->netzone_by_name_or_null(A_surfxml_zone_id);
 
     netzone->set_property(std::string(A_surfxml_prop_id), A_surfxml_prop_value);
+    if (auto* snapshot = sg_platf_snapshot_writer())
+      snapshot->add_zone_property(A_surfxml_zone_id, A_surfxml_prop_id, A_surfxml_prop_value);
   } else {
     if (not current_property_set)
       current_property_set = new std::unordered_map<std::string, std::string>; // Maybe, it should raise an error
@@ -923,6 +926,8 @@ void ETag_surfxml_config()
   }
   std::sort(keys.begin(), keys.end());
   for (std::string key : keys) {
+    if (auto* snapshot = sg_platf_snapshot_writer())
+      snapshot->add_config(key, current_property_set->at(key));
     if (simgrid::config::is_default(key.c_str())) {
       std::string cfg = key + ":" + current_property_set->at(key);
       simgrid::config::set_parse(std::move(cfg));
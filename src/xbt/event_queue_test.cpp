@@ -0,0 +1,98 @@
+/* Copyright (c) 2019. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#include "xbt/event_queue.hpp"
+
+#include "catch.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+TEST_CASE("xbt::EventQueue: queue of dated events", "EventQueue")
+{
+  SECTION("Events are given by date, then by insertion order")
+  {
+    simgrid::xbt::EventQueue<int> queue;
+    queue.push(3.0, 30);
+    queue.push(1.0, 10);
+    queue.push(2.0, 20);
+    queue.push(1.0, 11);
+    queue.push(2.0, 21);
+    REQUIRE(queue.size() == 5);
+
+    std::vector<int> order;
+    while (not queue.empty()) {
+      REQUIRE(queue.top_date() == queue.top() / 10);
+      order.push_back(queue.pop());
+    }
+    REQUIRE(order == std::vector<int>({10, 11, 20, 21, 30}));
+  }
+
+  SECTION("Cancelled events are never given")
+  {
+    simgrid::xbt::EventQueue<int> queue;
+    std::vector<simgrid::xbt::EventQueue<int>::handle_type> handles;
+    for (int i = 0; i < 100; i++)
+      handles.push_back(queue.push(i, i));
+    for (int i = 0; i < 100; i += 3)
+      queue.cancel(handles[i]);
+    queue.cancel(handles[1]);
+    REQUIRE(queue.size() == 100 - 34 - 1);
+
+    std::vector<int> expected;
+    for (int i = 2; i < 100; i++)
+      if (i % 3 != 0)
+        expected.push_back(i);
+    std::vector<int> order;
+    while (not queue.empty())
+      order.push_back(queue.pop());
+    REQUIRE(order == expected);
+  }
+
+  SECTION("Purging the cancelled events keeps the order and the other handles")
+  {
+    simgrid::xbt::EventQueue<int> queue;
+    std::vector<simgrid::xbt::EventQueue<int>::handle_type> handles;
+    for (int i = 0; i < 1000; i++)
+      handles.push_back(queue.push((i * 7919) % 100, i)); // 10 events per date, not pushed in the date order
+    for (int i = 0; i < 1000; i++)
+      if (i % 4 != 0)
+        queue.cancel(handles[i]); // More than half of the heap: purged on the way
+    REQUIRE(queue.size() == 250);
+
+    // The remaining handles still designate their own event, even once the freed slots are reused
+    for (int i = 0; i < 100; i++)
+      queue.push(1000 + i, 1000 + i);
+    for (int i = 0; i < 1000; i += 8)
+      queue.cancel(handles[i]);
+    REQUIRE(queue.size() == 225);
+
+    std::vector<std::pair<double, int>> expected;
+    for (int i = 4; i < 1000; i += 8)
+      expected.push_back({(i * 7919) % 100, i});
+    for (int i = 0; i < 100; i++)
+      expected.push_back({1000 + i, 1000 + i});
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](const std::pair<double, int>& a, const std::pair<double, int>& b) { return a.first < b.first; });
+    std::vector<std::pair<double, int>> order;
+    while (not queue.empty()) {
+      double date = queue.top_date();
+      order.push_back({date, queue.pop()});
+    }
+    REQUIRE(order == expected);
+  }
+
+  SECTION("Slots are reused")
+  {
+    simgrid::xbt::EventQueue<int> queue;
+    auto first = queue.push(1.0, 1);
+    queue.cancel(first);
+    REQUIRE(queue.empty());
+    REQUIRE(queue.push(2.0, 2) == first);
+    REQUIRE(queue.pop() == 2);
+    REQUIRE(queue.push(3.0, 3) == first);
+  }
+}
@@ -4,10 +4,24 @@
  * under the terms of the license (GNU LGPL) which comes with this package. */
 
 #include "simgrid/Exception.hpp"
+#include "src/internal_config.h"
 #include "xbt/log.h"
 #include "xbt/replay.hpp"
 
-#include <boost/algorithm/string.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#if HAVE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(replay,xbt,"Replay trace reader");
 
@@ -16,84 +30,146 @@ namespace xbt {
 
 std::ifstream* action_fs = nullptr;
 std::unordered_map<std::string, action_fun> action_funs;
-static std::unordered_map<std::string, std::queue<ReplayAction*>*> action_queues;
 
-static void read_and_trim_line(std::ifstream& fs, std::string* line)
-{
-  do {
-    std::getline(fs, *line);
-    boost::trim(*line);
-  } while (not fs.eof() && (line->length() == 0 || line->front() == '#'));
-  XBT_DEBUG("got from trace: %s", line->c_str());
-}
+/** @brief Content of a trace file, that is scanned line by line without being copied
+ *
+ * The file is mapped in memory when possible, and read at once otherwise. The lines are never copied: the actions are
+ * split from the file content directly, and the lines read for other actors are only remembered by their position.
+ */
+class TraceContent {
+  const char* data_ = nullptr;
+  size_t size_      = 0;
+  size_t pos_       = 0;
+  bool mapped_      = false;
+  std::string buffer_; // content of the file, when it is not mapped
 
-class ReplayReader {
-  std::ifstream fs;
-  std::string line;
+  void use_buffer()
+  {
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+  }
 
 public:
-  explicit ReplayReader(const char* filename) : fs(filename, std::ifstream::in)
+  /* The position of a line in the file, as given by next_line() */
+  typedef std::pair<const char*, const char*> Line;
+
+  explicit TraceContent(const std::string& filename)
   {
-    XBT_VERB("Prepare to replay file '%s'", filename);
-    xbt_assert(fs.is_open(), "Cannot read replay file '%s'", filename);
+    XBT_VERB("Prepare to replay file '%s'", filename.c_str());
+#if HAVE_MMAP
+    int fd = open(filename.c_str(), O_RDONLY);
+    xbt_assert(fd >= 0, "Cannot read replay file '%s': %s", filename.c_str(), strerror(errno));
+    struct stat st;
+    int res = fstat(fd, &st);
+    xbt_assert(res == 0, "Cannot stat replay file '%s': %s", filename.c_str(), strerror(errno));
+    size_ = st.st_size;
+    if (size_ > 0) {
+      void* addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      xbt_assert(addr != MAP_FAILED, "Cannot map replay file '%s': %s", filename.c_str(), strerror(errno));
+      madvise(addr, size_, MADV_SEQUENTIAL);
+      data_   = static_cast<const char*>(addr);
+      mapped_ = true;
+    }
+    close(fd);
+#else
+    std::ifstream fs(filename, std::ifstream::in | std::ifstream::binary);
+    xbt_assert(fs.is_open(), "Cannot read replay file '%s'", filename.c_str());
+    buffer_.assign(std::istreambuf_iterator<char>(fs), {});
+    use_buffer();
+#endif
+  }
+  explicit TraceContent(std::istream& stream) : buffer_(std::istreambuf_iterator<char>(stream), {}) { use_buffer(); }
+  TraceContent(const TraceContent&) = delete;
+  TraceContent& operator=(const TraceContent&) = delete;
+  ~TraceContent()
+  {
+#if HAVE_MMAP
+    if (mapped_)
+      munmap(const_cast<char*>(data_), size_);
+#endif
+  }
+
+  /** Gets the next line that is neither empty nor a comment, without its surrounding spaces. Returns false at the end
+   * of the file */
+  bool next_line(Line* line)
+  {
+    const char* end = data_ + size_;
+    while (pos_ < size_) {
+      const char* begin = data_ + pos_;
+      auto eol          = static_cast<const char*>(memchr(begin, '\n', end - begin));
+      if (eol == nullptr)
+        eol = end;
+      pos_ = eol - data_ + (eol < end ? 1 : 0);
+
+      while (begin < eol && isspace(static_cast<unsigned char>(*begin)))
+        begin++;
+      const char* last = eol;
+      while (last > begin && isspace(static_cast<unsigned char>(last[-1])))
+        last--;
+      if (begin < last && *begin != '#') {
+        XBT_DEBUG("got from trace: %.*s", static_cast<int>(last - begin), begin);
+        *line = {begin, last};
+        return true;
+      }
+    }
+    return false;
   }
-  ReplayReader(const ReplayReader&) = delete;
-  ReplayReader& operator=(const ReplayReader&) = delete;
-  bool get(ReplayAction* action);
 };
 
-bool ReplayReader::get(ReplayAction* action)
+static std::unique_ptr<TraceContent> shared_trace; // content of action_fs, or of the file given to the whole simulation
+static std::unordered_map<std::string, std::queue<TraceContent::Line>> action_queues;
+
+static bool is_separator(char c)
+{
+  return c == ' ' || c == '\t';
+}
+
+/* Returns the first field of the line, that is the name of the actor */
+static std::pair<const char*, size_t> get_actor_name(const TraceContent::Line& line)
 {
-  read_and_trim_line(fs, &line);
+  auto end = std::find_if(line.first, line.second, is_separator);
+  return {line.first, end - line.first};
+}
 
-  boost::split(*action, line, boost::is_any_of(" \t"), boost::token_compress_on);
-  return not fs.eof();
+/* Splits the line into the action. The strings already in the action are reused, to save on allocations */
+static void split_line(const TraceContent::Line& line, ReplayAction* action)
+{
+  size_t count = 0;
+  const char* pos = line.first;
+  while (pos < line.second) {
+    const char* end = std::find_if(pos, line.second, is_separator);
+    if (count < action->size())
+      (*action)[count].assign(pos, end - pos);
+    else
+      action->emplace_back(pos, end - pos);
+    count++;
+    pos = std::find_if_not(end, line.second, is_separator);
+  }
+  action->resize(count);
 }
 
-static ReplayAction* get_action(const char* name)
+/* Gets the next action of that actor in the shared trace, while remembering the actions of the other actors */
+static bool get_action(const std::string& name, ReplayAction* action)
 {
-  ReplayAction* action;
-
-  std::queue<ReplayAction*>* myqueue = nullptr;
-  if (action_queues.find(std::string(name)) != action_queues.end())
-    myqueue = action_queues.at(std::string(name));
-  if (myqueue == nullptr || myqueue->empty()) { // Nothing stored for me. Read the file further
-    // Read lines until I reach something for me (which breaks in loop body) or end of file reached
-    while (true) {
-      std::string action_line;
-      read_and_trim_line(*action_fs, &action_line);
-      if (action_fs->eof())
-        break;
-      /* we cannot split in place here because we parse&store several lines for the colleagues... */
-      action = new ReplayAction();
-      boost::split(*action, action_line, boost::is_any_of(" \t"), boost::token_compress_on);
-
-      // if it's for me, I'm done
-      std::string evtname = action->front();
-      if (evtname.compare(name) == 0) {
-        return action;
-      } else {
-        // Else, I have to store it for the relevant colleague
-        std::queue<ReplayAction*>* otherqueue = nullptr;
-        auto act                              = action_queues.find(evtname);
-        if (act != action_queues.end()) {
-          otherqueue = act->second;
-        } else { // Damn. Create the queue of that guy
-          otherqueue = new std::queue<ReplayAction*>();
-          action_queues.insert({evtname, otherqueue});
-        }
-        otherqueue->push(action);
-      }
-    }
-    // end of file reached while searching in vain for more work
-  } else {
-    // Get something from my queue and return it
-    action = myqueue->front();
-    myqueue->pop();
-    return action;
+  auto myqueue = action_queues.find(name);
+  if (myqueue != action_queues.end() && not myqueue->second.empty()) { // Get something from my queue
+    split_line(myqueue->second.front(), action);
+    myqueue->second.pop();
+    return true;
   }
 
-  return nullptr;
+  // Nothing stored for me. Read lines until I reach something for me, or the end of file
+  TraceContent::Line line;
+  while (shared_trace->next_line(&line)) {
+    auto actor = get_actor_name(line);
+    if (actor.second == name.size() && name.compare(0, name.size(), actor.first, actor.second) == 0) {
+      split_line(line, action);
+      return true;
+    }
+    // Else, I have to store it for the relevant colleague
+    action_queues[std::string(actor.first, actor.second)].push(line);
+  }
+  return false;
 }
 
 static void handle_action(ReplayAction& action)
@@ -115,30 +191,24 @@ static void handle_action(ReplayAction& action)
 int replay_runner(const char* actor_name, const char* trace_filename)
 {
   std::string actor_name_string(actor_name);
-  if (simgrid::xbt::action_fs) { // <A unique trace file
-    while (true) {
-      simgrid::xbt::ReplayAction* evt = simgrid::xbt::get_action(actor_name);
-      if (!evt)
-        break;
-      simgrid::xbt::handle_action(*evt);
-      delete evt;
-    }
-    if (action_queues.find(actor_name_string) != action_queues.end()) {
-      std::queue<ReplayAction*>* myqueue = action_queues.at(actor_name_string);
-      delete myqueue;
-      action_queues.erase(actor_name_string);
-    }
+  ReplayAction evt;
+  if (shared_trace != nullptr || action_fs != nullptr) { // <A unique trace file
+    if (shared_trace == nullptr)
+      shared_trace.reset(new TraceContent(*action_fs));
+    while (get_action(actor_name_string, &evt))
+      handle_action(evt);
+    action_queues.erase(actor_name_string);
   } else { // Should have got my trace file in argument
     xbt_assert(trace_filename != nullptr);
-    simgrid::xbt::ReplayAction evt;
-    simgrid::xbt::ReplayReader reader(trace_filename);
-    while (reader.get(&evt)) {
-      if (evt.front().compare(actor_name) == 0) {
-        simgrid::xbt::handle_action(evt);
+    TraceContent trace(trace_filename);
+    TraceContent::Line line;
+    while (trace.next_line(&line)) {
+      split_line(line, &evt);
+      if (evt.front() == actor_name_string) {
+        handle_action(evt);
       } else {
         XBT_WARN("Ignore trace element not for me (target='%s', I am '%s')", evt.front().c_str(), actor_name);
       }
-      evt.clear();
     }
   }
   return 0;
@@ -146,6 +216,23 @@ int replay_runner(const char* actor_name, const char* trace_filename)
 }
 }
 
+/**
+ * @ingroup XBT_replay
+ * @brief Sets the trace file containing the actions of all actors
+ *
+ * The lines of that file start with the name of the actor that must execute them. The file is read as the actors need
+ * their next actions, and remains open until xbt_replay_set_tracefile() is called again (with an empty name to close
+ * it). This is the preferred alternative to opening simgrid::xbt::action_fs.
+ */
+void xbt_replay_set_tracefile(const std::string& filename)
+{
+  simgrid::xbt::action_queues.clear();
+  if (filename.empty())
+    simgrid::xbt::shared_trace.reset();
+  else
+    simgrid::xbt::shared_trace.reset(new simgrid::xbt::TraceContent(filename));
+}
+
 /**
  * @ingroup XBT_replay
  * @brief Registers a function to handle a kind of action
@@ -0,0 +1,62 @@
+/* Copyright (c) 2019. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#include "simgrid/s4u.hpp"
+#include "simgrid/simix.hpp"
+#include "src/surf/network_interface.hpp"
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(s4u_test, "Messages specific for this test");
+
+static void show_route(simgrid::s4u::Host* src, simgrid::s4u::Host* dst, std::vector<simgrid::s4u::Link*>& links)
+{
+  simgrid::s4u::Engine* e = simgrid::s4u::Engine::get_instance();
+  double latency          = 0;
+  links.clear();
+  // The routes are only cached for maestro, as the actors may run in parallel
+  simgrid::kernel::actor::simcall([src, dst, &links, &latency]() { src->route_to(dst, links, &latency); });
+  XBT_INFO("Route %s -> %s: %zu links, latency %g (hits: %lu, misses: %lu)", src->get_cname(), dst->get_cname(),
+           links.size(), latency, e->get_route_cache_hits(), e->get_route_cache_misses());
+}
+
+static void tester()
+{
+  simgrid::s4u::Host* tremblay = simgrid::s4u::Host::by_name("Tremblay");
+  simgrid::s4u::Host* jupiter  = simgrid::s4u::Host::by_name("Jupiter");
+  std::vector<simgrid::s4u::Link*> links;
+
+  show_route(tremblay, jupiter, links);
+  show_route(tremblay, jupiter, links);
+  show_route(tremblay, jupiter, links);
+
+  simgrid::s4u::Link* link = links.front();
+  XBT_INFO("Change the latency of %s", link->get_cname());
+  simgrid::kernel::actor::simcall([link]() { link->get_impl()->set_latency(2 * link->get_latency()); });
+  show_route(tremblay, jupiter, links);
+  show_route(tremblay, jupiter, links);
+
+  XBT_INFO("Ask for a route directly from the actor");
+  tremblay->route_to(jupiter, links, nullptr);
+  show_route(tremblay, jupiter, links);
+
+  simgrid::s4u::Host* fafard  = simgrid::s4u::Host::by_name("Fafard");
+  simgrid::s4u::Host* ginette = simgrid::s4u::Host::by_name("Ginette");
+  show_route(tremblay, fafard, links);
+  show_route(tremblay, jupiter, links);
+  show_route(tremblay, ginette, links);
+  show_route(tremblay, jupiter, links);
+  show_route(tremblay, fafard, links);
+}
+
+int main(int argc, char* argv[])
+{
+  simgrid::s4u::Engine e(&argc, argv);
+  xbt_assert(argc > 1, "Usage: %s platform_file\n", argv[0]);
+  e.load_platform(argv[1]);
+
+  simgrid::s4u::Actor::create("tester", simgrid::s4u::Host::by_name("Tremblay"), tester);
+  e.run();
+
+  return 0;
+}
@@ -0,0 +1,201 @@
+/* Copyright (c) 2019. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Microbenchmark of the predefined reduction operations.
+ *
+ * They are compared to user-defined operations that look for the datatype at each call, and then loop over the
+ * elements, as the predefined operations used to do. With a duration of 0, the benchmark only checks that both give
+ * the same results. Run it with --cfg=smpi/simulate-computation:no, so that the measured loops are not simulated.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "mpi.h"
+
+#undef clock_gettime /* measure the real time, not the simulated one */
+
+#define MAX_OP(a, b) (b) = (a) < (b) ? (b) : (a)
+#define SUM_OP(a, b) (b) += (a)
+#define BAND_OP(a, b) (b) &= (a)
+
+#define LEGACY_LOOP(dtype, type, op)                                                                                   \
+  if (*datatype == (dtype)) {                                                                                          \
+    type* x = (type*)a;                                                                                                \
+    type* y = (type*)b;                                                                                                \
+    for (int i = 0; i < *length; i++)                                                                                  \
+      op(x[i], y[i]);                                                                                                  \
+  } else
+
+#define LEGACY_INTEGER_LOOPS(op)                                                                                       \
+  LEGACY_LOOP(MPI_CHAR, char, op)                                                                                      \
+  LEGACY_LOOP(MPI_SHORT, short, op)                                                                                    \
+  LEGACY_LOOP(MPI_INT, int, op)                                                                                        \
+  LEGACY_LOOP(MPI_LONG, long, op)                                                                                      \
+  LEGACY_LOOP(MPI_LONG_LONG, long long, op)                                                                            \
+  LEGACY_LOOP(MPI_SIGNED_CHAR, signed char, op)                                                                        \
+  LEGACY_LOOP(MPI_UNSIGNED_CHAR, unsigned char, op)                                                                    \
+  LEGACY_LOOP(MPI_UNSIGNED_SHORT, unsigned short, op)                                                                  \
+  LEGACY_LOOP(MPI_UNSIGNED, unsigned int, op)                                                                          \
+  LEGACY_LOOP(MPI_UNSIGNED_LONG, unsigned long, op)                                                                    \
+  LEGACY_LOOP(MPI_UNSIGNED_LONG_LONG, unsigned long long, op)                                                          \
+  LEGACY_LOOP(MPI_WCHAR, wchar_t, op)                                                                                  \
+  LEGACY_LOOP(MPI_BYTE, int8_t, op)                                                                                    \
+  LEGACY_LOOP(MPI_INT8_T, int8_t, op)                                                                                  \
+  LEGACY_LOOP(MPI_INT16_T, int16_t, op)                                                                                \
+  LEGACY_LOOP(MPI_INT32_T, int32_t, op)                                                                                \
+  LEGACY_LOOP(MPI_INT64_T, int64_t, op)                                                                                \
+  LEGACY_LOOP(MPI_UINT8_T, uint8_t, op)                                                                                \
+  LEGACY_LOOP(MPI_UINT16_T, uint16_t, op)                                                                              \
+  LEGACY_LOOP(MPI_UINT32_T, uint32_t, op)                                                                              \
+  LEGACY_LOOP(MPI_UINT64_T, uint64_t, op)                                                                              \
+  LEGACY_LOOP(MPI_AINT, MPI_Aint, op)                                                                                  \
+  LEGACY_LOOP(MPI_OFFSET, MPI_Offset, op)                                                                              \
+  LEGACY_LOOP(MPI_INTEGER1, int, op)                                                                                   \
+  LEGACY_LOOP(MPI_INTEGER2, int16_t, op)                                                                               \
+  LEGACY_LOOP(MPI_INTEGER4, int32_t, op)                                                                               \
+  LEGACY_LOOP(MPI_INTEGER8, int64_t, op)                                                                               \
+  LEGACY_LOOP(MPI_COUNT, long long, op)
+
+#define LEGACY_FLOAT_LOOPS(op)                                                                                         \
+  LEGACY_LOOP(MPI_FLOAT, float, op)                                                                                    \
+  LEGACY_LOOP(MPI_DOUBLE, double, op)
+
+static void legacy_max(void* a, void* b, int* length, MPI_Datatype* datatype)
+{
+  LEGACY_INTEGER_LOOPS(MAX_OP)
+  LEGACY_FLOAT_LOOPS(MAX_OP)
+  abort();
+}
+
+static void legacy_sum(void* a, void* b, int* length, MPI_Datatype* datatype)
+{
+  LEGACY_INTEGER_LOOPS(SUM_OP)
+  LEGACY_FLOAT_LOOPS(SUM_OP)
+  abort();
+}
+
+static void legacy_band(void* a, void* b, int* length, MPI_Datatype* datatype)
+{
+  LEGACY_INTEGER_LOOPS(BAND_OP)
+  abort();
+}
+
+static double now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Returns the time per element of the operation, or -1 if the duration is 0 */
+static double bench(MPI_Op op, MPI_Datatype type, const void* in, void* inout, int count, double duration)
+{
+  if (duration <= 0) {
+    MPI_Reduce_local(in, inout, count, type, op);
+    return -1;
+  }
+  long long elements = 0;
+  double begin       = now();
+  double elapsed;
+  do {
+    for (int i = 0; i < 16; i++)
+      MPI_Reduce_local(in, inout, count, type, op);
+    elements += 16LL * count;
+    elapsed = now() - begin;
+  } while (elapsed < duration);
+  return elapsed / elements;
+}
+
+int main(int argc, char* argv[])
+{
+  MPI_Init(&argc, &argv);
+  double duration = argc > 1 ? atof(argv[1]) : 0.5;
+
+  MPI_Op legacy_max_op;
+  MPI_Op legacy_sum_op;
+  MPI_Op legacy_band_op;
+  MPI_Op_create(legacy_max, 1, &legacy_max_op);
+  MPI_Op_create(legacy_sum, 1, &legacy_sum_op);
+  MPI_Op_create(legacy_band, 1, &legacy_band_op);
+
+  struct {
+    const char* name;
+    MPI_Op op;
+    MPI_Op legacy;
+    int integer_only;
+  } ops[] = {{"MPI_MAX", MPI_MAX, legacy_max_op, 0},
+             {"MPI_SUM", MPI_SUM, legacy_sum_op, 0},
+             {"MPI_BAND", MPI_BAND, legacy_band_op, 1}};
+  struct {
+    const char* name;
+    MPI_Datatype type;
+    size_t size;
+    int is_integer;
+  } types[] = {{"MPI_CHAR", MPI_CHAR, sizeof(char), 1},
+               {"MPI_INT", MPI_INT, sizeof(int), 1},
+               {"MPI_LONG_LONG", MPI_LONG_LONG, sizeof(long long), 1},
+               {"MPI_FLOAT", MPI_FLOAT, sizeof(float), 0},
+               {"MPI_DOUBLE", MPI_DOUBLE, sizeof(double), 0}};
+  int counts[] = {16, 1024, 65536};
+
+  int max_count  = 65536;
+  char* in       = malloc(max_count * sizeof(double));
+  char* inout    = malloc(max_count * sizeof(double));
+  char* expected = malloc(max_count * sizeof(double));
+
+  for (unsigned o = 0; o < sizeof(ops) / sizeof(ops[0]); o++) {
+    for (unsigned t = 0; t < sizeof(types) / sizeof(types[0]); t++) {
+      if (ops[o].integer_only && !types[t].is_integer)
+        continue;
+      for (unsigned c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        int count    = counts[c];
+        size_t bytes = count * types[t].size;
+        for (size_t i = 0; i < bytes; i++) {
+          in[i]       = (char)(i * 7 + 3);
+          inout[i]    = (char)(i * 13 + 5);
+          expected[i] = inout[i];
+        }
+        if (!types[t].is_integer) { /* avoid NaNs */
+          for (int i = 0; i < count; i++) {
+            if (types[t].type == MPI_FLOAT) {
+              ((float*)in)[i]       = (float)(i % 97) - 48;
+              ((float*)inout)[i]    = (float)(i % 89) - 44;
+              ((float*)expected)[i] = ((float*)inout)[i];
+            } else {
+              ((double*)in)[i]       = (double)(i % 97) - 48;
+              ((double*)inout)[i]    = (double)(i % 89) - 44;
+              ((double*)expected)[i] = ((double*)inout)[i];
+            }
+          }
+        }
+        MPI_Reduce_local(in, inout, count, types[t].type, ops[o].op);
+        MPI_Reduce_local(in, expected, count, types[t].type, ops[o].legacy);
+        if (memcmp(inout, expected, bytes) != 0) {
+          printf("%s on %d %s: wrong result\n", ops[o].name, count, types[t].name);
+          MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+
+        double predefined = bench(ops[o].op, types[t].type, in, inout, count, duration);
+        double legacy     = bench(ops[o].legacy, types[t].type, in, expected, count, duration);
+        if (duration > 0)
+          printf("%-8s %-13s x %5d: %7.3f ns/element (legacy dispatch: %7.3f ns/element, speedup %.2f)\n", ops[o].name,
+                 types[t].name, count, predefined * 1e9, legacy * 1e9, legacy / predefined);
+      }
+    }
+  }
+  printf("All predefined operations give the same results as the legacy ones\n");
+
+  free(in);
+  free(inout);
+  free(expected);
+  MPI_Op_free(&legacy_max_op);
+  MPI_Op_free(&legacy_sum_op);
+  MPI_Op_free(&legacy_band_op);
+  MPI_Finalize();
+  return 0;
+}
@@ -0,0 +1,145 @@
+/* Copyright (c) 2019. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* This program mixes receives with and without wildcards on deep queues of pending messages and requests, and checks
+ * that the messages coming from a given source are never received out of order (MPI non-overtaking rule). */
+#include <stdio.h>
+#include <string.h>
+#include <mpi.h>
+
+#define NB_MSGS 100 /* per sender */
+#define NB_TAGS 4
+#define NB_SENDERS 2
+#define NB_RECVS (NB_MSGS * NB_SENDERS)
+
+/* The receive pattern: a few keyed receives, then wildcards on the source, then wildcards on the tag, then both */
+static void recv_spec(int k, int* source, int* tag)
+{
+  if (k < 10) {
+    *source = 1;
+    *tag    = 3;
+  } else if (k < 20) {
+    *source = MPI_ANY_SOURCE;
+    *tag    = 1;
+  } else if (k < 30) {
+    *source = 2;
+    *tag    = MPI_ANY_TAG;
+  } else if (k < 60 && k % 2 == 0) {
+    *source = 1 + (k / 2) % NB_SENDERS;
+    *tag    = MPI_ANY_TAG;
+  } else {
+    *source = MPI_ANY_SOURCE;
+    *tag    = MPI_ANY_TAG;
+  }
+}
+
+static int matches(int source, int tag, int from, int seq)
+{
+  return (source == MPI_ANY_SOURCE || source == from) && (tag == MPI_ANY_TAG || tag == seq % NB_TAGS);
+}
+
+/* Checks that each receive got a message matching it, and that no two messages of the same source that both match
+ * two receives were received in the reverse order. When all the messages were already there, each receive must also
+ * get the first matching message of the source it picked. */
+static void check(const char* phase, const int* data, const MPI_Status* status, int all_sent)
+{
+  int errors           = 0;
+  unsigned fingerprint = 0;
+  int received[NB_SENDERS + 1][NB_MSGS];
+  memset(received, 0, sizeof(received));
+  for (int k = 0; k < NB_RECVS; k++) {
+    int source;
+    int tag;
+    recv_spec(k, &source, &tag);
+    int from = status[k].MPI_SOURCE;
+    if (from < 1 || from > NB_SENDERS || data[k] < 0 || data[k] >= NB_MSGS || status[k].MPI_TAG != data[k] % NB_TAGS ||
+        !matches(source, tag, from, data[k])) {
+      printf("%s: receive #%d got message %d from %d with tag %d, which does not match\n", phase, k, data[k], from,
+             status[k].MPI_TAG);
+      errors++;
+      continue;
+    }
+    if (all_sent)
+      for (int seq = 0; seq < data[k]; seq++)
+        if (!received[from][seq] && matches(source, tag, from, seq)) {
+          printf("%s: receive #%d got message %d from %d before message %d\n", phase, k, data[k], from, seq);
+          errors++;
+          break;
+        }
+    received[from][data[k]] = 1;
+    for (int j = 0; j < k; j++) {
+      int source_j;
+      int tag_j;
+      recv_spec(j, &source_j, &tag_j);
+      if (status[j].MPI_SOURCE == from && data[j] > data[k] && matches(source_j, tag_j, from, data[k]) &&
+          matches(source, tag, from, data[j])) {
+        printf("%s: receive #%d got message %d from %d, overtaken by message %d in receive #%d\n", phase, j, data[j],
+               from, data[k], k);
+        errors++;
+      }
+    }
+    fingerprint = (fingerprint * 31 + (unsigned)(from * NB_MSGS + data[k])) % 1000003;
+  }
+  printf("%s: %d messages received, %d errors (matching fingerprint: %u)\n", phase, NB_RECVS, errors, fingerprint);
+}
+
+int main(int argc, char* argv[])
+{
+  int rank;
+  int size;
+  int data[NB_RECVS];
+  int seq[NB_MSGS];
+  MPI_Status status[NB_RECVS];
+  MPI_Request requests[NB_RECVS];
+
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  if (size != NB_SENDERS + 1) {
+    if (rank == 0)
+      printf("This test needs %d processes\n", NB_SENDERS + 1);
+    MPI_Finalize();
+    return 1;
+  }
+
+  /* Unexpected messages: everything is sent before the first receive is posted */
+  if (rank == 0) {
+    MPI_Barrier(MPI_COMM_WORLD);
+    for (int k = 0; k < NB_RECVS; k++) {
+      int source;
+      int tag;
+      recv_spec(k, &source, &tag);
+      MPI_Recv(&data[k], 1, MPI_INT, source, tag, MPI_COMM_WORLD, &status[k]);
+    }
+    check("unexpected", data, status, 1);
+  } else {
+    for (int i = 0; i < NB_MSGS; i++) {
+      seq[i] = i;
+      MPI_Isend(&seq[i], 1, MPI_INT, 0, i % NB_TAGS, MPI_COMM_WORLD, &requests[i]);
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+    MPI_Waitall(NB_MSGS, requests, MPI_STATUSES_IGNORE);
+  }
+
+  /* Posted receives: everything is received before the first message is sent */
+  if (rank == 0) {
+    for (int k = 0; k < NB_RECVS; k++) {
+      int source;
+      int tag;
+      recv_spec(k, &source, &tag);
+      MPI_Irecv(&data[k], 1, MPI_INT, source, tag, MPI_COMM_WORLD, &requests[k]);
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+    MPI_Waitall(NB_RECVS, requests, status);
+    check("posted", data, status, 0);
+  } else {
+    MPI_Barrier(MPI_COMM_WORLD);
+    for (int i = 0; i < NB_MSGS; i++)
+      MPI_Send(&seq[i], 1, MPI_INT, 0, i % NB_TAGS, MPI_COMM_WORLD);
+  }
+
+  MPI_Finalize();
+  return 0;
+}
@@ -0,0 +1,77 @@
+/* Copyright (c) 2019. The SimGrid Team.
+ * All rights reserved.                                                     */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Exchanges several elements of a vector of structures: each element starts one extent after the previous one, and
+ * the fields that are not in the type map are left untouched. */
+
+#include <stddef.h>
+#include <stdio.h>
+#include "mpi.h"
+#define SIZE 6
+
+struct particle {
+  double position;
+  int id;
+  char tag;
+};
+
+static void print_particles(const char* what, int rank, const struct particle* particles)
+{
+  for (int i = 0; i < SIZE; i++)
+    printf("rank= %d, %s[%d] = {%.1f, %d, %c}\n", rank, what, i, particles[i].position, particles[i].id,
+           particles[i].tag);
+}
+
+int main(int argc, char** argv)
+{
+  int rank;
+  struct particle mine[SIZE];
+  struct particle received[SIZE];
+  struct particle gathered[SIZE];
+
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  for (int i = 0; i < SIZE; i++) {
+    mine[i].position = rank * 100 + i;
+    mine[i].id       = rank * 100 + i;
+    mine[i].tag      = 'a' + i;
+    received[i].position = -1;
+    received[i].id       = -1;
+    received[i].tag      = '-';
+    gathered[i]          = received[i];
+  }
+
+  /* the position and id of a particle, and then every other particle out of three */
+  int block_lengths[2]      = {1, 1};
+  MPI_Aint displacements[2] = {offsetof(struct particle, position), offsetof(struct particle, id)};
+  MPI_Datatype types[2]     = {MPI_DOUBLE, MPI_INT};
+  MPI_Datatype fields;
+  MPI_Datatype particle_type;
+  MPI_Datatype every_other;
+  MPI_Type_create_struct(2, block_lengths, displacements, types, &fields);
+  MPI_Type_create_resized(fields, 0, sizeof(struct particle), &particle_type);
+  MPI_Type_vector(2, 1, 2, particle_type, &every_other);
+  MPI_Type_commit(&every_other);
+
+  if (rank == 0)
+    MPI_Send(mine, 2, every_other, 1, 42, MPI_COMM_WORLD);
+  else if (rank == 1) {
+    MPI_Recv(received, 2, every_other, 0, 42, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    print_particles("received", rank, received);
+  }
+
+  /* the local part is copied from one derived datatype to the other */
+  MPI_Allgather(mine, 1, every_other, gathered, 2, particle_type, MPI_COMM_WORLD);
+  if (rank == 0)
+    print_particles("gathered", rank, gathered);
+
+  MPI_Type_free(&fields);
+  MPI_Type_free(&particle_type);
+  MPI_Type_free(&every_other);
+  MPI_Finalize();
+  return 0;
+}
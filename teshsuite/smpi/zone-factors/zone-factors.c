@@ -0,0 +1,41 @@
+/* Copyright (c) 2019. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Measures the simulated time of messages of several sizes, between the ranks 0 and 1 and between the ranks 2 and 3.
+ * On zone-factors.xml, both pairs use identical links but different bandwidth and latency factors. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "mpi.h"
+
+int main(int argc, char* argv[])
+{
+  MPI_Init(&argc, &argv);
+  int rank;
+  int size;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  if (size != 4) {
+    printf("run this program with exactly 4 processes (-np 4)\n");
+    MPI_Abort(MPI_COMM_WORLD, 1);
+  }
+
+  int sizes[] = {4, 32768, 100000};
+  char* buffer = malloc(100000);
+  int peer     = rank ^ 1;
+  for (unsigned i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    MPI_Barrier(MPI_COMM_WORLD);
+    double begin = MPI_Wtime();
+    if (rank % 2 == 0) {
+      MPI_Send(buffer, sizes[i], MPI_CHAR, peer, 0, MPI_COMM_WORLD);
+    } else {
+      MPI_Recv(buffer, sizes[i], MPI_CHAR, peer, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+      printf("[%d] received %6d bytes from %d in %.6f\n", rank, sizes[i], peer, MPI_Wtime() - begin);
+    }
+  }
+  free(buffer);
+  MPI_Finalize();
+  return 0;
+}
@@ -42,7 +42,7 @@ static void test(int nb_cnst, int nb_var, int nb_elem, unsigned int pw_base_limi
   int used[nb_cnst];
 
   /* We cannot activate the selective update as we pass nullptr as an Action when creating the variables */
-  simgrid::kernel::lmm::System* Sys = new simgrid::kernel::lmm::System(false);
+  simgrid::kernel::lmm::System* Sys = simgrid::kernel::lmm::make_new_maxmin_system(false);
 
   for (int i = 0; i < nb_cnst; i++) {
     cnst[i] = Sys->constraint_new(NULL, float_random(10.0));
@@ -0,0 +1,189 @@
+/* Copyright (c) 2019. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Compares xbt::EventQueue with the heaps that were used before for the simix timers (boost's fibonacci heap, one
+ * allocation per timer) and for the future events of the profiles (std::priority_queue) */
+
+#include "xbt/event_queue.hpp"
+#include "xbt/utility.hpp"
+#include <simgrid/msg.h>
+#include <xbt.h>
+
+#include <boost/heap/fibonacci_heap.hpp>
+#include <cstdlib>
+#include <deque>
+#include <queue>
+#include <random>
+#include <vector>
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(event_queue_bench, "Bench for the event queues");
+
+constexpr unsigned STEPS = 10000;
+
+struct FakeTimer {
+  double date;
+};
+
+/* Interface of the benchmarked queues: push() returns a handle, cancel() takes it, pop() gives the earliest event */
+class EventQueueAdapter {
+  simgrid::xbt::EventQueue<FakeTimer*> queue_;
+
+public:
+  typedef simgrid::xbt::EventQueue<FakeTimer*>::handle_type handle_type;
+  static const char* name() { return "xbt::EventQueue"; }
+  bool empty() const { return queue_.empty(); }
+  double top_date() const { return queue_.top_date(); }
+  handle_type push(double date, FakeTimer* timer) { return queue_.push(date, timer); }
+  void cancel(handle_type handle) { queue_.cancel(handle); }
+  FakeTimer* pop() { return queue_.pop(); }
+};
+
+class FibonacciHeapAdapter {
+  typedef std::pair<double, FakeTimer*> Qelt;
+  typedef boost::heap::fibonacci_heap<Qelt, boost::heap::compare<simgrid::xbt::HeapComparator<Qelt>>> Heap;
+  Heap heap_;
+
+public:
+  typedef Heap::handle_type handle_type;
+  static const char* name() { return "boost::heap::fibonacci_heap"; }
+  bool empty() const { return heap_.empty(); }
+  double top_date() const { return heap_.top().first; }
+  handle_type push(double date, FakeTimer* timer) { return heap_.emplace(date, timer); }
+  void cancel(handle_type handle) { heap_.erase(handle); }
+  FakeTimer* pop()
+  {
+    FakeTimer* timer = heap_.top().second;
+    heap_.pop();
+    return timer;
+  }
+};
+
+class PriorityQueueAdapter {
+  typedef std::pair<double, FakeTimer*> Qelt;
+  std::priority_queue<Qelt, std::vector<Qelt>, std::greater<Qelt>> heap_;
+
+public:
+  typedef int handle_type;
+  static const char* name() { return "std::priority_queue"; }
+  bool empty() const { return heap_.empty(); }
+  double top_date() const { return heap_.top().first; }
+  handle_type push(double date, FakeTimer* timer)
+  {
+    heap_.emplace(date, timer);
+    return 0;
+  }
+  FakeTimer* pop()
+  {
+    FakeTimer* timer = heap_.top().second;
+    heap_.pop();
+    return timer;
+  }
+};
+
+/* Actors waiting with a timeout: most timers are cancelled before they fire, and are allocated as the simix timers
+ * were (the EventQueue adapter allocates them too, to only measure the queue) */
+template <class Queue> static void bench_timeouts(unsigned size, double timeout)
+{
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> delay(0.0, 10.0);
+  std::bernoulli_distribution completes_first(0.9);
+
+  int i             = 0;
+  double start_time = xbt_os_time();
+  double elapsed_time;
+  do {
+    Queue queue;
+    struct Pending {
+      typename Queue::handle_type handle;
+      FakeTimer* timer;
+      double date;
+    };
+    std::deque<Pending> pending;
+    double now = 0.0;
+    for (unsigned step = 0; step < STEPS; step++) {
+      now += 0.01;
+      while (not queue.empty() && queue.top_date() <= now)
+        delete queue.pop();
+      auto* timer = new FakeTimer{now + delay(gen)};
+      pending.push_back({queue.push(timer->date, timer), timer, timer->date});
+      if (pending.size() >= size) {
+        auto elm = pending.front();
+        pending.pop_front();
+        // the timers that are not past yet are still in the queue
+        if (completes_first(gen) && elm.date > now) {
+          queue.cancel(elm.handle);
+          delete elm.timer;
+        }
+      }
+    }
+    while (not queue.empty())
+      delete queue.pop();
+    elapsed_time = xbt_os_time() - start_time;
+    i++;
+  } while (elapsed_time < timeout);
+
+  XBT_INFO("   %-28s ran %d times in %g seconds (%g/s)", Queue::name(), i, elapsed_time, i / elapsed_time);
+}
+
+/* Classical hold model: the earliest event is replaced by a later one, as in the future event set of the profiles */
+template <class Queue> static void bench_hold(unsigned size, double timeout)
+{
+  std::mt19937 gen(42);
+  std::exponential_distribution<double> delay(1.0);
+  FakeTimer dummy{0};
+
+  int i             = 0;
+  double start_time = xbt_os_time();
+  double elapsed_time;
+  do {
+    Queue queue;
+    for (unsigned j = 0; j < size; j++)
+      queue.push(delay(gen), &dummy);
+    for (unsigned step = 0; step < STEPS; step++) {
+      double date = queue.top_date();
+      queue.pop();
+      queue.push(date + delay(gen), &dummy);
+    }
+    elapsed_time = xbt_os_time() - start_time;
+    i++;
+  } while (elapsed_time < timeout);
+
+  XBT_INFO("   %-28s ran %d times in %g seconds (%g/s)", Queue::name(), i, elapsed_time, i / elapsed_time);
+}
+
+int main(int argc, char* argv[])
+{
+  xbt_log_control_set("event_queue_bench.fmt:[%c/%p]%e%m%n");
+  MSG_init(&argc, argv);
+
+  if (argc != 3) {
+    XBT_INFO("Usage: %s size timeout", argv[0]);
+    XBT_INFO("    size    - number of pending events");
+    XBT_INFO("    timeout - max duration for each test");
+    return EXIT_FAILURE;
+  }
+  int size = atoi(argv[1]);
+  if (size < 1) {
+    XBT_ERROR("Invalid size: %d", size);
+    return EXIT_FAILURE;
+  }
+  double timeout = atof(argv[2]);
+
+  XBT_INFO("Event queue benchmark with %d pending events, %u steps per run...", size, STEPS);
+  XBT_INFO("%s", "");
+
+  XBT_INFO("Benchmark for timeouts (90%% of the timers are cancelled):");
+  bench_timeouts<EventQueueAdapter>(size, timeout);
+  bench_timeouts<FibonacciHeapAdapter>(size, timeout);
+  XBT_INFO("%s", "");
+
+  XBT_INFO("Benchmark for the hold model (no cancellation):");
+  bench_hold<EventQueueAdapter>(size, timeout);
+  bench_hold<FibonacciHeapAdapter>(size, timeout);
+  bench_hold<PriorityQueueAdapter>(size, timeout);
+  XBT_INFO("%s", "");
+
+  return EXIT_SUCCESS;
+}
@@ -14,7 +14,9 @@
 #include <cstdlib>
 #include <numeric> // std::iota
 #include <sstream>
+#include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(parmap_test, "Test for parmap");
@@ -37,8 +39,12 @@ static int test_parmap_basic(e_xbt_parmap_mode_t mode)
     std::iota(begin(a), end(a), 0);
     std::iota(begin(data), end(data), &a[0]);
 
-    for (unsigned i = 0; i < num; i++)
-      parmap.apply(fun_double, data);
+    for (unsigned i = 0; i < num; i++) {
+      if (i % 2 == 0)
+        parmap.apply(fun_double, data);
+      else
+        parmap.apply_inline(fun_double, data);
+    }
 
     for (unsigned i = 0; i < len; i++) {
       unsigned expected = (1U << num) * (i + 1) - 1;
@@ -84,6 +90,52 @@ static int test_parmap_extended(e_xbt_parmap_mode_t mode)
   return ret;
 }
 
+static void fun_unbalanced(std::pair<unsigned, std::string>* arg)
+{
+  std::stringstream ss;
+  ss << std::this_thread::get_id();
+  arg->second = ss.str();
+  if (arg->first == 0) // The first items are much longer than the other ones
+    xbt_os_sleep(0.01);
+}
+
+static int test_parmap_unbalanced(e_xbt_parmap_mode_t mode)
+{
+  int ret = 0;
+
+  for (unsigned num_workers = 2; num_workers <= 16; num_workers *= 2) {
+    const unsigned len = 8 * num_workers;
+
+    simgrid::xbt::Parmap<std::pair<unsigned, std::string>*> parmap(num_workers, mode);
+    std::vector<std::pair<unsigned, std::string>> a(len);
+    std::vector<std::pair<unsigned, std::string>*> data(len);
+    for (unsigned i = 0; i < len; i++) {
+      a[i].first = i * num_workers / len; // The long items would all be given to the first worker without sharing
+      data[i]    = &a[i];
+    }
+
+    parmap.apply(fun_unbalanced, data);
+
+    std::vector<std::string> long_items;
+    for (auto const& item : a) {
+      if (item.second.empty()) {
+        XBT_CRITICAL("with %u threads, some items were not processed", num_workers);
+        ret = 1;
+        break;
+      }
+      if (item.first == 0)
+        long_items.push_back(item.second);
+    }
+    std::sort(begin(long_items), end(long_items));
+    unsigned count = std::distance(begin(long_items), std::unique(begin(long_items), end(long_items)));
+    if (count < 2) {
+      XBT_CRITICAL("with %u threads, the long items were not shared", num_workers);
+      ret = 1;
+    }
+  }
+  return ret;
+}
+
 int main(int argc, char** argv)
 {
   int status = 0;
@@ -99,6 +151,8 @@ int main(int argc, char** argv)
 #endif
   XBT_INFO("Basic testing busy wait");
   status += test_parmap_basic(XBT_PARMAP_BUSY_WAIT);
+  XBT_INFO("Basic testing work stealing");
+  status += test_parmap_basic(XBT_PARMAP_WORK_STEALING);
 
   XBT_INFO("Extended testing posix");
   status += test_parmap_extended(XBT_PARMAP_POSIX);
@@ -108,6 +162,13 @@ int main(int argc, char** argv)
 #endif
   XBT_INFO("Extended testing busy wait");
   status += test_parmap_extended(XBT_PARMAP_BUSY_WAIT);
+  XBT_INFO("Extended testing work stealing");
+  status += test_parmap_extended(XBT_PARMAP_WORK_STEALING);
+
+  XBT_INFO("Unbalanced testing posix");
+  status += test_parmap_unbalanced(XBT_PARMAP_POSIX);
+  XBT_INFO("Unbalanced testing work stealing");
+  status += test_parmap_unbalanced(XBT_PARMAP_WORK_STEALING);
 
   return status == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -8,10 +8,12 @@ set(EXTRA_DIST
   src/include/simgrid/sg_config.hpp
   src/include/surf/surf.hpp
   src/include/xbt/coverage.h
+  src/include/xbt/event_queue.hpp
   src/include/xbt/parmap.hpp
   src/include/xbt/mmalloc.h
   src/include/catch.hpp
   src/include/xxhash.hpp
+  src/mc/mc_checkpoint.hpp
   src/mc/mc_mmu.hpp
   src/mc/mc_record.hpp
   src/msg/msg_private.hpp
@@ -311,6 +313,7 @@ set(SURF_SRC
   src/kernel/lmm/fair_bottleneck.cpp
   src/kernel/lmm/maxmin.hpp
   src/kernel/lmm/maxmin.cpp
+  src/kernel/lmm/soa_maxmin.cpp
 
   src/kernel/resource/Action.cpp
   src/kernel/resource/Model.cpp
@@ -357,6 +360,8 @@ set(SURF_SRC
   src/surf/surf_interface.cpp
   src/surf/xml/platf.hpp
   src/surf/xml/platf_private.hpp
+  src/surf/xml/platf_snapshot.cpp
+  src/surf/xml/platf_snapshot.hpp
   src/surf/xml/surfxml_sax_cb.cpp
   src/surf/xml/surfxml_parseplatf.cpp
   src/surf/host_clm03.cpp
@@ -556,6 +561,8 @@ set(LUA_SRC
   )
 
 set(TRACING_SRC
+  src/instr/instr_binary_trace.cpp
+  src/instr/instr_binary_trace.hpp
   src/instr/instr_config.cpp
   src/instr/instr_interface.cpp
   src/instr/instr_paje_containers.cpp
@@ -571,6 +578,8 @@ set(TRACING_SRC
   src/instr/instr_platform.cpp
   src/instr/instr_private.hpp
   src/instr/instr_smpi.hpp
+  src/instr/instr_trace_file.cpp
+  src/instr/instr_trace_file.hpp
   src/instr/instr_resource_utilization.cpp
   )
 
@@ -601,6 +610,8 @@ set(MC_SRC
   src/mc/checker/Checker.hpp
   src/mc/checker/CommunicationDeterminismChecker.cpp
   src/mc/checker/CommunicationDeterminismChecker.hpp
+  src/mc/checker/Coordinator.cpp
+  src/mc/checker/Coordinator.hpp
   src/mc/checker/SafetyChecker.cpp
   src/mc/checker/SafetyChecker.hpp
   src/mc/checker/SimcallInspector.hpp
@@ -1047,6 +1058,7 @@ set(CMAKEFILES_TXT
 
   tools/CMakeLists.txt
   tools/graphicator/CMakeLists.txt
+  tools/sg_trace2paje/CMakeLists.txt
   tools/tesh/CMakeLists.txt
   )
 
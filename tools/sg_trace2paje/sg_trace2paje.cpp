@@ -0,0 +1,197 @@
+/* Copyright (c) 2019. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Expands a trace written with --cfg=tracing/smpi/format:Binary into the Paje trace that the simulation would have
+ * written with the default format (see src/instr/instr_binary_trace.hpp for the description of the binary format). */
+
+#include "src/instr/instr_binary_trace.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace binary = simgrid::instr::binary;
+
+/** Reads the binary trace by chunks, so that the whole trace never has to fit in memory */
+class BinaryTraceReader {
+  static constexpr size_t CHUNK_SIZE = 1 << 20;
+  FILE* in_;
+  std::vector<char> chunk_;
+  size_t chunk_pos_ = 0;
+  size_t chunk_end_ = 0;
+  uint64_t chunk_offset_ = 0; // Offset of the chunk in the trace
+  int precision_ = 6;
+  int64_t last_time_ticks_ = 0;
+  std::vector<std::string> strings_;
+
+  [[noreturn]] void fail(const std::string& msg)
+  {
+    std::cerr << "Invalid binary trace (at byte " << chunk_offset_ + chunk_pos_ << "): " << msg << std::endl;
+    exit(1);
+  }
+
+  /* Reads the next chunk of the trace if the current one is exhausted. Returns false at the end of the trace */
+  bool fill()
+  {
+    if (chunk_pos_ < chunk_end_)
+      return true;
+    chunk_offset_ += chunk_end_;
+    chunk_pos_ = 0;
+    chunk_end_ = fread(chunk_.data(), 1, chunk_.size(), in_);
+    if (chunk_end_ == 0 && ferror(in_))
+      fail(strerror(errno));
+    return chunk_end_ > 0;
+  }
+
+  uint64_t get_varint()
+  {
+    uint64_t value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+      if (not fill())
+        fail("truncated number");
+      unsigned char byte = chunk_[chunk_pos_++];
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0)
+        return value;
+    }
+    fail("number too large");
+  }
+
+  /* Appends the given amount of bytes of the trace to out */
+  void get_bytes(std::string& out, uint64_t size)
+  {
+    while (size > 0) {
+      if (not fill())
+        fail("truncated string");
+      size_t available = std::min<uint64_t>(size, chunk_end_ - chunk_pos_);
+      out.append(chunk_.data() + chunk_pos_, available);
+      chunk_pos_ += available;
+      size -= available;
+    }
+  }
+
+  /* Prints a number of ticks as "%.*f" would print the corresponding value */
+  void put_ticks(std::string& out, int64_t ticks) const
+  {
+    uint64_t magnitude = ticks < 0 ? -static_cast<uint64_t>(ticks) : ticks;
+    std::string digits = std::to_string(magnitude);
+    if (precision_ > 0) {
+      if (digits.size() <= static_cast<size_t>(precision_))
+        digits.insert(0, precision_ + 1 - digits.size(), '0');
+      digits.insert(digits.size() - precision_, ".");
+    }
+    if (ticks < 0)
+      out.push_back('-');
+    out.append(digits);
+  }
+
+public:
+  explicit BinaryTraceReader(FILE* in) : in_(in), chunk_(CHUNK_SIZE)
+  {
+    std::string magic;
+    while (magic.size() < sizeof(binary::MAGIC) && fill())
+      magic.push_back(chunk_[chunk_pos_++]);
+    if (magic.compare(0, sizeof(binary::MAGIC), binary::MAGIC, sizeof(binary::MAGIC)) != 0)
+      fail("this is not a binary SimGrid trace");
+    uint64_t version = get_varint();
+    if (version != binary::VERSION)
+      fail("unsupported version " + std::to_string(version));
+    precision_ = static_cast<int>(get_varint());
+  }
+
+  /** Appends the Paje text of the next record to out. Returns false at the end of the trace */
+  bool expand_record(std::string& out)
+  {
+    if (not fill())
+      return false;
+
+    switch (get_varint()) {
+      case binary::RECORD_RAW:
+        get_bytes(out, get_varint());
+        break;
+      case binary::RECORD_STRING:
+        strings_.emplace_back();
+        get_bytes(strings_.back(), get_varint());
+        break;
+      case binary::RECORD_LINE: {
+        out.append(std::to_string(get_varint()));
+        uint64_t count = get_varint();
+        for (uint64_t i = 0; i < count; i++) {
+          out.push_back(' ');
+          uint64_t field = get_varint();
+          uint64_t value = field >> binary::FIELD_KIND_BITS;
+          switch (field & ((1U << binary::FIELD_KIND_BITS) - 1)) {
+            case binary::FIELD_STRING:
+              if (value >= strings_.size())
+                fail("undefined string");
+              out.append(strings_[value]);
+              break;
+            case binary::FIELD_TIME:
+              last_time_ticks_ += binary::unzigzag(value);
+              put_ticks(out, last_time_ticks_);
+              break;
+            case binary::FIELD_NUMBER:
+              put_ticks(out, binary::unzigzag(value));
+              break;
+            case binary::FIELD_INTEGER:
+              out.append(std::to_string(binary::unzigzag(value)));
+              break;
+            case binary::FIELD_LITERAL:
+              get_bytes(out, value);
+              break;
+            default:
+              fail("unknown field kind");
+          }
+        }
+        out.push_back('\n');
+        break;
+      }
+      default:
+        fail("unknown record kind");
+    }
+    return true;
+  }
+};
+
+int main(int argc, char** argv)
+{
+  if (argc != 2 && argc != 3) {
+    std::cerr << "Usage: " << argv[0] << " <binary trace> [<paje trace>]" << std::endl
+              << "Expands a trace written with --cfg=tracing/smpi/format:Binary into the Paje format (to stdout if no "
+                 "output file is given)."
+              << std::endl;
+    return 1;
+  }
+
+  FILE* in = fopen(argv[1], "rb");
+  if (in == nullptr) {
+    std::cerr << "Cannot open " << argv[1] << ": " << strerror(errno) << std::endl;
+    return 1;
+  }
+  BinaryTraceReader reader(in);
+
+  FILE* out = argc == 3 ? fopen(argv[2], "w") : stdout;
+  if (out == nullptr) {
+    std::cerr << "Cannot open " << argv[2] << ": " << strerror(errno) << std::endl;
+    return 1;
+  }
+  std::string text;
+  while (reader.expand_record(text)) {
+    if (text.size() >= (1 << 20)) {
+      fwrite(text.data(), 1, text.size(), out);
+      text.clear();
+    }
+  }
+  fwrite(text.data(), 1, text.size(), out);
+  if (out != stdout)
+    fclose(out);
+  fclose(in);
+  return 0;
+}